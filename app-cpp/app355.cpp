@@ -3,6 +3,1870 @@
 
 // Anonymous namespace should only exist in .cpp
 namespace /*anonymous*/ {
+//----------------------------------------
+#pragma region Timer
+
+class Timer
+{
+public:
+    Timer() = default;
+    void Start();
+    double Stop();
+
+private:
+    std::chrono::time_point<std::chrono::high_resolution_clock> mStart{};
+    std::chrono::time_point<std::chrono::high_resolution_clock> mEnd{};
+    std::chrono::duration<double, std::milli> mElapsedMs{};
+};
+
+void Timer::Start()
+{
+    mStart = std::chrono::high_resolution_clock::now();
+}
+
+double Timer::Stop()
+{
+    mEnd = std::chrono::high_resolution_clock::now();
+    mElapsedMs = mEnd - mStart;
+    return mElapsedMs.count();
+}
+#pragma endregion {}
+
+//----------------------------------------
+#pragma region ThreadPool
+
+// Assumed cache line size; std::hardware_destructive_interference_size is missing from some standard libraries
+constexpr std::size_t kCacheLineSize = 64;
+
+template <class Signature>
+class FunctionRef;
+
+/// @brief A callable passed down by reference, as a std::function that never copies or allocates. It only refers to
+/// the callable, which must outlive it; pass a lambda straight to the call that takes the FunctionRef.
+template <class Result, class... Args>
+class FunctionRef<Result(Args...)>
+{
+public:
+    template <class Callable, class = std::enable_if_t<!std::is_same_v<std::decay_t<Callable>, FunctionRef>>>
+    FunctionRef(const Callable& inCallable) :
+        mCallable{&inCallable},
+        mInvoke{[](const void* inTarget, Args... inArgs) -> Result
+        {
+            return (*static_cast<const Callable*>(inTarget))(std::forward<Args>(inArgs)...);
+        }}
+    {
+        // Do nothing
+    }
+
+    Result operator()(Args... inArgs) const
+    {
+        return mInvoke(mCallable, std::forward<Args>(inArgs)...);
+    }
+
+private:
+    const void* mCallable{nullptr};
+    Result (*mInvoke)(const void*, Args...){nullptr};
+};
+
+/// @brief Threads started once and reused for every Run(), so a tick does not pay for thread creation
+class ThreadPool
+{
+public:
+    /// @brief Starts inThreadCount - 1 threads; the thread calling Run() is the pool's thread 0
+    explicit ThreadPool(std::size_t inThreadCount);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    std::size_t GetThreadCount() const
+    {
+        return mThreads.size() + 1;
+    }
+
+    /// @brief Calls inTask(thread) once on each thread of the pool and returns when all calls have returned.
+    /// Rethrows the first exception a call threw.
+    void Run(FunctionRef<void(std::size_t)> inTask);
+
+private:
+    void WorkerLoop(std::size_t inThread);
+    void RunTask(std::size_t inThread);
+
+    std::vector<std::thread> mThreads{};
+    std::mutex mMutex{};
+    std::condition_variable mWake{};
+    std::condition_variable mDone{};
+    const FunctionRef<void(std::size_t)>* mTask{nullptr};
+    std::uint64_t mGeneration{0};           // bumped by each Run()
+    std::size_t mPending{0};                // pool threads still in the current task
+    std::exception_ptr mException{};
+    bool mStop{false};
+};
+
+ThreadPool::ThreadPool(std::size_t inThreadCount)
+{
+    const std::size_t threadCount = std::max<std::size_t>(inThreadCount, 1);
+    mThreads.reserve(threadCount - 1);
+    for (std::size_t thread = 1; thread < threadCount; ++thread)
+    {
+        mThreads.emplace_back(&ThreadPool::WorkerLoop, this, thread);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStop = true;
+    }
+    mWake.notify_all();
+    for (std::thread& thread : mThreads)
+    {
+        thread.join();
+    }
+}
+
+void ThreadPool::Run(FunctionRef<void(std::size_t)> inTask)
+{
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mTask = &inTask;
+        mPending = mThreads.size();
+        mException = nullptr;
+        ++mGeneration;
+    }
+    mWake.notify_all();
+
+    RunTask(0);
+
+    std::unique_lock<std::mutex> lock(mMutex);
+    mDone.wait(lock, [this]() -> bool
+    {
+        return mPending == 0;
+    });
+    mTask = nullptr;
+    if (mException)
+    {
+        std::rethrow_exception(mException);
+    }
+}
+
+void ThreadPool::WorkerLoop(std::size_t inThread)
+{
+    std::uint64_t generation = 0;
+    for (;;)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            mWake.wait(lock, [this, generation]() -> bool
+            {
+                return mStop || (mGeneration != generation);
+            });
+            if (mStop)
+            {
+                return;
+            }
+            generation = mGeneration;
+        }
+
+        RunTask(inThread);
+
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            --mPending;
+        }
+        mDone.notify_one();
+    }
+}
+
+void ThreadPool::RunTask(std::size_t inThread)
+{
+    try
+    {
+        (*mTask)(inThread);
+    }
+    catch (...)
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        if (!mException)
+        {
+            mException = std::current_exception();
+        }
+    }
+}
+
+#pragma endregion {}
+
+//----------------------------------------
+#pragma region WorkList
+
+/// @brief Propagation results of every satellite, in catalog (TLE file) order
+struct OrbitArrays
+{
+    std::vector<double> mLatDegs{};
+    std::vector<double> mLonDegs{};
+    std::vector<double> mAltKm{};
+    std::vector<int> mStatus{};
+
+    /// @brief Sizes the arrays for inCount satellites, each with kInvalidTLE status until it is propagated
+    void Reset(std::size_t inCount)
+    {
+        mLatDegs.resize(inCount);
+        mLonDegs.resize(inCount);
+        mAltKm.resize(inCount);
+        mStatus.assign(inCount, kInvalidTLE);
+    }
+};
+
+/// @brief Appends an OrbitalData for each satellite in [inBegin, inEnd) of inOrbits that propagated, in catalog order.
+/// Keeping catalog order makes the order of equal mean motions after sorting, and so the trains, independent of
+/// how the propagation was scheduled.
+void AppendOrbitalData(const OrbitArrays& inOrbits, const std::vector<sat355::TLE>& inTLEs, std::size_t inBegin, std::size_t inEnd, std::vector<app355::OrbitalData>& ioOrbitalVector)
+{
+    for (std::size_t i = inBegin; i < inEnd; ++i)
+    {
+        if (inOrbits.mStatus[i] == kOK)
+        {
+            ioOrbitalVector.emplace_back(inTLEs[i], inOrbits.mLatDegs[i], inOrbits.mLonDegs[i], inOrbits.mAltKm[i]);
+        }
+    }
+}
+
+/// @brief Days from the TLE's epoch to inTime, in seconds since 1970
+double TleAgeDays(const sat355::TLE& inTLE, long long inTime)
+{
+    constexpr double kSecPerDay = 86400.0;
+    return (static_cast<double>(inTime) - inTLE.GetEpoch()) / kSecPerDay;
+}
+
+/// @brief Rough cost in ns of propagating one satellite to Lat/Lon/Alt.
+/// Resonant SDP4 integrates from the TLE epoch on every call, so its cost grows with the TLE's age.
+double EstimateCostNs(OrbitModel inModel, double inAgeDays)
+{
+    switch (inModel)
+    {
+    case kOrbitModelSgp4Simple:
+        return 400.0;
+    case kOrbitModelSgp4:
+        return 650.0;
+    case kOrbitModelSdp4:
+        return 1500.0;
+    case kOrbitModelSdp4Resonant:
+        return 7500.0 + 270.0 * std::abs(inAgeDays);
+    }
+    return 650.0;
+}
+
+/// @brief Satellites that share one propagation model, and a Catalog of just those.
+/// The Catalog's batches are per model too, so a list runs through one specialized loop.
+class WorkList
+{
+public:
+    WorkList(OrbitModel inModel, std::vector<std::size_t> inIndex, const std::vector<sat355::TLE>& inCatalogTLEs, double inCostNs);
+
+    OrbitModel GetModel() const
+    {
+        return mModel;
+    }
+
+    std::size_t GetCount() const
+    {
+        return mIndex.size();
+    }
+
+    /// @brief Cost of propagating the whole list, in ns.
+    /// This is the estimate from the model until the list has been propagated, then the time it took, averaged over ticks.
+    double GetCostNs() const
+    {
+        return mCostNs;
+    }
+
+    /// @brief Propagates the list to inTime, in seconds since 1970 with any fraction, and scatters the results to
+    /// their catalog indices in ioOrbits
+    void Propagate(double inTime, OrbitArrays& ioOrbits);
+
+    /// @brief Propagates each satellite of the list to every time in ioMatrix.mTimes and scatters its row to its catalog index
+    void PropagateTimes(app355::SatOrbit::OrbitalMatrix& ioMatrix);
+
+private:
+    static sat355::Catalog MakeCatalog(const std::vector<std::size_t>& inIndex, const std::vector<sat355::TLE>& inCatalogTLEs);
+
+    OrbitModel mModel{kOrbitModelSgp4};
+    std::vector<std::size_t> mIndex{};     // catalog index of each satellite in the list
+    sat355::Catalog mCatalog;
+    double mCostNs{0.0};
+    bool mMeasured{false};
+    OrbitArrays mResults{};                 // in list order
+};
+
+WorkList::WorkList(OrbitModel inModel, std::vector<std::size_t> inIndex, const std::vector<sat355::TLE>& inCatalogTLEs, double inCostNs) :
+    mModel{inModel},
+    mIndex{std::move(inIndex)},
+    mCatalog{MakeCatalog(mIndex, inCatalogTLEs)},
+    mCostNs{inCostNs}
+{
+    // Do nothing
+}
+
+/*static*/ sat355::Catalog WorkList::MakeCatalog(const std::vector<std::size_t>& inIndex, const std::vector<sat355::TLE>& inCatalogTLEs)
+{
+    std::vector<sat355::TLE> tles{};
+    tles.reserve(inIndex.size());
+    for (const std::size_t index : inIndex)
+    {
+        tles.push_back(inCatalogTLEs[index]);
+    }
+    return sat355::Catalog{tles};
+}
+
+void WorkList::Propagate(double inTime, OrbitArrays& ioOrbits)
+{
+    Timer timer{};
+    timer.Start();
+
+    mCatalog.ToLLAD(inTime, kPropagatePositionOnly, mResults.mLatDegs, mResults.mLonDegs, mResults.mAltKm, mResults.mStatus);
+
+    // Scatter back to catalog order
+    for (std::size_t n = 0; n < mIndex.size(); ++n)
+    {
+        const std::size_t index = mIndex[n];
+        ioOrbits.mLatDegs[index] = mResults.mLatDegs[n];
+        ioOrbits.mLonDegs[index] = mResults.mLonDegs[n];
+        ioOrbits.mAltKm[index] = mResults.mAltKm[n];
+        ioOrbits.mStatus[index] = mResults.mStatus[n];
+    }
+
+    // The first measurement replaces the estimate; later ones are averaged in so one slow tick does not reorder everything
+    const double elapsedNs = timer.Stop() * 1.0e6;
+    mCostNs = mMeasured ? 0.5 * (mCostNs + elapsedNs) : elapsedNs;
+    mMeasured = true;
+}
+
+void WorkList::PropagateTimes(app355::SatOrbit::OrbitalMatrix& ioMatrix)
+{
+    mCatalog.ToLLA(ioMatrix.mTimes, kPropagatePositionOnly, mResults.mLatDegs, mResults.mLonDegs, mResults.mAltKm, mResults.mStatus);
+
+    // Rows are contiguous in both, so each satellite's row is copied whole
+    const std::size_t timeCount = ioMatrix.mTimes.size();
+    for (std::size_t n = 0; n < mIndex.size(); ++n)
+    {
+        const std::size_t from = n * timeCount;
+        const std::size_t to = mIndex[n] * timeCount;
+        std::copy_n(&mResults.mLatDegs[from], timeCount, &ioMatrix.mLatDegs[to]);
+        std::copy_n(&mResults.mLonDegs[from], timeCount, &ioMatrix.mLonDegs[to]);
+        std::copy_n(&mResults.mAltKm[from], timeCount, &ioMatrix.mAltKm[to]);
+        std::copy_n(&mResults.mStatus[from], timeCount, &ioMatrix.mStatus[to]);
+    }
+}
+
+/// @brief Partitions a catalog into WorkLists of one propagation model each, most expensive list first.
+/// A model's satellites are split into lists of about 1/inChunkCount of the catalog's estimated cost, so
+/// the lists can be handed out to threads; with inChunkCount 1 each model gets one list.
+/// TLEs the library cannot decode are left out of every list.
+std::vector<WorkList> MakeWorkLists(const std::vector<sat355::TLE>& inTLEs, long long inTime, std::size_t inChunkCount)
+{
+    constexpr std::size_t kModelCount = kOrbitModelSdp4Resonant + 1;
+    std::vector<std::size_t> indices[kModelCount]{};
+    std::vector<double> costNs(inTLEs.size(), 0.0);
+    double totalCostNs = 0.0;
+    for (std::size_t i = 0; i < inTLEs.size(); ++i)
+    {
+        try
+        {
+            const OrbitModel model = inTLEs[i].GetModel();
+            indices[model].push_back(i);
+            costNs[i] = EstimateCostNs(model, TleAgeDays(inTLEs[i], inTime));
+            totalCostNs += costNs[i];
+        }
+        catch (const sat355::exception&)
+        {
+            // Not a usable TLE, e.g. the blank record after the last one in the file
+        }
+    }
+
+    const double chunkCostNs = totalCostNs / static_cast<double>(std::max<std::size_t>(inChunkCount, 1));
+
+    std::vector<WorkList> workLists{};
+    for (std::size_t model = 0; model < kModelCount; ++model)
+    {
+        std::vector<std::size_t> chunk{};
+        double chunkCost = 0.0;
+        for (const std::size_t index : indices[model])
+        {
+            chunk.push_back(index);
+            chunkCost += costNs[index];
+            if (chunkCost >= chunkCostNs)
+            {
+                workLists.emplace_back(static_cast<OrbitModel>(model), std::move(chunk), inTLEs, chunkCost);
+                chunk.clear();
+                chunkCost = 0.0;
+            }
+        }
+        if (!chunk.empty())
+        {
+            workLists.emplace_back(static_cast<OrbitModel>(model), std::move(chunk), inTLEs, chunkCost);
+        }
+    }
+
+    std::sort(workLists.begin(), workLists.end(), [](const WorkList& inLHS, const WorkList& inRHS) -> bool
+    {
+        return inLHS.GetCostNs() > inRHS.GetCostNs();
+    });
+    return workLists;
+}
+
+#pragma endregion {}
+
+//----------------------------------------
+#pragma region KeySort
+
+/// @brief Sort key of one record, and the record's index before sorting
+struct SortKey
+{
+    double mKey{0.0};
+    std::uint32_t mIndex{0};
+};
+
+/// @brief Orders the keys by key, then by index so equal keys keep their input order
+void SortKeys(std::vector<SortKey>& ioKeys)
+{
+    std::sort(ioKeys.begin(), ioKeys.end(), [](const SortKey& inLHS, const SortKey& inRHS) -> bool
+    {
+        return (inLHS.mKey < inRHS.mKey) || ((inLHS.mKey == inRHS.mKey) && (inLHS.mIndex < inRHS.mIndex));
+    });
+}
+
+/// @brief Maps a double to an unsigned integer that sorts in the same order: negative numbers have all
+/// their bits flipped, others only the sign bit
+std::uint64_t RadixBits(double inKey)
+{
+    std::uint64_t bits = 0;
+    std::memcpy(&bits, &inKey, sizeof(bits));
+    constexpr std::uint64_t kSignBit = std::uint64_t{1} << 63;
+    return ((bits & kSignBit) != 0) ? ~bits : (bits | kSignBit);
+}
+
+/// @brief Same order as SortKeys(), by an LSD radix sort over the key's bits, a byte per pass.
+/// A pass where every key has the same byte is skipped; the mean motions of a catalog share their
+/// exponent and leading mantissa bits, so the top passes usually are.
+void RadixSortKeys(std::vector<SortKey>& ioKeys, std::vector<SortKey>& ioScratch)
+{
+    constexpr int kPasses = 8;
+    constexpr std::size_t kBuckets = 256;
+
+    std::vector<std::uint64_t> bits(ioKeys.size());
+    std::transform(ioKeys.begin(), ioKeys.end(), bits.begin(), [](const SortKey& inKey) -> std::uint64_t
+    {
+        return RadixBits(inKey.mKey);
+    });
+
+    // Counts of every pass in one read of the keys
+    std::vector<std::array<std::size_t, kBuckets>> counts(kPasses);
+    for (const std::uint64_t keyBits : bits)
+    {
+        for (int pass = 0; pass < kPasses; ++pass)
+        {
+            ++counts[pass][(keyBits >> (8 * pass)) & 0xFF];
+        }
+    }
+
+    // The bits travel with their keys, in a second pair of buffers
+    std::vector<std::uint64_t> bitsScratch(bits.size());
+    ioScratch.resize(ioKeys.size());
+    for (int pass = 0; pass < kPasses; ++pass)
+    {
+        std::array<std::size_t, kBuckets>& count = counts[pass];
+        if (std::find(count.begin(), count.end(), ioKeys.size()) != count.end())
+        {
+            continue;
+        }
+
+        std::size_t offset = 0;
+        for (std::size_t& bucket : count)
+        {
+            const std::size_t bucketCount = bucket;
+            bucket = offset;
+            offset += bucketCount;
+        }
+
+        for (std::size_t n = 0; n < ioKeys.size(); ++n)
+        {
+            const std::size_t to = count[(bits[n] >> (8 * pass)) & 0xFF]++;
+            ioScratch[to] = ioKeys[n];
+            bitsScratch[to] = bits[n];
+        }
+        ioKeys.swap(ioScratch);
+        bits.swap(bitsScratch);
+    }
+}
+
+/// @brief Sorts ioOrbitalVector by mean motion through (key, index) pairs, sorted with RadixSortKeys() if inRadix
+/// is set and SortKeys() otherwise. Equal mean motions keep their input order.
+void SortOrbitalByKey(std::vector<app355::OrbitalData>& ioOrbitalVector, bool inRadix, std::vector<SortKey>& ioKeys, std::vector<SortKey>& ioScratch)
+{
+    assert(ioOrbitalVector.size() <= std::numeric_limits<std::uint32_t>::max());
+
+    // Each key is read once, and the sort moves 16 byte pairs instead of OrbitalData
+    ioKeys.resize(ioOrbitalVector.size());
+    for (std::size_t i = 0; i < ioOrbitalVector.size(); ++i)
+    {
+        ioKeys[i] = SortKey{ioOrbitalVector[i].GetMeanMotion(), static_cast<std::uint32_t>(i)};
+    }
+
+    if (inRadix)
+    {
+        RadixSortKeys(ioKeys, ioScratch);
+    }
+    else
+    {
+        SortKeys(ioKeys);
+    }
+
+    // One move per record into sorted order
+    std::vector<app355::OrbitalData> sorted{};
+    sorted.reserve(ioOrbitalVector.size());
+    for (const SortKey& key : ioKeys)
+    {
+        sorted.push_back(std::move(ioOrbitalVector[key.mIndex]));
+    }
+    ioOrbitalVector.swap(sorted);
+}
+
+#pragma endregion {}
+
+//----------------------------------------
+#pragma region Trains
+
+/// @brief Splits inOrbitalVector, sorted by mean motion, into runs of satellites whose mean motion and inclination
+/// each differ from the previous satellite's by at most 0.0001, sorts each run by longitude and drops the
+/// wandering satellites: runs of 3 or fewer, or 2 or fewer for the last run, which is left in mean motion order
+app355::TrainTable FindTrainRuns(const std::vector<app355::OrbitalData>& inOrbitalVector)
+{
+    assert(inOrbitalVector.size() < std::numeric_limits<std::uint32_t>::max());
+    app355::TrainTable trainTable{};
+    trainTable.Reserve(inOrbitalVector.size(), inOrbitalVector.size() / 4);
+    std::vector<std::uint32_t> newTrain{};
+
+    double prevMeanMotion = 0;
+    double prevInclination = 0;
+
+    for (std::uint32_t position = 0; position < static_cast<std::uint32_t>(inOrbitalVector.size()); ++position)
+    {
+        const app355::OrbitalData& data = inOrbitalVector[position];
+        const double inclination = data.GetTLE().GetInclination();
+        double deltaMotion = std::abs(data.GetMeanMotion() - prevMeanMotion);
+        double deltaInclination = std::abs(inclination - prevInclination);
+        if ((deltaMotion > 0.0001 || deltaInclination > 0.0001) && !newTrain.empty())
+        {
+            // Sort by longitude
+            std::sort(newTrain.begin(), newTrain.end(), [&inOrbitalVector](std::uint32_t inLHS, std::uint32_t inRHS) -> bool
+            {
+                return inOrbitalVector[inLHS].GetLongitude() < inOrbitalVector[inRHS].GetLongitude();
+            });
+
+            // Filter out wandering satellites
+            if (newTrain.size() > 3)
+            {
+                for (const std::uint32_t member : newTrain)
+                {
+                    trainTable.AddMember(member);
+                }
+                trainTable.EndTrain();
+            }
+
+            newTrain.clear();
+        }
+        prevMeanMotion = data.GetMeanMotion();
+        prevInclination = inclination;
+
+        newTrain.push_back(position);
+    }
+    if (!newTrain.empty() && newTrain.size() > 2)
+    {
+        for (const std::uint32_t member : newTrain)
+        {
+            trainTable.AddMember(member);
+        }
+        trainTable.EndTrain();
+    }
+    return trainTable;
+}
+
+/// @brief Merges trains whose first satellites' mean motions are within 0.001 of each other, pairwise.
+/// Each train not yet merged takes every later one within 0.001 of its own first satellite, in order; this is
+/// not transitive, a train can be within 0.001 of one that was merged without being merged itself.
+/// O(T^2) in the number of trains; kept as the reference for MergeTrains().
+app355::TrainTable MergeTrainsPairwise(const app355::TrainTable& inTrainTable, const std::vector<app355::OrbitalData>& inOrbitalVector)
+{
+    std::vector<std::vector<std::uint32_t>> trainVector{};
+    for (std::size_t train = 0; train < inTrainTable.GetTrainCount(); ++train)
+    {
+        const app355::TrainTable::Members members{inTrainTable.GetTrain(train)};
+        trainVector.emplace_back(members.begin(), members.end());
+    }
+
+    for (std::size_t i = 0; i < trainVector.size(); ++i)
+    {
+        for (std::size_t j = i + 1; j < trainVector.size(); ++j)
+        {
+            double deltaMotion = std::abs(inOrbitalVector[trainVector[i][0]].GetMeanMotion() - inOrbitalVector[trainVector[j][0]].GetMeanMotion());
+            if (deltaMotion < 0.001)
+            {
+                trainVector[i].insert(trainVector[i].end(), trainVector[j].begin(), trainVector[j].end());
+                assert(static_cast<std::ptrdiff_t>(j) >= 0);
+                trainVector.erase(trainVector.begin() + static_cast<std::ptrdiff_t>(j));
+                --j;
+            }
+        }
+    }
+
+    app355::TrainTable merged{};
+    for (const std::vector<std::uint32_t>& train : trainVector)
+    {
+        for (const std::uint32_t member : train)
+        {
+            merged.AddMember(member);
+        }
+        merged.EndTrain();
+    }
+    return merged;
+}
+
+/// @brief Same trains, in the same order, as MergeTrainsPairwise(), in O(T log T).
+/// The trains' first mean motions are sorted once. Each train not yet merged then takes the ones within 0.001
+/// of it as one range of that order, found by binary search. A union-find over the sorted positions, each
+/// merged position joined to the one after it, skips the trains already taken, so each train is taken once.
+/// The merged table is laid out with a counting sort by head, so only positions are copied, each once.
+app355::TrainTable MergeTrains(const app355::TrainTable& inTrainTable, const std::vector<app355::OrbitalData>& inOrbitalVector)
+{
+    constexpr double kMergeMeanMotion = 0.001;
+    constexpr std::uint32_t kNone = std::numeric_limits<std::uint32_t>::max();
+    assert(inTrainTable.GetTrainCount() < kNone);
+    const auto count = static_cast<std::uint32_t>(inTrainTable.GetTrainCount());
+
+    std::vector<SortKey> keys(count);
+    for (std::uint32_t train = 0; train < count; ++train)
+    {
+        keys[train] = SortKey{inOrbitalVector[inTrainTable.GetTrain(train)[0]].GetMeanMotion(), train};
+    }
+    SortKeys(keys);
+    std::vector<std::uint32_t> position(count);
+    for (std::uint32_t n = 0; n < count; ++n)
+    {
+        position[keys[n].mIndex] = n;
+    }
+
+    // next[n] leads to the first position at or after n not yet merged; position count is a sentinel
+    std::vector<std::uint32_t> next(count + 1);
+    std::iota(next.begin(), next.end(), std::uint32_t{0});
+    auto find = [&next](std::uint32_t inPosition) -> std::uint32_t
+    {
+        while (next[inPosition] != inPosition)
+        {
+            next[inPosition] = next[next[inPosition]];
+            inPosition = next[inPosition];
+        }
+        return inPosition;
+    };
+
+    // The train each one is merged into. Every train before the current one is already taken, so the
+    // untaken ones in its range all come after it, as in the pairwise loop.
+    std::vector<std::uint32_t> head(count, kNone);
+    for (std::uint32_t train = 0; train < count; ++train)
+    {
+        if (head[train] != kNone)
+        {
+            continue;
+        }
+        head[train] = train;
+        next[position[train]] = position[train] + 1;
+
+        // |key - mean motion| < 0.001 holds on one contiguous range of the sorted keys
+        const double meanMotion = keys[position[train]].mKey;
+        const auto begin = std::partition_point(keys.begin(), keys.end(), [meanMotion](const SortKey& inKey) -> bool
+        {
+            return inKey.mKey - meanMotion <= -kMergeMeanMotion;
+        });
+        const auto end = std::partition_point(begin, keys.end(), [meanMotion](const SortKey& inKey) -> bool
+        {
+            return inKey.mKey - meanMotion < kMergeMeanMotion;
+        });
+        const auto last = static_cast<std::uint32_t>(end - keys.begin());
+        for (std::uint32_t n = find(static_cast<std::uint32_t>(begin - keys.begin())); n < last; n = find(n + 1))
+        {
+            head[keys[n].mIndex] = train;
+            next[n] = n + 1;
+        }
+    }
+
+    // Heads in train order, each followed by the trains it took in train order. The merged trains are numbered
+    // in head order; position is reused for each train's merged number.
+    std::uint32_t mergedCount = 0;
+    for (std::uint32_t train = 0; train < count; ++train)
+    {
+        position[train] = (head[train] == train) ? mergedCount++ : position[head[train]];
+    }
+    std::vector<std::size_t> offsets(mergedCount + 1, 0);
+    for (std::uint32_t train = 0; train < count; ++train)
+    {
+        offsets[position[train] + 1] += inTrainTable.GetTrain(train).size();
+    }
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+    std::vector<std::uint32_t> members(inTrainTable.GetMemberCount());
+    std::vector<std::size_t> cursor(offsets.begin(), offsets.end() - 1);
+    for (std::uint32_t train = 0; train < count; ++train)
+    {
+        const app355::TrainTable::Members from{inTrainTable.GetTrain(train)};
+        std::copy(from.begin(), from.end(), members.begin() + static_cast<std::ptrdiff_t>(cursor[position[train]]));
+        cursor[position[train]] += from.size();
+    }
+    return app355::TrainTable{std::move(members), std::move(offsets)};
+}
+
+/// @brief Where a satellite's orbital plane is, and where it is along it, at one time
+struct PlaneKey
+{
+    double mInclination{0.0};   // degs
+    double mRaan{0.0};          // degs, 0..360
+    double mMeanMotion{0.0};    // revs per day
+    double mArgLat{0.0};        // degs, 0..360
+};
+
+// Satellites within all three of these of each other are in one plane; the hashed grid's cells are the same size
+constexpr double kPlaneInclination = 0.1;
+constexpr double kPlaneRaan = 1.0;
+constexpr double kPlaneMeanMotion = 0.01;
+// A train ends where the next satellite along the plane is further than this
+constexpr double kTrainGapArgLat = 2.0;
+
+/// @brief Angle between two directions in degs, 0..180
+double AngleBetween(double inLHS, double inRHS)
+{
+    const double delta = std::abs(inLHS - inRHS);
+    return std::min(delta, 360.0 - delta);
+}
+
+/// @brief Whether two satellites are close enough to be in one plane
+bool SamePlane(const PlaneKey& inLHS, const PlaneKey& inRHS)
+{
+    return (std::abs(inLHS.mInclination - inRHS.mInclination) <= kPlaneInclination) &&
+           (AngleBetween(inLHS.mRaan, inRHS.mRaan) <= kPlaneRaan) &&
+           (std::abs(inLHS.mMeanMotion - inRHS.mMeanMotion) <= kPlaneMeanMotion);
+}
+
+/// @brief Cell of the plane grid a key falls in
+struct PlaneCell
+{
+    std::int64_t mInclination;
+    std::int64_t mRaan;
+    std::int64_t mMeanMotion;
+};
+
+PlaneCell CellOf(const PlaneKey& inKey)
+{
+    return PlaneCell{static_cast<std::int64_t>(inKey.mInclination / kPlaneInclination), static_cast<std::int64_t>(inKey.mRaan / kPlaneRaan),
+                     static_cast<std::int64_t>(inKey.mMeanMotion / kPlaneMeanMotion)};
+}
+
+/// @brief Hash of the cell inCell is offset by, -1..1 in each direction; the RAAN wraps at 360 degs
+std::uint64_t CellHash(const PlaneCell& inCell, std::int64_t inInclination = 0, std::int64_t inRaan = 0, std::int64_t inMeanMotion = 0)
+{
+    constexpr auto kRaanCells = static_cast<std::int64_t>(360.0 / kPlaneRaan);
+    const std::int64_t raan = (((inCell.mRaan + inRaan) % kRaanCells) + kRaanCells) % kRaanCells;
+    return (static_cast<std::uint64_t>(inCell.mInclination + inInclination) << 40) | (static_cast<std::uint64_t>(raan) << 20) |
+           static_cast<std::uint64_t>(inCell.mMeanMotion + inMeanMotion);
+}
+
+/// @brief Calls inVisitCell(hash) for the cell of inKey and each of its 26 neighbours
+template <class VisitCell>
+void VisitNeighbours(const PlaneKey& inKey, const VisitCell& inVisitCell)
+{
+    const PlaneCell cell{CellOf(inKey)};
+    for (std::int64_t dInclination = -1; dInclination <= 1; ++dInclination)
+    {
+        for (std::int64_t dRaan = -1; dRaan <= 1; ++dRaan)
+        {
+            for (std::int64_t dMeanMotion = -1; dMeanMotion <= 1; ++dMeanMotion)
+            {
+                inVisitCell(CellHash(cell, dInclination, dRaan, dMeanMotion));
+            }
+        }
+    }
+}
+
+/// @brief Groups satellites into orbital planes: the connected groups of satellites within kPlaneInclination,
+/// kPlaneRaan and kPlaneMeanMotion of another one in the group. Satellites are sorted by the cell of a grid of
+/// those sizes they fall in, so each is only compared with the satellites in its own and the 26 neighbouring cells,
+/// found by binary search, and joined with a union-find. Returns one span of inKeys indices per plane, planes in
+/// order of their first satellite and satellites in inKeys order.
+app355::TrainTable FindPlanes(const std::vector<PlaneKey>& inKeys)
+{
+    assert(inKeys.size() < std::numeric_limits<std::uint32_t>::max());
+    const auto count = static_cast<std::uint32_t>(inKeys.size());
+
+    std::vector<std::pair<std::uint64_t, std::uint32_t>> grid(count);
+    for (std::uint32_t n = 0; n < count; ++n)
+    {
+        grid[n] = std::make_pair(CellHash(CellOf(inKeys[n])), n);
+    }
+    std::sort(grid.begin(), grid.end());
+
+    std::vector<std::uint32_t> parent(count);
+    std::iota(parent.begin(), parent.end(), std::uint32_t{0});
+    auto find = [&parent](std::uint32_t inSatellite) -> std::uint32_t
+    {
+        while (parent[inSatellite] != inSatellite)
+        {
+            parent[inSatellite] = parent[parent[inSatellite]];
+            inSatellite = parent[inSatellite];
+        }
+        return inSatellite;
+    };
+
+    // The neighbouring cells are searched for once per occupied cell, for all of its satellites
+    for (auto first = grid.begin(); first != grid.end();)
+    {
+        const auto last = std::find_if(first, grid.end(), [first](const auto& inEntry) -> bool
+        {
+            return inEntry.first != first->first;
+        });
+        VisitNeighbours(inKeys[first->second], [&inKeys, &grid, &find, &parent, first, last](std::uint64_t inCell)
+        {
+            auto other = std::lower_bound(grid.begin(), grid.end(), std::make_pair(inCell, std::uint32_t{0}));
+            for (; (other != grid.end()) && (other->first == inCell); ++other)
+            {
+                for (auto satellite = first; satellite != last; ++satellite)
+                {
+                    if ((other->second > satellite->second) && SamePlane(inKeys[satellite->second], inKeys[other->second]))
+                    {
+                        parent[find(other->second)] = find(satellite->second);
+                    }
+                }
+            }
+        });
+        first = last;
+    }
+
+    // Planes numbered in order of their first satellite, then laid out with a counting sort. Every satellite
+    // points straight at its root first, so the root is a plain lookup from then on.
+    constexpr std::uint32_t kNone = std::numeric_limits<std::uint32_t>::max();
+    std::vector<std::uint32_t> planeOfRoot(count, kNone);
+    std::uint32_t planeCount = 0;
+    for (std::uint32_t n = 0; n < count; ++n)
+    {
+        parent[n] = find(n);
+        std::uint32_t& plane = planeOfRoot[parent[n]];
+        if (plane == kNone)
+        {
+            plane = planeCount++;
+        }
+    }
+    std::vector<std::size_t> offsets(planeCount + 1, 0);
+    for (std::uint32_t n = 0; n < count; ++n)
+    {
+        ++offsets[planeOfRoot[parent[n]] + 1];
+    }
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+    std::vector<std::uint32_t> members(count);
+    std::vector<std::size_t> cursor(offsets.begin(), offsets.end() - 1);
+    for (std::uint32_t n = 0; n < count; ++n)
+    {
+        members[cursor[planeOfRoot[parent[n]]]++] = n;
+    }
+    return app355::TrainTable{std::move(members), std::move(offsets)};
+}
+
+/// @brief Orders one plane, [ioBegin, ioEnd), in place by argument of latitude, inArgLat(satellite) in degs 0..360,
+/// and splits it into trains, cut wherever the next satellite is more than kTrainGapArgLat further on. The order
+/// wraps at 360 degs and is rotated to start after a gap, so a train can cross the seam and is still one range; a
+/// plane with no gap is one train. Runs of 3 or fewer are not trains, as wandering satellites. Calls
+/// inTrain(begin, end) with the [begin, end) offsets of each train from ioBegin.
+template <class ArgLat, class OnTrain>
+void OrderPlane(std::uint32_t* ioBegin, std::uint32_t* ioEnd, const ArgLat& inArgLat, const OnTrain& inTrain)
+{
+    const auto count = static_cast<std::size_t>(ioEnd - ioBegin);
+    if (count == 0)
+    {
+        return;
+    }
+    std::sort(ioBegin, ioEnd, [&inArgLat](std::uint32_t inLHS, std::uint32_t inRHS) -> bool
+    {
+        return std::make_pair(inArgLat(inLHS), inLHS) < std::make_pair(inArgLat(inRHS), inRHS);
+    });
+    auto gapAfter = [ioBegin, count, &inArgLat](std::size_t inPosition) -> double
+    {
+        const std::size_t next = (inPosition + 1) % count;
+        const double gap = inArgLat(ioBegin[next]) - inArgLat(ioBegin[inPosition]);
+        return (next == 0) ? gap + 360.0 : gap;
+    };
+
+    // Start after a gap, the one at the 360 deg seam if it is one
+    for (std::size_t position = count; position-- > 0;)
+    {
+        if (gapAfter(position) > kTrainGapArgLat)
+        {
+            std::rotate(ioBegin, ioBegin + (position + 1) % count, ioEnd);
+            break;
+        }
+    }
+
+    std::size_t begin = 0;
+    for (std::size_t n = 0; n < count; ++n)
+    {
+        // In the rotated order only a gap across the seam comes out negative
+        const double gap = (n + 1 < count) ? inArgLat(ioBegin[n + 1]) - inArgLat(ioBegin[n]) : 0.0;
+        if ((n + 1 == count) || (((gap < 0.0) ? gap + 360.0 : gap) > kTrainGapArgLat))
+        {
+            if (n + 1 - begin > 3)
+            {
+                inTrain(begin, n + 1);
+            }
+            begin = n + 1;
+        }
+    }
+}
+
+#pragma endregion {}
+
+//----------------------------------------
+#pragma region TrainTracking
+
+/// @brief Argument of latitude of satellite inIndex of inState, a kFrameECI state with velocities, in degs 0..360.
+/// The node is along z x h, so it is the angle from there to r, about h.
+double PropagatedArgLat(const sat355::Catalog::StateVectors& inState, std::size_t inIndex)
+{
+    const double x = inState.mXKm[inIndex];
+    const double y = inState.mYKm[inIndex];
+    const double z = inState.mZKm[inIndex];
+    const double hx = y * inState.mVzKmSec[inIndex] - z * inState.mVyKmSec[inIndex];
+    const double hy = z * inState.mVxKmSec[inIndex] - x * inState.mVzKmSec[inIndex];
+    const double hz = x * inState.mVyKmSec[inIndex] - y * inState.mVxKmSec[inIndex];
+    const double nodeLength = std::sqrt(hx * hx + hy * hy);
+    const double h = std::sqrt(nodeLength * nodeLength + hz * hz);
+
+    // r along the node, and along h x node, in the plane
+    const double alongNode = (x * -hy + y * hx) / nodeLength;
+    const double alongPlane = z * h / nodeLength;
+    constexpr double kDegsPerRadian = 180.0 / 3.14159265358979323846;
+    const double argLat = std::atan2(alongPlane, alongNode) * kDegsPerRadian;
+    return (argLat < 0.0) ? argLat + 360.0 : argLat;
+}
+
+/// @brief The plane trains of a catalog, kept up to date from one tick to the next with stable train IDs.
+/// Planes are found as FindPlanes() does, at an anchor time. Along its plane each satellite's argument of
+/// latitude, taken from its propagated position there, then grows at the rate it had over the next kRateSpanSec,
+/// so the gap to the next satellite changes linearly and the time it
+/// crosses kTrainGapArgLat, or closes to 0 and the order changes, is known ahead. Each plane is queued at the
+/// first such time among its neighbours, and Advance() only orders again the planes that came due and those with
+/// an updated TLE: between anchors a call costs in proportion to what changed, not to the size of the catalog.
+/// The linear model only holds near its anchor, and planes precess apart or together, so every kAnchorIntervalSec
+/// the keys are taken again and the planes found again; that call costs as much as building the tracker, which is
+/// why the tracking mode runs it on a thread of its own.
+class TrainTracker
+{
+public:
+    /// @brief One change found by Advance()
+    struct Event
+    {
+        enum class Kind
+        {
+            kJoin,      // mSatellite joined train mTrain
+            kLeave,     // mSatellite left train mTrain
+            kSplit,     // train mOther split off from train mTrain
+            kMerge      // train mOther merged into train mTrain and is gone
+        };
+
+        Kind mKind{Kind::kJoin};
+        std::uint32_t mTrain{0};
+        std::uint32_t mOther{0};
+        std::size_t mSatellite{0};  // catalog index, for kJoin and kLeave
+    };
+
+    static constexpr std::uint32_t kNoTrain = std::numeric_limits<std::uint32_t>::max();
+
+    /// @brief Finds the planes and trains of inTLEVector at inTime. Satellites whose elements the library rejects
+    /// are in no plane until UpdateTLE() gives them good ones.
+    TrainTracker(const std::vector<sat355::TLE>& inTLEVector, long long inTime);
+
+    /// @brief Replaces the TLE of catalog index inIndex; it is placed again, in its plane or another, at the next Advance()
+    void UpdateTLE(std::size_t inIndex, const sat355::TLE& inTLE);
+
+    /// @brief Moves the trains to inTime, which is not before the last one, and appends what changed to ioEvents
+    void Advance(double inTime, std::vector<Event>& ioEvents);
+
+    std::size_t GetTrainCount() const
+    {
+        return mTrains.size();
+    }
+
+    /// @brief Planes ordered again since the start, by all Advance() calls
+    std::size_t GetReorderCount() const
+    {
+        return mReorderCount;
+    }
+
+    /// @brief Catalog indices of each train's satellites in along-track order, trains in ID order
+    std::vector<std::vector<std::size_t>> GetTrains() const;
+
+private:
+    static constexpr std::uint32_t kNoPlane = std::numeric_limits<std::uint32_t>::max();
+    static constexpr long long kRateSpanSec = 60;           // the argument of latitude's rate is taken over this
+    static constexpr long long kAnchorIntervalSec = 600;    // the keys and planes are this old at most
+
+    struct Satellite
+    {
+        PlaneKey mKey{};                    // at mAnchorTime
+        double mArgLatRate{0.0};            // degs per second
+        std::uint32_t mPlane{kNoPlane};     // in mGrid exactly when in a plane
+        std::uint32_t mTrain{kNoTrain};
+    };
+
+    struct Plane
+    {
+        std::vector<std::uint32_t> mMembers{};  // in along-track order as of the last Reorder()
+        std::uint64_t mVersion{0};              // queue entries of earlier versions are stale
+        bool mDirty{false};
+    };
+
+    struct Due
+    {
+        double mTime{0.0};
+        std::uint32_t mPlane{0};
+        std::uint64_t mVersion{0};
+
+        bool operator>(const Due& inRHS) const
+        {
+            return mTime > inRHS.mTime;
+        }
+    };
+
+    /// @brief Fills the key and rate of each of inSatellites from its TLE at mAnchorTime, and returns those it could;
+    /// the others the library rejects or cannot propagate
+    std::vector<std::uint32_t> MakeKeys(const std::vector<std::uint32_t>& inSatellites);
+
+    /// @brief Argument of latitude of a satellite at inTime, degs 0..360
+    double ArgLat(std::uint32_t inSatellite, double inTime) const;
+
+    /// @brief A plane with a satellite in one plane with inSatellite, preferring its own, or kNoPlane
+    std::uint32_t FindPlane(std::uint32_t inSatellite) const;
+
+    /// @brief Moves inSatellite out of its plane and train into inPlane, which may be kNoPlane
+    void MoveToPlane(std::uint32_t inSatellite, std::uint32_t inPlane, std::vector<Event>& ioEvents);
+
+    /// @brief Takes every key again at inTime and finds the planes again. Each plane found keeps the index of the
+    /// old plane most of its satellites were in; every plane is left dirty and none queued.
+    void Reanchor(double inTime, std::vector<Event>& ioEvents);
+
+    void MarkDirty(std::uint32_t inPlane);
+
+    /// @brief Orders a plane at inTime, splits it into trains, gives them IDs and reports what changed
+    void Reorder(std::uint32_t inPlane, double inTime, std::vector<Event>& ioEvents);
+
+    /// @brief Queues a plane at the first time after inTime that a gap between neighbours crosses a threshold
+    void Schedule(std::uint32_t inPlane, double inTime);
+
+    long long mAnchorTime{0};
+    double mTime{0.0};
+    std::vector<sat355::TLE> mTLEs{};
+    std::vector<Satellite> mSatellites{};
+    std::vector<Plane> mPlanes{};
+    std::map<std::uint32_t, std::vector<std::uint32_t>> mTrains{};  // members by train ID, in along-track order
+    std::uint32_t mNextTrain{0};
+    std::unordered_map<std::uint64_t, std::vector<std::uint32_t>> mGrid{};
+    std::priority_queue<Due, std::vector<Due>, std::greater<Due>> mQueue{};
+    std::vector<std::uint32_t> mDirtyPlanes{};
+    std::vector<std::pair<std::uint32_t, sat355::TLE>> mUpdates{};
+
+    // Scratch for Reorder(), kept so that ordering a plane allocates nothing once they have grown to the biggest plane
+    std::vector<std::pair<std::size_t, std::size_t>> mTrainSpans{};
+    std::vector<std::size_t> mSpansBySize{};
+    std::vector<std::uint32_t> mKeptTrains{};
+    std::vector<std::uint32_t> mNewTrains{};
+    std::vector<std::pair<std::uint32_t, std::size_t>> mTrainCounts{};
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> mReportedPairs{};
+    std::size_t mReorderCount{0};
+};
+
+TrainTracker::TrainTracker(const std::vector<sat355::TLE>& inTLEVector, long long inTime) :
+    mAnchorTime{inTime},
+    mTime{static_cast<double>(inTime)},
+    mTLEs{inTLEVector},
+    mSatellites(inTLEVector.size())
+{
+    assert(inTLEVector.size() < kNoPlane);
+    std::vector<std::uint32_t> all(inTLEVector.size());
+    std::iota(all.begin(), all.end(), std::uint32_t{0});
+    const std::vector<std::uint32_t> satellites{MakeKeys(all)};
+    std::vector<PlaneKey> keys{};
+    keys.reserve(satellites.size());
+    for (const std::uint32_t satellite : satellites)
+    {
+        keys.push_back(mSatellites[satellite].mKey);
+    }
+
+    // The trains there are at the start are not changes
+    std::vector<Event> initial{};
+    const auto time = static_cast<double>(inTime);
+    const app355::TrainTable planes{FindPlanes(keys)};
+    for (std::size_t span = 0; span < planes.GetTrainCount(); ++span)
+    {
+        const auto plane = static_cast<std::uint32_t>(mPlanes.size());
+        mPlanes.emplace_back();
+        for (const std::uint32_t member : planes.GetTrain(span))
+        {
+            const std::uint32_t satellite = satellites[member];
+            mSatellites[satellite].mPlane = plane;
+            mPlanes[plane].mMembers.push_back(satellite);
+            mGrid[CellHash(CellOf(mSatellites[satellite].mKey))].push_back(satellite);
+        }
+        Reorder(plane, time, initial);
+        Schedule(plane, time);
+    }
+    mReorderCount = 0;
+}
+
+void TrainTracker::UpdateTLE(std::size_t inIndex, const sat355::TLE& inTLE)
+{
+    assert(inIndex < mSatellites.size());
+    mUpdates.emplace_back(static_cast<std::uint32_t>(inIndex), inTLE);
+}
+
+void TrainTracker::Advance(double inTime, std::vector<Event>& ioEvents)
+{
+    assert(inTime >= mTime);
+    mTime = inTime;
+    const double time = inTime;
+
+    // Updated satellites move to the plane their new elements put them in, or start one
+    for (const auto& [index, tle] : mUpdates)
+    {
+        mTLEs[index] = tle;
+        Satellite& satellite = mSatellites[index];
+        if (satellite.mPlane != kNoPlane)
+        {
+            std::vector<std::uint32_t>& cell = mGrid[CellHash(CellOf(satellite.mKey))];
+            cell.erase(std::find(cell.begin(), cell.end(), index));
+        }
+
+        std::uint32_t newPlane = kNoPlane;
+        if (!MakeKeys({index}).empty())
+        {
+            newPlane = FindPlane(index);
+            if (newPlane == kNoPlane)
+            {
+                newPlane = static_cast<std::uint32_t>(mPlanes.size());
+                mPlanes.emplace_back();
+            }
+            mGrid[CellHash(CellOf(satellite.mKey))].push_back(index);
+        }
+        MoveToPlane(index, newPlane, ioEvents);
+        if (newPlane != kNoPlane)
+        {
+            MarkDirty(newPlane);
+        }
+    }
+    mUpdates.clear();
+
+    if (inTime - static_cast<double>(mAnchorTime) >= static_cast<double>(kAnchorIntervalSec))
+    {
+        Reanchor(inTime, ioEvents);
+    }
+
+    while (!mQueue.empty() && (mQueue.top().mTime <= time))
+    {
+        const Due due{mQueue.top()};
+        mQueue.pop();
+        if (due.mVersion == mPlanes[due.mPlane].mVersion)
+        {
+            MarkDirty(due.mPlane);
+        }
+    }
+
+    for (const std::uint32_t plane : mDirtyPlanes)
+    {
+        Reorder(plane, time, ioEvents);
+        Schedule(plane, time);
+        mPlanes[plane].mDirty = false;
+    }
+    mDirtyPlanes.clear();
+}
+
+std::vector<std::vector<std::size_t>> TrainTracker::GetTrains() const
+{
+    std::vector<std::vector<std::size_t>> trains{};
+    trains.reserve(mTrains.size());
+    for (const auto& [id, members] : mTrains)
+    {
+        trains.emplace_back(members.begin(), members.end());
+    }
+    return trains;
+}
+
+std::vector<std::uint32_t> TrainTracker::MakeKeys(const std::vector<std::uint32_t>& inSatellites)
+{
+    std::vector<sat355::TLE> tles{};
+    tles.reserve(inSatellites.size());
+    for (const std::uint32_t satellite : inSatellites)
+    {
+        tles.push_back(mTLEs[satellite]);
+    }
+    const sat355::Catalog catalog{tles};
+    sat355::Catalog::StateVectors state{};
+    sat355::Catalog::StateVectors later{};
+    catalog.ToCartesian(mAnchorTime, kPropagateDefault, kFrameECI, state);
+    catalog.ToCartesian(mAnchorTime + kRateSpanSec, kPropagateDefault, kFrameECI, later);
+
+    std::vector<std::uint32_t> made{};
+    made.reserve(inSatellites.size());
+    for (std::size_t n = 0; n < inSatellites.size(); ++n)
+    {
+        if ((state.mStatus[n] != kOK) || (later.mStatus[n] != kOK))
+        {
+            continue;
+        }
+        try
+        {
+            // The plane from the mean elements, which have no periodics to tell satellites of one plane apart;
+            // the place along it from the propagated position, as drag and the periodics have it
+            const sat355::TLE::Plane plane{tles[n].GetPlane(mAnchorTime)};
+            const double argLat = PropagatedArgLat(state, n);
+            Satellite& satellite = mSatellites[inSatellites[n]];
+            satellite.mKey = PlaneKey{tles[n].GetInclination(), plane.mRaanDegs, tles[n].GetMeanMotion(), argLat};
+
+            // Less than half a turn over the span for anything that orbits slower than once a minute
+            satellite.mArgLatRate = std::remainder(PropagatedArgLat(later, n) - argLat, 360.0) / static_cast<double>(kRateSpanSec);
+            made.push_back(inSatellites[n]);
+        }
+        catch (const sat355::exception&)
+        {
+            // Left out
+        }
+    }
+    return made;
+}
+
+double TrainTracker::ArgLat(std::uint32_t inSatellite, double inTime) const
+{
+    const Satellite& satellite = mSatellites[inSatellite];
+    const double argLat = std::fmod(satellite.mKey.mArgLat + satellite.mArgLatRate * (inTime - static_cast<double>(mAnchorTime)), 360.0);
+    return (argLat < 0.0) ? argLat + 360.0 : argLat;
+}
+
+std::uint32_t TrainTracker::FindPlane(std::uint32_t inSatellite) const
+{
+    const Satellite& satellite = mSatellites[inSatellite];
+    std::uint32_t found = kNoPlane;
+    VisitNeighbours(satellite.mKey, [this, &satellite, &found, inSatellite](std::uint64_t inCell)
+    {
+        const auto cell = mGrid.find(inCell);
+        if (cell == mGrid.end())
+        {
+            return;
+        }
+        for (const std::uint32_t other : cell->second)
+        {
+            const Satellite& otherSatellite = mSatellites[other];
+            if ((other != inSatellite) && ((found == kNoPlane) || (otherSatellite.mPlane == satellite.mPlane)) && SamePlane(satellite.mKey, otherSatellite.mKey))
+            {
+                found = otherSatellite.mPlane;
+            }
+        }
+    });
+    return found;
+}
+
+void TrainTracker::MoveToPlane(std::uint32_t inSatellite, std::uint32_t inPlane, std::vector<Event>& ioEvents)
+{
+    Satellite& satellite = mSatellites[inSatellite];
+    const std::uint32_t oldPlane = satellite.mPlane;
+    if (inPlane == oldPlane)
+    {
+        return;
+    }
+    if (oldPlane != kNoPlane)
+    {
+        std::vector<std::uint32_t>& members = mPlanes[oldPlane].mMembers;
+        members.erase(std::find(members.begin(), members.end(), inSatellite));
+        MarkDirty(oldPlane);
+    }
+    if (satellite.mTrain != kNoTrain)
+    {
+        ioEvents.push_back(Event{Event::Kind::kLeave, satellite.mTrain, kNoTrain, inSatellite});
+        std::vector<std::uint32_t>& members = mTrains[satellite.mTrain];
+        members.erase(std::find(members.begin(), members.end(), inSatellite));
+        if (members.empty())
+        {
+            mTrains.erase(satellite.mTrain);
+        }
+        satellite.mTrain = kNoTrain;
+    }
+    satellite.mPlane = inPlane;
+    if (inPlane != kNoPlane)
+    {
+        mPlanes[inPlane].mMembers.push_back(inSatellite);
+    }
+}
+
+void TrainTracker::Reanchor(double inTime, std::vector<Event>& ioEvents)
+{
+    mAnchorTime = static_cast<long long>(std::floor(inTime));
+    mGrid.clear();
+    mQueue = decltype(mQueue){};
+
+    // Keys at the new anchor; a satellite the library now rejects leaves its plane
+    std::vector<std::uint32_t> all(mSatellites.size());
+    std::iota(all.begin(), all.end(), std::uint32_t{0});
+    const std::vector<std::uint32_t> satellites{MakeKeys(all)};
+    std::vector<PlaneKey> keys{};
+    keys.reserve(satellites.size());
+    for (std::size_t made = 0, n = 0; n < all.size(); ++n)
+    {
+        if ((made < satellites.size()) && (satellites[made] == n))
+        {
+            keys.push_back(mSatellites[n].mKey);
+            ++made;
+        }
+        else
+        {
+            MoveToPlane(static_cast<std::uint32_t>(n), kNoPlane, ioEvents);
+        }
+    }
+
+    // Each plane found takes over the old plane most of its satellites were in, unless a bigger one did, else an
+    // emptied plane, else a new one
+    const app355::TrainTable planes{FindPlanes(keys)};
+    std::vector<std::size_t> bySize(planes.GetTrainCount());
+    std::iota(bySize.begin(), bySize.end(), std::size_t{0});
+    std::stable_sort(bySize.begin(), bySize.end(), [&planes](std::size_t inLHS, std::size_t inRHS) -> bool
+    {
+        return planes.GetTrain(inLHS).size() > planes.GetTrain(inRHS).size();
+    });
+    std::vector<bool> taken(mPlanes.size(), false);
+    std::vector<std::uint32_t> planeOf(planes.GetTrainCount(), kNoPlane);
+    std::vector<std::pair<std::uint32_t, std::size_t>> counts{};
+    for (const std::size_t span : bySize)
+    {
+        counts.clear();
+        for (const std::uint32_t member : planes.GetTrain(span))
+        {
+            const std::uint32_t old = mSatellites[satellites[member]].mPlane;
+            if ((old == kNoPlane) || taken[old])
+            {
+                continue;
+            }
+            const auto count = std::find_if(counts.begin(), counts.end(), [old](const auto& inCount) -> bool
+            {
+                return inCount.first == old;
+            });
+            if (count == counts.end())
+            {
+                counts.emplace_back(old, 1);
+            }
+            else
+            {
+                ++count->second;
+            }
+        }
+        std::uint32_t plane = kNoPlane;
+        std::size_t planeCount = 0;
+        for (const auto& [old, count] : counts)
+        {
+            if ((count > planeCount) || ((count == planeCount) && (old < plane)))
+            {
+                plane = old;
+                planeCount = count;
+            }
+        }
+        planeOf[span] = plane;
+        if (plane != kNoPlane)
+        {
+            taken[plane] = true;
+        }
+    }
+    for (const std::size_t span : bySize)
+    {
+        if (planeOf[span] != kNoPlane)
+        {
+            continue;
+        }
+        std::uint32_t plane = 0;
+        while ((plane < mPlanes.size()) && (taken[plane] || !mPlanes[plane].mMembers.empty()))
+        {
+            ++plane;
+        }
+        if (plane == mPlanes.size())
+        {
+            mPlanes.emplace_back();
+            taken.push_back(false);
+        }
+        taken[plane] = true;
+        planeOf[span] = plane;
+    }
+
+    for (std::size_t span = 0; span < planes.GetTrainCount(); ++span)
+    {
+        for (const std::uint32_t member : planes.GetTrain(span))
+        {
+            const std::uint32_t satellite = satellites[member];
+            MoveToPlane(satellite, planeOf[span], ioEvents);
+            mGrid[CellHash(CellOf(mSatellites[satellite].mKey))].push_back(satellite);
+        }
+    }
+    for (std::uint32_t plane = 0; plane < static_cast<std::uint32_t>(mPlanes.size()); ++plane)
+    {
+        MarkDirty(plane);
+    }
+}
+
+void TrainTracker::MarkDirty(std::uint32_t inPlane)
+{
+    if (!mPlanes[inPlane].mDirty)
+    {
+        mPlanes[inPlane].mDirty = true;
+        mDirtyPlanes.push_back(inPlane);
+    }
+}
+
+void TrainTracker::Reorder(std::uint32_t inPlane, double inTime, std::vector<Event>& ioEvents)
+{
+    ++mReorderCount;
+    Plane& plane = mPlanes[inPlane];
+    ++plane.mVersion;
+    std::vector<std::uint32_t>& order = plane.mMembers;
+    mTrainSpans.clear();
+    OrderPlane(order.data(), order.data() + order.size(), [this, inTime](std::uint32_t inSatellite) -> double
+    {
+        return ArgLat(inSatellite, inTime);
+    }, [this](std::size_t inBegin, std::size_t inEnd)
+    {
+        mTrainSpans.emplace_back(inBegin, inEnd);
+    });
+
+    // Biggest first, each train keeps the ID of the old train most of its satellites were in, if no bigger one kept it
+    std::vector<std::size_t>& bySize = mSpansBySize;
+    bySize.resize(mTrainSpans.size());
+    std::iota(bySize.begin(), bySize.end(), std::size_t{0});
+    std::stable_sort(bySize.begin(), bySize.end(), [this](std::size_t inLHS, std::size_t inRHS) -> bool
+    {
+        return mTrainSpans[inLHS].second - mTrainSpans[inLHS].first > mTrainSpans[inRHS].second - mTrainSpans[inRHS].first;
+    });
+    std::vector<std::uint32_t>& kept = mKeptTrains;
+    kept.clear();
+    auto isKept = [&kept](std::uint32_t inTrain) -> bool
+    {
+        return std::find(kept.begin(), kept.end(), inTrain) != kept.end();
+    };
+    std::vector<std::uint32_t>& newTrain = mNewTrains;
+    newTrain.assign(order.size(), kNoTrain);
+    std::vector<std::pair<std::uint32_t, std::size_t>>& counts = mTrainCounts;
+    for (const std::size_t train : bySize)
+    {
+        const auto [begin, end] = mTrainSpans[train];
+        counts.clear();
+        for (std::size_t position = begin; position < end; ++position)
+        {
+            const std::uint32_t old = mSatellites[order[position]].mTrain;
+            if (old == kNoTrain)
+            {
+                continue;
+            }
+            const auto count = std::find_if(counts.begin(), counts.end(), [old](const auto& inCount) -> bool
+            {
+                return inCount.first == old;
+            });
+            if (count == counts.end())
+            {
+                counts.emplace_back(old, 1);
+            }
+            else
+            {
+                ++count->second;
+            }
+        }
+
+        std::uint32_t id = kNoTrain;
+        std::size_t idCount = 0;
+        for (const auto& [old, count] : counts)
+        {
+            if (!isKept(old) && ((count > idCount) || ((count == idCount) && (old < id))))
+            {
+                id = old;
+                idCount = count;
+            }
+        }
+        if (id == kNoTrain)
+        {
+            id = mNextTrain++;
+        }
+        else
+        {
+            kept.push_back(id);
+        }
+        std::fill(newTrain.begin() + static_cast<std::ptrdiff_t>(begin), newTrain.begin() + static_cast<std::ptrdiff_t>(end), id);
+    }
+
+    // What changed, satellite by satellite; a split or a merge is reported once per pair of trains
+    std::vector<std::pair<std::uint32_t, std::uint32_t>>& reported = mReportedPairs;
+    reported.clear();
+    auto reportOnce = [&reported, &ioEvents](Event::Kind inKind, std::uint32_t inTrain, std::uint32_t inOther)
+    {
+        if (std::find(reported.begin(), reported.end(), std::make_pair(inTrain, inOther)) == reported.end())
+        {
+            reported.emplace_back(inTrain, inOther);
+            ioEvents.push_back(Event{inKind, inTrain, inOther, 0});
+        }
+    };
+    for (std::size_t position = 0; position < order.size(); ++position)
+    {
+        const std::uint32_t satellite = order[position];
+        const std::uint32_t from = mSatellites[satellite].mTrain;
+        const std::uint32_t to = newTrain[position];
+        if (from == to)
+        {
+            continue;
+        }
+        if (to == kNoTrain)
+        {
+            ioEvents.push_back(Event{Event::Kind::kLeave, from, kNoTrain, satellite});
+        }
+        else if (from == kNoTrain)
+        {
+            ioEvents.push_back(Event{Event::Kind::kJoin, to, kNoTrain, satellite});
+        }
+        else if (!isKept(from))
+        {
+            reportOnce(Event::Kind::kMerge, to, from);
+        }
+        else if (!isKept(to))
+        {
+            reportOnce(Event::Kind::kSplit, from, to);
+        }
+        else
+        {
+            ioEvents.push_back(Event{Event::Kind::kLeave, from, kNoTrain, satellite});
+            ioEvents.push_back(Event{Event::Kind::kJoin, to, kNoTrain, satellite});
+        }
+    }
+
+    // Old trains nothing kept are gone, the others take their new members
+    for (const std::uint32_t satellite : order)
+    {
+        const std::uint32_t old = mSatellites[satellite].mTrain;
+        if ((old != kNoTrain) && !isKept(old))
+        {
+            mTrains.erase(old);
+        }
+    }
+    for (const auto& [begin, end] : mTrainSpans)
+    {
+        mTrains[newTrain[begin]].assign(order.begin() + static_cast<std::ptrdiff_t>(begin), order.begin() + static_cast<std::ptrdiff_t>(end));
+    }
+    for (std::size_t position = 0; position < order.size(); ++position)
+    {
+        mSatellites[order[position]].mTrain = newTrain[position];
+    }
+}
+
+void TrainTracker::Schedule(std::uint32_t inPlane, double inTime)
+{
+    const Plane& plane = mPlanes[inPlane];
+    const std::size_t count = plane.mMembers.size();
+    double due = std::numeric_limits<double>::infinity();
+    for (std::size_t position = 0; (count > 1) && (position < count); ++position)
+    {
+        const std::uint32_t behind = plane.mMembers[position];
+        const std::uint32_t ahead = plane.mMembers[(position + 1) % count];
+        const double gap = std::fmod(ArgLat(ahead, inTime) - ArgLat(behind, inTime) + 360.0, 360.0);
+        const double opening = mSatellites[ahead].mArgLatRate - mSatellites[behind].mArgLatRate;
+
+        // An opening gap matters until it passes kTrainGapArgLat; a closing one when it comes within it, then
+        // when the two swap places
+        double threshold = 0.0;
+        if ((opening > 0.0) && (gap <= kTrainGapArgLat))
+        {
+            threshold = kTrainGapArgLat;
+        }
+        else if (opening < 0.0)
+        {
+            threshold = (gap > kTrainGapArgLat) ? kTrainGapArgLat : 0.0;
+        }
+        else
+        {
+            continue;
+        }
+        due = std::min(due, inTime + (threshold - gap) / opening);
+    }
+    if (due < std::numeric_limits<double>::infinity())
+    {
+        mQueue.push(Due{std::max(due, inTime), inPlane, plane.mVersion});
+    }
+}
+
+/// @brief The plane trains of inTLEVector at inTime found from scratch, as TrainTracker would at an anchor but
+/// without anything it extrapolated: planes from FindPlanes() over keys taken at inTime, each ordered by the
+/// argument of latitude of the satellite's propagated position. In the form of TrainTracker::GetTrains(), to check it
+/// against, and what a tick would cost without tracking.
+std::vector<std::vector<std::size_t>> PropagatedPlaneTrains(const std::vector<sat355::TLE>& inTLEVector, long long inTime)
+{
+    sat355::Catalog catalog{inTLEVector};
+    sat355::Catalog::StateVectors state{};
+    catalog.ToCartesian(inTime, kPropagateDefault, kFrameECI, state);
+
+    std::vector<PlaneKey> keys{};
+    std::vector<double> argLats{};
+    std::vector<std::size_t> satellites{};
+    for (std::size_t n = 0; n < inTLEVector.size(); ++n)
+    {
+        if (state.mStatus[n] != kOK)
+        {
+            continue;
+        }
+        try
+        {
+            const sat355::TLE::Plane plane{inTLEVector[n].GetPlane(inTime)};
+            keys.push_back(PlaneKey{inTLEVector[n].GetInclination(), plane.mRaanDegs, inTLEVector[n].GetMeanMotion(), plane.mArgLatDegs});
+        }
+        catch (const sat355::exception&)
+        {
+            continue;
+        }
+
+        argLats.push_back(PropagatedArgLat(state, n));
+        satellites.push_back(n);
+    }
+
+    std::vector<std::vector<std::size_t>> trains{};
+    const app355::TrainTable planes{FindPlanes(keys)};
+    std::vector<std::uint32_t> order{};
+    for (std::size_t plane = 0; plane < planes.GetTrainCount(); ++plane)
+    {
+        order.assign(planes.GetTrain(plane).begin(), planes.GetTrain(plane).end());
+        OrderPlane(order.data(), order.data() + order.size(), [&argLats](std::uint32_t inMember) -> double
+        {
+            return argLats[inMember];
+        }, [&trains, &order, &satellites](std::size_t inBegin, std::size_t inEnd)
+        {
+            std::vector<std::size_t>& train = trains.emplace_back();
+            for (std::size_t position = inBegin; position < inEnd; ++position)
+            {
+                train.push_back(satellites[order[position]]);
+            }
+        });
+    }
+    return trains;
+}
+
+#pragma endregion {}
+
+//----------------------------------------
+#pragma region Tracking
+
+/// @brief The catalog's positions at one tick of the tracking mode
+struct alignas(kCacheLineSize) Snapshot
+{
+    mutable std::atomic<int> mReaders{0};      // readers holding this snapshot
+    std::atomic<std::uint64_t> mTickBegin{0};  // written before the positions
+    std::atomic<std::uint64_t> mTickEnd{0};    // and after; they differ while a tick is writing
+    double mTime{0.0};                          // seconds since 1970, to the clock's resolution
+    OrbitArrays mOrbits{};
+};
+
+/// @brief Preallocated snapshots: the writer fills a back buffer and publishes it with an atomic exchange,
+/// and readers take the published one without a lock.
+/// A buffer is only written when no reader holds it. There is one buffer per reader on top of the
+/// published one and the back one, so the writer always finds a free buffer and never waits.
+class SnapshotBuffers
+{
+public:
+    /// @brief Holds the published snapshot until destroyed; the writer will not reuse it meanwhile
+    class ReadHandle
+    {
+    public:
+        explicit ReadHandle(const Snapshot& inSnapshot) :
+            mSnapshot{&inSnapshot}
+        {
+            // Do nothing
+        }
+        ~ReadHandle()
+        {
+            mSnapshot->mReaders.fetch_sub(1);
+        }
+        ReadHandle(const ReadHandle&) = delete;
+        ReadHandle& operator=(const ReadHandle&) = delete;
+
+        const Snapshot& operator*() const
+        {
+            return *mSnapshot;
+        }
+        const Snapshot* operator->() const
+        {
+            return mSnapshot;
+        }
+
+    private:
+        const Snapshot* mSnapshot{nullptr};
+    };
+
+    SnapshotBuffers(std::size_t inSatelliteCount, std::size_t inReaderCount);
+
+    /// @brief The last published snapshot. Lock free; retries only if a tick publishes meanwhile.
+    ReadHandle Acquire() const;
+
+    /// @brief A buffer that is neither published nor held by a reader
+    Snapshot& BeginWrite();
+
+    /// @brief Makes ioSnapshot the one Acquire() returns
+    void Publish(Snapshot& ioSnapshot);
+
+private:
+    std::vector<std::unique_ptr<Snapshot>> mBuffers{};
+    std::atomic<Snapshot*> mFront{nullptr};
+};
+
+SnapshotBuffers::SnapshotBuffers(std::size_t inSatelliteCount, std::size_t inReaderCount)
+{
+    for (std::size_t buffer = 0; buffer < inReaderCount + 2; ++buffer)
+    {
+        auto snapshot = std::make_unique<Snapshot>();
+        snapshot->mOrbits.Reset(inSatelliteCount);
+        mBuffers.push_back(std::move(snapshot));
+    }
+    mFront.store(mBuffers.front().get());
+}
+
+SnapshotBuffers::ReadHandle SnapshotBuffers::Acquire() const
+{
+    for (;;)
+    {
+        Snapshot* snapshot = mFront.load();
+        snapshot->mReaders.fetch_add(1);
+
+        // Still published after the count went up, so BeginWrite() cannot have picked it
+        if (mFront.load() == snapshot)
+        {
+            return ReadHandle{*snapshot};
+        }
+        snapshot->mReaders.fetch_sub(1);
+    }
+}
+
+Snapshot& SnapshotBuffers::BeginWrite()
+{
+    const Snapshot* front = mFront.load();
+    for (;;)
+    {
+        for (const std::unique_ptr<Snapshot>& buffer : mBuffers)
+        {
+            if ((buffer.get() != front) && (buffer->mReaders.load() == 0))
+            {
+                return *buffer;
+            }
+        }
+    }
+}
+
+void SnapshotBuffers::Publish(Snapshot& ioSnapshot)
+{
+    mFront.exchange(&ioSnapshot);
+}
+
+/// @brief What one reader thread saw, on its own cache line
+struct alignas(kCacheLineSize) ReaderCounts
+{
+    std::uint64_t mReads{0};
+    std::uint64_t mTorn{0};
+};
+
+/// @brief Reader thread of the tracking mode: reads the latest snapshot until inStop is set, and counts any
+/// snapshot that a tick wrote to while it was being read
+void ReadSnapshots(const SnapshotBuffers& inBuffers, const std::atomic<bool>& inStop, ReaderCounts& outCounts)
+{
+    while (!inStop.load())
+    {
+        const SnapshotBuffers::ReadHandle snapshot = inBuffers.Acquire();
+        const std::uint64_t tickEnd = snapshot->mTickEnd.load();
+
+        // Stand-in for a display or a conjunction screen walking the positions
+        double altitudeSumKm = 0.0;
+        for (std::size_t i = 0; i < snapshot->mOrbits.mStatus.size(); ++i)
+        {
+            if (snapshot->mOrbits.mStatus[i] == kOK)
+            {
+                altitudeSumKm += snapshot->mOrbits.mAltKm[i];
+            }
+        }
+
+        if ((snapshot->mTickBegin.load() != tickEnd) || std::isnan(altitudeSumKm))
+        {
+            ++outCounts.mTorn;
+        }
+        ++outCounts.mReads;
+    }
+}
+
+/// @brief What the train thread of the tracking mode did, on its own cache line
+struct alignas(kCacheLineSize) TrainCounts
+{
+    std::uint64_t mUpdates{0};
+    std::uint64_t mEvents{0};
+    double mMaxMs{0.0};
+};
+
+/// @brief Train thread of the tracking mode: moves ioTrains to the time of each snapshot published after
+/// inStartTime until inStop is set, then to the last one. While an update runs, ticks go on publishing; the next
+/// update skips to the latest of them.
+void FollowTrains(const SnapshotBuffers& inBuffers, const std::atomic<bool>& inStop, double inStartTime, TrainTracker& ioTrains, TrainCounts& outCounts)
+{
+    std::vector<TrainTracker::Event> events{};
+    double lastTime = inStartTime;
+    for (;;)
+    {
+        // Stop only once the last tick, published before inStop was set, has been followed
+        const bool stopping = inStop.load();
+        double time = 0.0;
+        {
+            const SnapshotBuffers::ReadHandle snapshot = inBuffers.Acquire();
+            time = snapshot->mTime;
+        }
+        if (time > lastTime)
+        {
+            Timer timer{};
+            timer.Start();
+            events.clear();
+            ioTrains.Advance(time, events);
+            outCounts.mMaxMs = std::max(outCounts.mMaxMs, timer.Stop());
+            outCounts.mEvents += events.size();
+            ++outCounts.mUpdates;
+            lastTime = time;
+        }
+        else if (stopping)
+        {
+            return;
+        }
+        else
+        {
+            std::this_thread::yield();
+        }
+    }
+}
+
+/// @brief True if any satellite that propagated in both inBefore and inAfter is at a different Lat/Lon in inAfter
+bool PositionsMoved(const OrbitArrays& inBefore, const OrbitArrays& inAfter)
+{
+    for (std::size_t i = 0; i < inAfter.mStatus.size(); ++i)
+    {
+        if ((inBefore.mStatus[i] == kOK) && (inAfter.mStatus[i] == kOK) &&
+            ((inBefore.mLatDegs[i] != inAfter.mLatDegs[i]) || (inBefore.mLonDegs[i] != inAfter.mLonDegs[i])))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+#pragma endregion {}
+
 //----------------------------------------
 #pragma region SatOrbitSingle
 
@@ -17,72 +1881,248 @@ public:
 protected:
     static bool SortPredicate(const app355::OrbitalData& inLHS, const app355::OrbitalData& inRHS);
 
+    /// @brief Partitions inTLEVector into mWorkLists, unless they were made from the same elements, and sizes mOrbits for it
+    void PrepareWorkLists(const std::vector<sat355::TLE>& inTLEVector, long long inTime);
+
+    /// @brief True if inTLEVector holds the elements mWorkLists were made from, in the same order
+    bool WorkListsMatch(const std::vector<sat355::TLE>& inTLEVector) const;
+
+    /// @brief Sorts ioOrbitalVector by mean motion through mSortKeys, with the kKeyIndex or kRadix method
+    void SortByKey(std::vector<app355::OrbitalData>& ioOrbitalVector);
+
+    /// @brief Checks the path in inArgv[1] and opens it, or throws std::filesystem::filesystem_error
+    static std::ifstream OpenTLEFile(int inArgc, char* inArgv[]);
+
+    /// @brief Parses one batch of TLE file lines, propagates it to inTime and returns its orbital data sorted by mean motion
+    static std::vector<app355::OrbitalData> ProcessBatch(std::vector<std::string> inLines, long long inTime, bool inRadix);
+
+    /// @brief Appends an OrbitalData for each satellite in mOrbits that propagated, in catalog order
+    void CollectOrbitalData(const std::vector<sat355::TLE>& inTLEVector, std::vector<app355::OrbitalData>& ioOrbitalVector) const;
+
+    /// @brief Propagates every list in mWorkLists to inTime, in seconds since 1970 with any fraction, into ioOrbits,
+    /// which Reset() has sized for the catalog. Fills mBusyMs.
+    virtual void PropagateOrbits(double inTime, OrbitArrays& ioOrbits);
+
+    /// @brief PropagateOrbits() into mOrbits, then appends the satellites that propagated to outOrbitalVector
+    virtual void PropagateWorkLists(const std::vector<sat355::TLE>& inTLEVector, long long inTime, std::vector<app355::OrbitalData>& outOrbitalVector);
+
+    /// @brief Propagates every list in mWorkLists to each time in ioMatrix, which is sized for the catalog. Fills mBusyMs.
+    virtual void PropagateTimes(OrbitalMatrix& ioMatrix);
+
+    /// @brief Calls inTask(n) for every n in [0, inCount), in any order
+    virtual void RunTasks(std::size_t inCount, FunctionRef<void(std::size_t)> inTask);
+
+    /// @brief How many threads RunTasks() spreads its tasks over
+    virtual std::size_t GetTaskThreadCount() const;
+
+    /// @brief One piece of a merge level: output positions [mOut, mOut + (mFirstEnd - mFirst) + (mSecondEnd - mSecond))
+    /// take the stable merge of the two input ranges, which are offsets into the same buffer
+    struct MergePiece
+    {
+        std::size_t mFirst;
+        std::size_t mFirstEnd;
+        std::size_t mSecond;
+        std::size_t mSecondEnd;
+        std::size_t mOut;
+    };
+
+    /// @brief Merges the sorted runs [inBounds[n], inBounds[n + 1]) of ioRecords into one, stably, with RunTasks().
+    /// inBounds starts at 0 and ends at the record count.
+    void MergeRuns(app355::OrbitalData* ioRecords, std::vector<std::size_t> inBounds);
+
+    /// @brief Cuts the merge of runs [inBegin, inMid) and [inMid, inEnd) into inPieceCount pieces of equal output length,
+    /// along the merge path, and appends them to ioPieces
+    static void SplitMerge(const app355::OrbitalData* inRecords, std::size_t inBegin, std::size_t inMid, std::size_t inEnd,
+                           std::size_t inPieceCount, std::vector<MergePiece>& ioPieces);
+
+    /// @brief Moves one piece of a merge level from ioFrom to outTo
+    static void MergePieceInto(const MergePiece& inPiece, app355::OrbitalData* ioFrom, app355::OrbitalData* outTo);
+
+    /// @brief TrainKind::kPlane: the trains of each orbital plane at mEvaluationTime, plane by plane
+    app355::TrainTable CreatePlaneTrains(const std::vector<app355::OrbitalData>& inOrbitalVector);
+
+// Data Members
+protected:
+    std::vector<WorkList> mWorkLists{};
+    std::vector<std::string> mWorkListElements{}; // line 1 and 2 of each TLE the lists were made from
+    std::size_t mChunkCount{1};                  // lists to aim for, see MakeWorkLists()
+    OrbitArrays mOrbits{};
+    std::vector<double> mBusyMs{0.0};            // per thread, last PropagateWorkLists()
+    SortKind mSortKind{SortKind::kRadix};
+    TrainKind mTrainKind{TrainKind::kMeanMotion};
+    long long mEvaluationTime{0};                // of the last orbital data calculated; 0 until then
+    std::vector<SortKey> mSortKeys{};            // kept between sorts so their capacity is reused
+    std::vector<SortKey> mSortScratch{};
+
 // Implementation
 private:
     // SatOrbit
     std::vector<sat355::TLE> OnReadFromFile(int inArgc, char* inArgv[]) override;
-    void OnCalculateOrbitalDataAsync(const std::vector<sat355::TLE>& inTLEVector, std::shared_ptr<OrbitalDataVector> ioDataVector) override;
+    void OnCalculateOrbitalDataAsync(const std::vector<sat355::TLE>& inTLEVector, long long inTime, std::shared_ptr<OrbitalDataVector> ioDataVector) override;
+    OrbitalMatrix OnCalculateOrbitalMatrix(const std::vector<sat355::TLE>& inTLEVector, const std::vector<long long>& inTimes) override;
     void OnSortOrbitalVectorAsync(std::shared_ptr<OrbitalDataVector> ioDataVector) override;
-    std::vector<std::vector<app355::OrbitalData>> OnCreateTrains(const std::vector<app355::OrbitalData>& inOrbitalVector) override;
-    void OnPrintTrains(const std::vector<std::vector<app355::OrbitalData>>& inTrainVector) override;
+    void OnSetSortKind(SortKind inKind) override;
+    void OnSetTrainKind(TrainKind inKind) override;
+    PipelineResult OnRunPipeline(int inArgc, char* inArgv[], std::size_t inBatchSize) override;
+    app355::TrainTable OnCreateTrains(const std::vector<app355::OrbitalData>& inOrbitalVector) override;
+    void OnPrintTrains(const std::vector<app355::OrbitalData>& inOrbitalVector, const app355::TrainTable& inTrains) override;
+    std::vector<double> OnGetThreadBusyMs() const override;
+    TrackingStats OnTrack(const std::vector<sat355::TLE>& inTLEVector, double inRateHz, std::size_t inTicks, std::size_t inReaderCount) override;
 };
 
-std::unique_ptr<SatOrbitSingle> SatOrbitSingle::Make()
-{
-    auto satOrbit = std::make_unique<SatOrbitSingle>();
-    return satOrbit;
+std::unique_ptr<SatOrbitSingle> SatOrbitSingle::Make()
+{
+    auto satOrbit = std::make_unique<SatOrbitSingle>();
+    return satOrbit;
+}
+
+// Single Threaded
+void SatOrbitSingle::OnCalculateOrbitalDataAsync(const std::vector<sat355::TLE>& inTLEVector, long long inTime, std::shared_ptr<OrbitalDataVector> ioDataVector)
+{   
+    // Update TLE list with web address
+    // https://celestrak.org/NORAD/elements/gp.php?NAME=Starlink&FORMAT=TLE
+    // Every satellite is evaluated at inTime, converted once per work list
+    mEvaluationTime = inTime;
+    PrepareWorkLists(inTLEVector, inTime);
+    std::vector<app355::OrbitalData> orbitalVector{};
+    PropagateWorkLists(inTLEVector, inTime, orbitalVector);
+
+    auto& [mutex, outputVector] = *ioDataVector; // C++17 Structured Binding simplifies tuple unpacking
+    // Use mutex to protect access to the list
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (outputVector.empty())
+        {
+            outputVector = std::move(orbitalVector);
+        }
+        else
+        {
+            outputVector.insert(outputVector.end(), std::make_move_iterator(orbitalVector.begin()), std::make_move_iterator(orbitalVector.end()));
+        }
+    }
+}
+
+app355::SatOrbit::OrbitalMatrix SatOrbitSingle::OnCalculateOrbitalMatrix(const std::vector<sat355::TLE>& inTLEVector, const std::vector<long long>& inTimes)
+{
+    PrepareWorkLists(inTLEVector, inTimes.empty() ? time(nullptr) : inTimes.front());
+
+    // Satellites in no list keep kInvalidTLE
+    OrbitalMatrix matrix{};
+    matrix.mTimes = inTimes;
+    matrix.mSatelliteCount = inTLEVector.size();
+    const std::size_t count = matrix.mSatelliteCount * inTimes.size();
+    matrix.mLatDegs.resize(count);
+    matrix.mLonDegs.resize(count);
+    matrix.mAltKm.resize(count);
+    matrix.mStatus.assign(count, kInvalidTLE);
+    if (count != 0)
+    {
+        PropagateTimes(matrix);
+    }
+    return matrix;
+}
+
+void SatOrbitSingle::OnSortOrbitalVectorAsync(std::shared_ptr<OrbitalDataVector> ioDataVector)
+{
+    auto& [mutex, orbitalVector] = *ioDataVector;
+    if (mSortKind != SortKind::kRecords)
+    {
+        SortByKey(orbitalVector);
+        return;
+    }
+
+    std::sort(orbitalVector.begin(), orbitalVector.end(), [](const app355::OrbitalData& inLHS, const app355::OrbitalData& inRHS) -> bool
+    {
+        return SortPredicate(inLHS, inRHS);
+    });
+}
+
+void SatOrbitSingle::OnSetSortKind(SortKind inKind)
+{
+    mSortKind = inKind;
+}
+
+void SatOrbitSingle::OnSetTrainKind(TrainKind inKind)
+{
+    mTrainKind = inKind;
+}
+
+// Thread Independent
+std::vector<sat355::TLE> SatOrbitSingle::OnReadFromFile(int inArgc, char* inArgv[])
+{
+    std::ifstream fileStream{OpenTLEFile(inArgc, inArgv)};
+
+    std::vector<app355::OrbitalData> orbitalVector;
+    std::string readLine;
+
+    std::string name{};
+    std::string line1{};
+    std::string line2{};
+    
+    std::vector<sat355::TLE> tleVector;
+
+    while (!fileStream.eof())
+    {
+        std::getline(fileStream, name);
+        std::getline(fileStream, line1);
+        std::getline(fileStream, line2);
+
+       sat355::TLE newTLE{name, line1, line2};
+        tleVector.push_back(std::move(newTLE));
+    }
+
+    // Partition once at load; later calls with these TLEs reuse the lists
+    PrepareWorkLists(tleVector, time(nullptr));
+    
+    return tleVector;
 }
 
-// Single Threaded
-void SatOrbitSingle::OnCalculateOrbitalDataAsync(const std::vector<sat355::TLE>& inTLEVector, std::shared_ptr<OrbitalDataVector> ioDataVector)
-{   
-    auto tleBegin = inTLEVector.begin();
-    auto tleEnd = inTLEVector.end();
-    const auto size = static_cast<std::size_t>(std::distance(tleBegin, tleEnd));
-    std::vector<app355::OrbitalData> orbitalVector{};
-    orbitalVector.reserve(size);
-    std::for_each(tleBegin, tleEnd, [&](const sat355::TLE& inTLE)
+app355::TrainTable SatOrbitSingle::OnCreateTrains(const std::vector<app355::OrbitalData>& inOrbitalVector)
+{
+    if (mTrainKind == TrainKind::kPlane)
     {
-        double out_tleage = 0.0;
-        double out_latdegs = 0.0;
-        double out_londegs = 0.0;
-        double out_altkm = 0.0;
-
-        // Update TLE list with web address
-        // https://celestrak.org/NORAD/elements/gp.php?NAME=Starlink&FORMAT=TLE
-        // get current time as a long long in seconds
-        
-        long long testTime = time(nullptr);
-        //long long testTime = 1705781559; // Time TLEs stored in StarlinkTLE.txt were recorded
+        return CreatePlaneTrains(inOrbitalVector);
+    }
 
-        int result = orbit_to_lla(testTime, inTLE.GetName().data(), inTLE.GetLine1().data(), inTLE.GetLine2().data(), &out_tleage, &out_latdegs, &out_londegs, &out_altkm);
-        if (result == 0)
-        {
-            // Warning! Cannot use tle anymore as it has been moved!
-            app355::OrbitalData data(inTLE, out_latdegs, out_londegs, out_altkm);
-            orbitalVector.push_back(std::move(data));
-        }
-    });
+    // Some trains will be in close proximity, therefore we must merge them
+    // Merge trains whose satellites' mean motions are within 0.001 degrees of each other
+    return MergeTrains(FindTrainRuns(inOrbitalVector), inOrbitalVector);
+}
 
-    auto& [mutex, outputVector] = *ioDataVector; // C++17 Structured Binding simplifies tuple unpacking
-    // Use mutex to protect access to the list
+void SatOrbitSingle::OnPrintTrains(const std::vector<app355::OrbitalData>& inOrbitalVector, const app355::TrainTable& inTrains)
+{
+    // Print the contents of the train list
+    for (std::size_t trainCount = 0; trainCount < inTrains.GetTrainCount(); ++trainCount)
     {
-        std::lock_guard<std::mutex> lock(mutex);
-        outputVector.insert(outputVector.end(), orbitalVector.begin(), orbitalVector.end());
+        const app355::TrainTable::Members train{inTrains.GetTrain(trainCount)};
+        std::cout << "   TRAIN #" << trainCount << std::endl;
+        std::cout << "   COUNT: " << train.size() << std::endl;
+
+        std::for_each(train.begin(), train.end(), [&inOrbitalVector](std::uint32_t inPosition)
+        {
+            // Print the name, mean motion, latitude, longitude, and altitude
+            const app355::OrbitalData& data = inOrbitalVector[inPosition];
+            std::cout << data.GetTLE().GetName() << ": " << data.GetTLE().GetMeanMotion() << std::endl;
+            std::cout << "Lat: " << data.GetLatitude() << std::endl;
+            std::cout << "Lon: " << data.GetLongitude() << std::endl;
+            std::cout << "Alt: " << data.GetAltitude() << std::endl << std::endl;
+        });
+        std::cout << std::endl << std::endl;
     }
 }
 
-void SatOrbitSingle::OnSortOrbitalVectorAsync(std::shared_ptr<OrbitalDataVector> ioDataVector)
+// Helper
+/*static*/ bool SatOrbitSingle::SortPredicate(const app355::OrbitalData& inLHS, const app355::OrbitalData& inRHS)
 {
-    auto& [mutex, orbitalVector] = *ioDataVector;
-    std::sort(orbitalVector.begin(), orbitalVector.end(), [](const app355::OrbitalData& inLHS, const app355::OrbitalData& inRHS) -> bool
-    {
-        return SortPredicate(inLHS, inRHS);
-    });
+    return inLHS.GetMeanMotion() < inRHS.GetMeanMotion();
 }
 
-// Thread Independent
-std::vector<sat355::TLE> SatOrbitSingle::OnReadFromFile(int inArgc, char* inArgv[])
+void SatOrbitSingle::SortByKey(std::vector<app355::OrbitalData>& ioOrbitalVector)
+{
+    SortOrbitalByKey(ioOrbitalVector, mSortKind == SortKind::kRadix, mSortKeys, mSortScratch);
+}
+
+/*static*/ std::ifstream SatOrbitSingle::OpenTLEFile(int inArgc, char* inArgv[])
 {
     if (inArgc < 2) 
     {
@@ -108,113 +2148,460 @@ std::vector<sat355::TLE> SatOrbitSingle::OnReadFromFile(int inArgc, char* inArgv
         throw std::filesystem::filesystem_error("File could not be opened", err);
     }
 
-    std::vector<app355::OrbitalData> orbitalVector;
-    std::string readLine;
+    return fileStream;
+}
+
+/*static*/ std::vector<app355::OrbitalData> SatOrbitSingle::ProcessBatch(std::vector<std::string> inLines, long long inTime, bool inRadix)
+{
+    std::vector<sat355::TLE> tleVector{};
+    tleVector.reserve(inLines.size() / 3);
+    for (std::size_t line = 0; line + 2 < inLines.size(); line += 3)
+    {
+        tleVector.emplace_back(inLines[line], inLines[line + 1], inLines[line + 2]);
+    }
+
+    std::vector<WorkList> workLists{MakeWorkLists(tleVector, inTime, 1)};
+    OrbitArrays orbits{};
+    orbits.Reset(tleVector.size());
+    for (WorkList& workList : workLists)
+    {
+        workList.Propagate(inTime, orbits);
+    }
+
+    std::vector<app355::OrbitalData> orbitalVector{};
+    orbitalVector.reserve(tleVector.size());
+    AppendOrbitalData(orbits, tleVector, 0, tleVector.size(), orbitalVector);
+
+    std::vector<SortKey> keys{};
+    std::vector<SortKey> scratch{};
+    SortOrbitalByKey(orbitalVector, inRadix, keys, scratch);
+    return orbitalVector;
+}
+
+app355::SatOrbit::PipelineResult SatOrbitSingle::OnRunPipeline(int inArgc, char* inArgv[], std::size_t inBatchSize)
+{
+    Timer latencyTimer{};
+    latencyTimer.Start();
+
+    std::ifstream fileStream{OpenTLEFile(inArgc, inArgv)};
+    const long long testTime = time(nullptr);
+    mEvaluationTime = testTime;
+    const bool radix = (mSortKind == SortKind::kRadix);
+    const std::size_t batchLines = 3 * std::max<std::size_t>(inBatchSize, 1);
+
+    // Batches are parsed, propagated and sorted through RunTasks(), a window of one batch per thread at a time,
+    // while the next window is read. At most two windows of lines are held, however long the file.
+    const std::size_t windowSize = GetTaskThreadCount();
+    std::vector<std::vector<app355::OrbitalData>> sortedBatches{};
+    std::vector<std::vector<std::string>> window{};
+    std::future<void> processing{};
+    auto processWindow = [this, &sortedBatches, &window, &processing, testTime, radix]()
+    {
+        if (processing.valid())
+        {
+            processing.get();
+        }
+        const std::size_t first = sortedBatches.size();
+        sortedBatches.resize(first + window.size());
+        processing = std::async(std::launch::async, [this, &sortedBatches, first, lines = std::move(window), testTime, radix]() mutable
+        {
+            RunTasks(lines.size(), [&sortedBatches, first, &lines, testTime, radix](std::size_t inBatch)
+            {
+                sortedBatches[first + inBatch] = ProcessBatch(std::move(lines[inBatch]), testTime, radix);
+            });
+        });
+        window.clear();
+    };
 
+    std::vector<std::string> lines{};
     std::string name{};
     std::string line1{};
     std::string line2{};
-    
-    std::vector<sat355::TLE> tleVector;
-
     while (!fileStream.eof())
     {
         std::getline(fileStream, name);
         std::getline(fileStream, line1);
         std::getline(fileStream, line2);
+        lines.push_back(std::move(name));
+        lines.push_back(std::move(line1));
+        lines.push_back(std::move(line2));
 
-       sat355::TLE newTLE{name, line1, line2};
-        tleVector.push_back(std::move(newTLE));
+        if ((lines.size() >= batchLines) || fileStream.eof())
+        {
+            window.push_back(std::move(lines));
+            lines.clear();
+        }
+        if ((window.size() >= windowSize) || (fileStream.eof() && !window.empty()))
+        {
+            processWindow();
+        }
     }
-    
-    return tleVector;
+    if (processing.valid())
+    {
+        processing.get();
+    }
+
+    // One tree merge of all the batches in file order; the earlier batch wins ties, as in a stable sort
+    std::vector<app355::OrbitalData> orbitalVector{};
+    std::vector<std::size_t> bounds{0};
+    for (std::vector<app355::OrbitalData>& sortedBatch : sortedBatches)
+    {
+        std::move(sortedBatch.begin(), sortedBatch.end(), std::back_inserter(orbitalVector));
+        bounds.push_back(orbitalVector.size());
+        sortedBatch = std::vector<app355::OrbitalData>{};
+    }
+    if (bounds.size() > 2)
+    {
+        MergeRuns(orbitalVector.data(), std::move(bounds));
+    }
+
+    // Trains span the whole catalog, so they wait for the last batch
+    PipelineResult result{};
+    result.mOrbitalData = std::make_shared<OrbitalDataVector>();
+    std::vector<app355::OrbitalData>& sortedVector = std::get<1>(*result.mOrbitalData);
+    sortedVector.swap(orbitalVector);
+    result.mTrains = OnCreateTrains(sortedVector);
+    result.mLatencyMs = latencyTimer.Stop();
+    return result;
 }
 
-std::vector<std::vector<app355::OrbitalData>> SatOrbitSingle::OnCreateTrains(const std::vector<app355::OrbitalData>& inOrbitalVector)
+void SatOrbitSingle::PrepareWorkLists(const std::vector<sat355::TLE>& inTLEVector, long long inTime)
 {
-    std::vector<std::vector<app355::OrbitalData>> trainVector;
-    std::vector<app355::OrbitalData> newTrain;
+    if (!WorkListsMatch(inTLEVector))
+    {
+        mWorkLists = MakeWorkLists(inTLEVector, inTime, mChunkCount);
+        mWorkListElements.clear();
+        mWorkListElements.reserve(inTLEVector.size());
+        for (const sat355::TLE& tle : inTLEVector)
+        {
+            std::string elements{tle.GetLine1()};
+            elements += tle.GetLine2();
+            mWorkListElements.push_back(std::move(elements));
+        }
+    }
 
-    double prevMeanMotion = 0;
-    double prevInclination = 0;
+    // Satellites in no list keep kInvalidTLE
+    mOrbits.Reset(inTLEVector.size());
+}
 
-    std::for_each(inOrbitalVector.begin(), inOrbitalVector.end(), [&](auto& data)
+bool SatOrbitSingle::WorkListsMatch(const std::vector<sat355::TLE>& inTLEVector) const
+{
+    // Compared by content: a different vector can reuse the buffer, and the same one can be edited in place
+    if (mWorkLists.empty() || (mWorkListElements.size() != inTLEVector.size()))
     {
-        double deltaMotion = abs(data.GetTLE().GetMeanMotion() - prevMeanMotion);
-        double deltaInclination = abs(data.GetTLE().GetInclination() - prevInclination);
-        if ((deltaMotion > 0.0001 || deltaInclination > 0.0001) && !newTrain.empty())
+        return false;
+    }
+
+    for (std::size_t n = 0; n < inTLEVector.size(); ++n)
+    {
+        const std::string_view line1 = inTLEVector[n].GetLine1();
+        const std::string_view line2 = inTLEVector[n].GetLine2();
+        const std::string_view elements = mWorkListElements[n];
+        if ((elements.size() != line1.size() + line2.size()) ||
+            (elements.substr(0, line1.size()) != line1) || (elements.substr(line1.size()) != line2))
         {
-            // Sort by longitude
-            std::sort(newTrain.begin(), newTrain.end(), [](const app355::OrbitalData& inLHS, const app355::OrbitalData& inRHS) -> bool
-            {
-                return inLHS.GetLongitude() < inRHS.GetLongitude();
-            });
+            return false;
+        }
+    }
+    return true;
+}
 
-            // Filter out wandering satellites
-            if (newTrain.size() > 3)
+void SatOrbitSingle::PropagateOrbits(double inTime, OrbitArrays& ioOrbits)
+{
+    Timer busyTimer{};
+    busyTimer.Start();
+    for (WorkList& workList : mWorkLists)
+    {
+        workList.Propagate(inTime, ioOrbits);
+    }
+    mBusyMs.assign(1, busyTimer.Stop());
+}
+
+void SatOrbitSingle::PropagateTimes(OrbitalMatrix& ioMatrix)
+{
+    Timer busyTimer{};
+    busyTimer.Start();
+    for (WorkList& workList : mWorkLists)
+    {
+        workList.PropagateTimes(ioMatrix);
+    }
+    mBusyMs.assign(1, busyTimer.Stop());
+}
+
+void SatOrbitSingle::RunTasks(std::size_t inCount, FunctionRef<void(std::size_t)> inTask)
+{
+    for (std::size_t n = 0; n < inCount; ++n)
+    {
+        inTask(n);
+    }
+}
+
+std::size_t SatOrbitSingle::GetTaskThreadCount() const
+{
+    return 1;
+}
+
+void SatOrbitSingle::MergeRuns(app355::OrbitalData* ioRecords, std::vector<std::size_t> inBounds)
+{
+    // Merge neighbouring runs pairwise, a level at a time, until one run is left. Each level merges out of one
+    // buffer into the other, cut into about one piece per thread along the merge path, so the last levels, with
+    // fewer pairs than threads, use every thread too. The records are moved, never copied.
+    std::vector<std::size_t>& bounds = inBounds;
+    const std::size_t count = bounds.back();
+    const std::size_t threadCount = GetTaskThreadCount();
+    std::vector<app355::OrbitalData> scratch(std::make_move_iterator(ioRecords), std::make_move_iterator(ioRecords + count));
+    app355::OrbitalData* from = scratch.data();
+    app355::OrbitalData* to = ioRecords;
+    std::vector<MergePiece> pieces{};
+    while (bounds.size() > 2)
+    {
+        pieces.clear();
+        std::vector<std::size_t> merged{0};
+        for (std::size_t run = 0; run + 1 < bounds.size(); run += 2)
+        {
+            if (run + 2 >= bounds.size())
             {
-                trainVector.push_back(std::move(newTrain));
+                // The odd run out moves as it is
+                pieces.push_back(MergePiece{bounds[run], bounds[run + 1], bounds[run + 1], bounds[run + 1], bounds[run]});
+                merged.push_back(bounds[run + 1]);
+                break;
             }
-            
-            newTrain.clear();
+
+            const std::size_t length = bounds[run + 2] - bounds[run];
+            const std::size_t pieceCount = std::max<std::size_t>(1, (threadCount * length + count - 1) / count);
+            SplitMerge(from, bounds[run], bounds[run + 1], bounds[run + 2], pieceCount, pieces);
+            merged.push_back(bounds[run + 2]);
         }
-        prevMeanMotion = data.GetTLE().GetMeanMotion();
-        prevInclination = data.GetTLE().GetInclination();
 
-        newTrain.push_back(data);
-    });
-    if (!newTrain.empty() && newTrain.size() > 2)
+        RunTasks(pieces.size(), [&pieces, from, to](std::size_t inPiece)
+        {
+            MergePieceInto(pieces[inPiece], from, to);
+        });
+        bounds = std::move(merged);
+        std::swap(from, to);
+    }
+
+    // An odd number of levels leaves the result in the scratch buffer
+    if (from == scratch.data())
     {
-        trainVector.push_back(newTrain);
+        std::move(scratch.begin(), scratch.end(), ioRecords);
     }
+}
 
-    // Some trains will be in close proximity, therefore we must merge them
-    // Merge trains whose satellites' mean motions are within 0.001 degrees of each other
-    for (std::size_t i = 0; i < trainVector.size(); ++i)
+/*static*/ void SatOrbitSingle::SplitMerge(const app355::OrbitalData* inRecords, std::size_t inBegin, std::size_t inMid, std::size_t inEnd,
+                               std::size_t inPieceCount, std::vector<MergePiece>& ioPieces)
+{
+    const std::size_t firstCount = inMid - inBegin;
+    const std::size_t secondCount = inEnd - inMid;
+
+    // How many of the first run are among the first inDiagonal records of the merge. std::merge takes the first
+    // run's record on a tie, so first[i] is taken before second[j] unless second[j] < first[i].
+    auto firstTaken = [inRecords, inBegin, inMid, firstCount, secondCount](std::size_t inDiagonal) -> std::size_t
     {
-        for (std::size_t j = i + 1; j < trainVector.size(); ++j)
+        std::size_t low = (inDiagonal > secondCount) ? inDiagonal - secondCount : 0;
+        std::size_t high = std::min(inDiagonal, firstCount);
+        while (low < high)
         {
-            double deltaMotion = abs(trainVector[i][0].GetTLE().GetMeanMotion() - trainVector[j][0].GetTLE().GetMeanMotion());
-            if (deltaMotion < 0.001)
+            const std::size_t taken = low + (high - low) / 2;
+            if (SortPredicate(inRecords[inMid + inDiagonal - taken - 1], inRecords[inBegin + taken]))
             {
-                trainVector[i].insert(trainVector[i].end(), trainVector[j].begin(), trainVector[j].end());
-                assert(static_cast<std::ptrdiff_t>(j) >= 0);
-                trainVector.erase(trainVector.begin() + static_cast<std::ptrdiff_t>(j));
-                --j;
+                high = taken;
+            }
+            else
+            {
+                low = taken + 1;
             }
         }
+        return low;
+    };
+
+    std::size_t diagonal = 0;
+    std::size_t taken = 0;
+    for (std::size_t piece = 1; piece <= inPieceCount; ++piece)
+    {
+        const std::size_t nextDiagonal = (firstCount + secondCount) * piece / inPieceCount;
+        const std::size_t nextTaken = (piece == inPieceCount) ? firstCount : firstTaken(nextDiagonal);
+        ioPieces.push_back(MergePiece{inBegin + taken, inBegin + nextTaken,
+                                      inMid + (diagonal - taken), inMid + (nextDiagonal - nextTaken), inBegin + diagonal});
+        diagonal = nextDiagonal;
+        taken = nextTaken;
     }
-    
-    return trainVector;
 }
 
-void SatOrbitSingle::OnPrintTrains(const std::vector<std::vector<app355::OrbitalData>>& inTrainVector)
+/*static*/ void SatOrbitSingle::MergePieceInto(const MergePiece& inPiece, app355::OrbitalData* ioFrom, app355::OrbitalData* outTo)
 {
-    int trainCount = 0;
-    // Print the contents of the train list
+    std::merge(std::make_move_iterator(ioFrom + inPiece.mFirst), std::make_move_iterator(ioFrom + inPiece.mFirstEnd),
+               std::make_move_iterator(ioFrom + inPiece.mSecond), std::make_move_iterator(ioFrom + inPiece.mSecondEnd),
+               outTo + inPiece.mOut, [](const app355::OrbitalData& inLHS, const app355::OrbitalData& inRHS) -> bool
+    {
+        return SortPredicate(inLHS, inRHS);
+    });
+}
 
-    std::for_each(inTrainVector.begin(), inTrainVector.end(), [&](auto& train)
+app355::TrainTable SatOrbitSingle::CreatePlaneTrains(const std::vector<app355::OrbitalData>& inOrbitalVector)
+{
+    // Keys of every satellite at one time, a block of the catalog per task
+    constexpr std::size_t kKeyBlock = 1024;
+    const long long evaluationTime = (mEvaluationTime != 0) ? mEvaluationTime : time(nullptr);
+    std::vector<PlaneKey> keys(inOrbitalVector.size());
+    RunTasks((keys.size() + kKeyBlock - 1) / kKeyBlock, [&inOrbitalVector, &keys, evaluationTime](std::size_t inBlock)
     {
-        std::cout << "   TRAIN #" << trainCount << std::endl;
-        std::cout << "   COUNT: " << train.size() << std::endl;
+        const std::size_t end = std::min(keys.size(), (inBlock + 1) * kKeyBlock);
+        for (std::size_t n = inBlock * kKeyBlock; n < end; ++n)
+        {
+            const sat355::TLE& tle = inOrbitalVector[n].GetTLE();
+            const sat355::TLE::Plane plane = tle.GetPlane(evaluationTime);
+            keys[n] = PlaneKey{tle.GetInclination(), plane.mRaanDegs, inOrbitalVector[n].GetMeanMotion(), plane.mArgLatDegs};
+        }
+    });
 
-        std::for_each(train.begin(), train.end(), [](auto& data)
+    // Each plane is ordered in place in its span of one flat array, and marks where its trains end at their start
+    const app355::TrainTable planes{FindPlanes(keys)};
+    std::vector<std::uint32_t> order{planes.GetMembers()};
+    std::vector<std::size_t> trainEnd(order.size(), 0);
+    RunTasks(planes.GetTrainCount(), [&planes, &keys, &order, &trainEnd](std::size_t inPlane)
+    {
+        const std::size_t offset = planes.GetOffsets()[inPlane];
+        OrderPlane(order.data() + offset, order.data() + planes.GetOffsets()[inPlane + 1], [&keys](std::uint32_t inSatellite) -> double
         {
-            // Print the name, mean motion, latitude, longitude, and altitude
-            std::cout << data.GetTLE().GetName() << ": " << data.GetTLE().GetMeanMotion() << std::endl;
-            std::cout << "Lat: " << data.GetLatitude() << std::endl;
-            std::cout << "Lon: " << data.GetLongitude() << std::endl;
-            std::cout << "Alt: " << data.GetAltitude() << std::endl << std::endl;
+            return keys[inSatellite].mArgLat;
+        }, [&trainEnd, offset](std::size_t inBegin, std::size_t inEnd)
+        {
+            trainEnd[offset + inBegin] = offset + inEnd;
         });
-        std::cout << std::endl << std::endl;
-        trainCount++;
     });
+
+    app355::TrainTable trains{};
+    trains.Reserve(order.size(), order.size() / 4);
+    for (std::size_t position = 0; position < order.size();)
+    {
+        if (trainEnd[position] == 0)
+        {
+            ++position;
+            continue;
+        }
+        for (const std::size_t end = trainEnd[position]; position < end; ++position)
+        {
+            trains.AddMember(order[position]);
+        }
+        trains.EndTrain();
+    }
+    return trains;
 }
 
-// Helper
-/*static*/ bool SatOrbitSingle::SortPredicate(const app355::OrbitalData& inLHS, const app355::OrbitalData& inRHS)
+void SatOrbitSingle::PropagateWorkLists(const std::vector<sat355::TLE>& inTLEVector, long long inTime, std::vector<app355::OrbitalData>& outOrbitalVector)
+{
+    PropagateOrbits(inTime, mOrbits);
+
+    Timer busyTimer{};
+    busyTimer.Start();
+    CollectOrbitalData(inTLEVector, outOrbitalVector);
+    mBusyMs[0] += busyTimer.Stop();
+}
+
+app355::SatOrbit::TrackingStats SatOrbitSingle::OnTrack(const std::vector<sat355::TLE>& inTLEVector, double inRateHz, std::size_t inTicks, std::size_t inReaderCount)
+{
+    using Clock = std::chrono::steady_clock;
+
+    PrepareWorkLists(inTLEVector, time(nullptr));
+
+    // Everything a tick touches is allocated here, before the first tick. The trains follow the published
+    // snapshots on a thread of their own, as one more reader, so a tick never waits for them to be found again.
+    SnapshotBuffers buffers{inTLEVector.size(), inReaderCount + 1};
+    const long long trainTime = time(nullptr);
+    TrainTracker trains{inTLEVector, trainTime};
+    TrainCounts trainCounts{};
+    std::vector<double> latencyMs(inTicks, 0.0);
+    std::vector<ReaderCounts> readerCounts(inReaderCount);
+    std::atomic<bool> stop{false};
+
+    std::vector<std::thread> readers{};
+    readers.reserve(inReaderCount + 1);
+    for (std::size_t reader = 0; reader < inReaderCount; ++reader)
+    {
+        readers.emplace_back(ReadSnapshots, std::cref(buffers), std::cref(stop), std::ref(readerCounts[reader]));
+    }
+    readers.emplace_back(FollowTrains, std::cref(buffers), std::cref(stop), static_cast<double>(trainTime), std::ref(trains), std::ref(trainCounts));
+
+    const auto period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / std::max(inRateHz, 1.0e-3)));
+    const auto start = Clock::now();
+
+    // Tick times are the wall clock at the start plus the steady clock since, so they keep the fraction of a second
+    // that time() drops and never step back
+    const double startTime = std::chrono::duration<double>(std::chrono::system_clock::now().time_since_epoch()).count();
+    const Snapshot* previous = nullptr;
+    TrackingStats stats{};
+    for (std::size_t tick = 0; tick < inTicks; ++tick)
+    {
+        // Ticks are scheduled from the start, so a late tick does not push the later ones back
+        const auto scheduled = start + period * static_cast<Clock::rep>(tick);
+        std::this_thread::sleep_until(scheduled);
+
+        Snapshot& back = buffers.BeginWrite();
+        back.mTickBegin.store(tick);
+        back.mTime = startTime + std::chrono::duration<double>(Clock::now() - start).count();
+        PropagateOrbits(back.mTime, back.mOrbits);
+        back.mTickEnd.store(tick);
+        buffers.Publish(back);
+
+        const auto published = Clock::now();
+        latencyMs[tick] = std::chrono::duration<double, std::milli>(published - scheduled).count();
+        if (published > scheduled + period)
+        {
+            ++stats.mMissedDeadlines;
+        }
+
+        // Every satellite moves some metres in any tick, so a tick where none did repeated the last one's time.
+        // The previous snapshot is only written again after a later BeginWrite().
+        if ((previous != nullptr) && !PositionsMoved(previous->mOrbits, back.mOrbits))
+        {
+            ++stats.mStaleTicks;
+        }
+        previous = &back;
+    }
+
+    stop.store(true);
+    for (std::thread& reader : readers)
+    {
+        reader.join();
+    }
+
+    stats.mTicks = inTicks;
+    stats.mTrains = trains.GetTrainCount();
+    stats.mTrainUpdates = trainCounts.mUpdates;
+    stats.mTrainEvents = trainCounts.mEvents;
+    stats.mTrainMaxMs = trainCounts.mMaxMs;
+    for (const ReaderCounts& counts : readerCounts)
+    {
+        stats.mSnapshotsRead += counts.mReads;
+        stats.mTornReads += counts.mTorn;
+    }
+    if (!latencyMs.empty())
+    {
+        // Nearest rank percentiles
+        std::sort(latencyMs.begin(), latencyMs.end());
+        auto percentile = [&latencyMs](double inPercent) -> double
+        {
+            const std::size_t rank = static_cast<std::size_t>(std::ceil(inPercent / 100.0 * static_cast<double>(latencyMs.size())));
+            return latencyMs[std::clamp<std::size_t>(rank, 1, latencyMs.size()) - 1];
+        };
+        stats.mP50Ms = percentile(50.0);
+        stats.mP90Ms = percentile(90.0);
+        stats.mP99Ms = percentile(99.0);
+        stats.mMaxMs = latencyMs.back();
+    }
+    return stats;
+}
+
+std::vector<double> SatOrbitSingle::OnGetThreadBusyMs() const
+{
+    return mBusyMs;
+}
+
+void SatOrbitSingle::CollectOrbitalData(const std::vector<sat355::TLE>& inTLEVector, std::vector<app355::OrbitalData>& ioOrbitalVector) const
 {
-    return inLHS.GetTLE().GetMeanMotion() < inRHS.GetTLE().GetMeanMotion();
+    ioOrbitalVector.reserve(ioOrbitalVector.size() + inTLEVector.size());
+    AppendOrbitalData(mOrbits, inTLEVector, 0, inTLEVector.size(), ioOrbitalVector);
 }
 
 #pragma endregion {}
@@ -227,49 +2614,174 @@ class SatOrbitMulti : public SatOrbitSingle
 // Interface
 public:
     SatOrbitMulti(std::size_t inNumThreads) :
-        mNumThreads{inNumThreads}
+        mNumThreads{std::max<std::size_t>(inNumThreads, 1)},
+        mPool{mNumThreads},
+        mBuffers(mNumThreads)
     {
-        // Do nothing
+        mChunkCount = mNumThreads * kChunksPerThread;
     }
     ~SatOrbitMulti() override = default;
     static std::unique_ptr<SatOrbitMulti> Make(std::size_t inThreads = 4);
 
 // Types
 private:
-    using tle_const_iterator = std::vector<sat355::TLE>::const_iterator;
     using IteratorPairVector = std::vector<std::tuple<orbit_iterator, orbit_iterator>>;
 
+    // Enough lists that the last ones handed out are small next to a thread's share
+    static constexpr std::size_t kChunksPerThread = 8;
+
+    // Below this many records per thread, sorting on one thread is faster than splitting
+    static constexpr std::size_t kMinSortRun = 2048;
+
+    // Written only by its own worker; aligned so that two workers never share a cache line
+    struct alignas(kCacheLineSize) WorkerBuffer
+    {
+        std::vector<app355::OrbitalData> mOrbitalVector{};
+        double mBusyMs{0.0};
+    };
+
 // Implementation
 private:
     // SatOrbit
-    void OnCalculateOrbitalDataAsync(const std::vector<sat355::TLE>& inTLEVector, std::shared_ptr<OrbitalDataVector> ioDataVector) override;
     void OnSortOrbitalVectorAsync(std::shared_ptr<OrbitalDataVector> ioDataVector) override;
 
+    // SatOrbitSingle
+    void PropagateOrbits(double inTime, OrbitArrays& ioOrbits) override;
+    void PropagateWorkLists(const std::vector<sat355::TLE>& inTLEVector, long long inTime, std::vector<app355::OrbitalData>& outOrbitalVector) override;
+    void PropagateTimes(OrbitalMatrix& ioMatrix) override;
+    void RunTasks(std::size_t inCount, FunctionRef<void(std::size_t)> inTask) override;
+    std::size_t GetTaskThreadCount() const override;
+
     // SatOrbitMulti
-    virtual void OnCalculateOrbitalDataMulti(const tle_const_iterator& inTleBegin, const tle_const_iterator& inTleEnd, std::shared_ptr<OrbitalDataVector> ioDataVector);
+    /// @brief Calls inPropagate for every list in mWorkLists, on the pool, most expensive list first. Fills mBusyMs.
+    void RunWorkLists(FunctionRef<void(WorkList&)> inPropagate);
     virtual void OnSortOrbitalVectorMulti(orbit_iterator& inBegin, orbit_iterator& inEnd);
-    virtual void OnSortMergeVectorMulti(orbit_iterator& ioBegin, orbit_iterator& ioMid, orbit_iterator& ioEnd);
 
 // Data Members
 private:
     std::size_t mNumThreads{0};
+    ThreadPool mPool;
+    std::vector<WorkerBuffer> mBuffers{};   // one per pool thread
+    std::vector<std::size_t> mOrder{};      // mWorkLists indices, most expensive first
 };
 
-std::unique_ptr<SatOrbitMulti> SatOrbitMulti::Make(std::size_t inThreads)
-{
-    auto satOrbit = std::make_unique<SatOrbitMulti>(inThreads);
-    return satOrbit;
+std::unique_ptr<SatOrbitMulti> SatOrbitMulti::Make(std::size_t inThreads)
+{
+    auto satOrbit = std::make_unique<SatOrbitMulti>(inThreads);
+    return satOrbit;
+}
+
+// SatOrbitSingle
+void SatOrbitMulti::PropagateOrbits(double inTime, OrbitArrays& ioOrbits)
+{
+    // Each list scatters to its own catalog indices, so threads never write the same element of ioOrbits
+    RunWorkLists([inTime, &ioOrbits](WorkList& ioWorkList)
+    {
+        ioWorkList.Propagate(inTime, ioOrbits);
+    });
+}
+
+void SatOrbitMulti::PropagateTimes(OrbitalMatrix& ioMatrix)
+{
+    // As PropagateOrbits(), each list writing only its own satellites' rows
+    RunWorkLists([&ioMatrix](WorkList& ioWorkList)
+    {
+        ioWorkList.PropagateTimes(ioMatrix);
+    });
+}
+
+void SatOrbitMulti::RunTasks(std::size_t inCount, FunctionRef<void(std::size_t)> inTask)
+{
+    // Threads take the next task as they come free
+    std::atomic<std::size_t> next{0};
+    mPool.Run([inCount, &inTask, &next](std::size_t)
+    {
+        for (std::size_t n = next.fetch_add(1); n < inCount; n = next.fetch_add(1))
+        {
+            inTask(n);
+        }
+    });
+}
+
+std::size_t SatOrbitMulti::GetTaskThreadCount() const
+{
+    return mPool.GetThreadCount();
+}
+
+void SatOrbitMulti::RunWorkLists(FunctionRef<void(WorkList&)> inPropagate)
+{
+    // Longest lists first, by the time each took last tick, then threads take the next list as they come free.
+    // Whichever thread draws a slow list simply takes fewer of the small ones at the end.
+    mOrder.resize(mWorkLists.size());
+    std::iota(mOrder.begin(), mOrder.end(), std::size_t{0});
+    std::sort(mOrder.begin(), mOrder.end(), [this](std::size_t inLHS, std::size_t inRHS) -> bool
+    {
+        return mWorkLists[inLHS].GetCostNs() > mWorkLists[inRHS].GetCostNs();
+    });
+
+    std::atomic<std::size_t> next{0};
+    mPool.Run([this, &inPropagate, &next](std::size_t inThread)
+    {
+        Timer busyTimer{};
+        busyTimer.Start();
+        for (std::size_t n = next.fetch_add(1); n < mOrder.size(); n = next.fetch_add(1))
+        {
+            inPropagate(mWorkLists[mOrder[n]]);
+        }
+        mBuffers[inThread].mBusyMs = busyTimer.Stop();
+    });
+
+    mBusyMs.clear();
+    for (const WorkerBuffer& buffer : mBuffers)
+    {
+        mBusyMs.push_back(buffer.mBusyMs);
+    }
 }
 
- // SatOrbit
-void SatOrbitMulti::OnCalculateOrbitalDataAsync(const std::vector<sat355::TLE>& inTLEVector, std::shared_ptr<OrbitalDataVector> ioDataVector)
+void SatOrbitMulti::PropagateWorkLists(const std::vector<sat355::TLE>& inTLEVector, long long inTime, std::vector<app355::OrbitalData>& outOrbitalVector)
 {
-    OnCalculateOrbitalDataMulti(inTLEVector.begin(), inTLEVector.end(), std::move(ioDataVector));
+    PropagateOrbits(inTime, mOrbits);
+
+    // Then each thread collects an equal slice of the catalog into its own buffer, without taking a lock.
+    // Concatenated in thread order, the buffers are in catalog order.
+    mPool.Run([this, &inTLEVector](std::size_t inThread)
+    {
+        Timer busyTimer{};
+        busyTimer.Start();
+        WorkerBuffer& buffer = mBuffers[inThread];
+        const std::size_t count = inTLEVector.size();
+        const std::size_t begin = count * inThread / mBuffers.size();
+        const std::size_t end = count * (inThread + 1) / mBuffers.size();
+        buffer.mOrbitalVector.clear();
+        AppendOrbitalData(mOrbits, inTLEVector, begin, end, buffer.mOrbitalVector);
+        buffer.mBusyMs += busyTimer.Stop();
+    });
+
+    std::size_t total = outOrbitalVector.size();
+    mBusyMs.clear();
+    for (const WorkerBuffer& buffer : mBuffers)
+    {
+        total += buffer.mOrbitalVector.size();
+        mBusyMs.push_back(buffer.mBusyMs);
+    }
+    outOrbitalVector.reserve(total);
+    for (WorkerBuffer& buffer : mBuffers)
+    {
+        outOrbitalVector.insert(outOrbitalVector.end(), std::make_move_iterator(buffer.mOrbitalVector.begin()), std::make_move_iterator(buffer.mOrbitalVector.end()));
+    }
 }
 
+// SatOrbit
 void SatOrbitMulti::OnSortOrbitalVectorAsync(std::shared_ptr<OrbitalDataVector> ioDataVector)
 {
     auto& [mutex, orbitalVector] = *ioDataVector;
+    // The keys are small enough that one thread sorts them faster than the records can be split
+    if (mSortKind != SortKind::kRecords)
+    {
+        SortByKey(orbitalVector);
+        return;
+    }
+
     // Multithreaded sort
     auto begin = orbitalVector.begin();
     auto end = orbitalVector.end();
@@ -277,89 +2789,53 @@ void SatOrbitMulti::OnSortOrbitalVectorAsync(std::shared_ptr<OrbitalDataVector>
 }
 
 // SatOrbitMulti
-void SatOrbitMulti::OnCalculateOrbitalDataMulti(const tle_const_iterator& inTleBegin, const tle_const_iterator& inTleEnd, std::shared_ptr<OrbitalDataVector> ioDataVector)
+void SatOrbitMulti::OnSortOrbitalVectorMulti(orbit_iterator& inBegin, orbit_iterator& inEnd)
 {
-    const auto size = static_cast<std::size_t>(std::distance(inTleBegin, inTleEnd));
-    std::vector<app355::OrbitalData> orbitalVector{};
-    orbitalVector.reserve(size);
-    std::for_each(inTleBegin, inTleEnd, [&](const sat355::TLE& inTLE)
-    {
-        double out_tleage = 0.0;
-        double out_latdegs = 0.0;
-        double out_londegs = 0.0;
-        double out_altkm = 0.0;
-
-        // Update TLE list with web address
-        // https://celestrak.org/NORAD/elements/gp.php?NAME=Starlink&FORMAT=TLE
-        // get current time as a long long in seconds
-        
-        long long testTime = time(nullptr);
-        //long long testTime = 1705781559; // Time TLEs stored in StarlinkTLE.txt were recorded
-
-        int result = orbit_to_lla(testTime, inTLE.GetName().data(), inTLE.GetLine1().data(), inTLE.GetLine2().data(), &out_tleage, &out_latdegs, &out_londegs, &out_altkm);
-        if (result == 0)
-        {
-            // Warning! Cannot use tle anymore as it has been moved!
-            app355::OrbitalData data(inTLE, out_latdegs, out_londegs, out_altkm);
-            orbitalVector.push_back(std::move(data));
-        }
-    });
+    const std::size_t threadCount = mPool.GetThreadCount();
+    const std::size_t count = static_cast<std::size_t>(std::distance(inBegin, inEnd));
+    const std::size_t runCount = std::min(threadCount, count / kMinSortRun);
 
-    auto& [mutex, outputVector] = *ioDataVector; // C++17 Structured Binding simplifies tuple unpacking
-    // Use mutex to protect access to the list
+    // Split into one run per thread
+    IteratorPairVector runs{};
+    for (std::size_t run = 0; run < runCount; ++run)
     {
-        std::lock_guard<std::mutex> lock(mutex);
-        outputVector.insert(outputVector.end(), orbitalVector.begin(), orbitalVector.end());
+        runs.emplace_back(inBegin + static_cast<std::ptrdiff_t>(count * run / runCount),
+                          inBegin + static_cast<std::ptrdiff_t>(count * (run + 1) / runCount));
+    }
+    if (runs.size() < 2)
+    {
+        std::sort(inBegin, inEnd, [](const app355::OrbitalData& inLHS, const app355::OrbitalData& inRHS) -> bool
+        {
+            return SortPredicate(inLHS, inRHS);
+        });
+        return;
     }
-}
 
-void SatOrbitMulti::OnSortOrbitalVectorMulti(orbit_iterator& inBegin, orbit_iterator& inEnd)
-{
-    // Sort by mean motion
-    std::sort(inBegin, inEnd, [](const app355::OrbitalData& inLHS, const app355::OrbitalData& inRHS) -> bool
+    // Sort by mean motion, each thread its own run
+    mPool.Run([&runs](std::size_t inThread)
     {
-        return SortPredicate(inLHS, inRHS);
+        if (inThread < runs.size())
+        {
+            auto& [begin, end] = runs[inThread];
+            std::sort(begin, end, [](const app355::OrbitalData& inLHS, const app355::OrbitalData& inRHS) -> bool
+            {
+                return SortPredicate(inLHS, inRHS);
+            });
+        }
     });
-}
 
-void SatOrbitMulti::OnSortMergeVectorMulti(orbit_iterator& ioBegin, orbit_iterator& ioMid, orbit_iterator& ioEnd)
-{
-    std::inplace_merge(ioBegin, ioMid, ioEnd, [](const app355::OrbitalData& inLHS, const app355::OrbitalData& inRHS) -> bool
+    // Then merge them, every level on every thread
+    std::vector<std::size_t> bounds{};
+    for (const auto& [begin, end] : runs)
     {
-        return SortPredicate(inLHS, inRHS);
-    });
+        bounds.push_back(static_cast<std::size_t>(std::distance(inBegin, begin)));
+    }
+    bounds.push_back(count);
+    MergeRuns(&*inBegin, std::move(bounds));
 }
 
 #pragma endregion{}
 
-//----------------------------------------
-#pragma region Timer
-
-class Timer
-{
-public:
-    Timer() = default;
-    void Start();
-    double Stop();
-
-private:
-    std::chrono::time_point<std::chrono::high_resolution_clock> mStart{};
-    std::chrono::time_point<std::chrono::high_resolution_clock> mEnd{};
-    std::chrono::duration<double, std::milli> mElapsedMs{};
-};
-
-void Timer::Start()
-{
-    mStart = std::chrono::high_resolution_clock::now();
-}
-
-double Timer::Stop()
-{
-    mEnd = std::chrono::high_resolution_clock::now();
-    mElapsedMs = mEnd - mStart;
-    return mElapsedMs.count();
-}
-#pragma endregion {}
 } // anonymous namespace
 
 // All methods declared within a namespace in .hpp should be defined within the same namespace in .cpp
@@ -368,10 +2844,10 @@ namespace app355 {
 #pragma region SatOrbit
 
 // Public Non-Virtual Interface
-std::unique_ptr<SatOrbit> SatOrbit::Make(SatOrbitKind inKind)
+std::unique_ptr<SatOrbit> SatOrbit::Make(SatOrbitKind inKind, std::size_t inThreadCount)
 {
     std::unique_ptr<SatOrbit> result = nullptr;
-    const std::size_t coreCount = std::thread::hardware_concurrency();
+    const std::size_t coreCount = (inThreadCount > 0) ? inThreadCount : std::max(std::thread::hardware_concurrency(), 1u);
 
     switch (inKind)
     {
@@ -395,12 +2871,32 @@ std::vector<sat355::TLE> SatOrbit::ReadFromFile(int inArgc, char* inArgv[])
 }
 
 std::shared_ptr<SatOrbit::OrbitalDataVector> SatOrbit::CalculateOrbitalData(const std::vector<sat355::TLE>& inTleVector)
+{
+    return CalculateOrbitalData(inTleVector, time(nullptr));
+}
+
+std::shared_ptr<SatOrbit::OrbitalDataVector> SatOrbit::CalculateOrbitalData(const std::vector<sat355::TLE>& inTleVector, long long inTime)
 {
     auto dataVector = std::make_shared<OrbitalDataVector>();
-    OnCalculateOrbitalDataAsync(inTleVector, dataVector);
+    OnCalculateOrbitalDataAsync(inTleVector, inTime, dataVector);
     return dataVector;
 }
 
+SatOrbit::OrbitalMatrix SatOrbit::CalculateOrbitalData(const std::vector<sat355::TLE>& inTleVector, const std::vector<long long>& inTimes)
+{
+    return OnCalculateOrbitalMatrix(inTleVector, inTimes);
+}
+
+void SatOrbit::SetSortKind(SortKind inKind)
+{
+    OnSetSortKind(inKind);
+}
+
+void SatOrbit::SetTrainKind(TrainKind inKind)
+{
+    OnSetTrainKind(inKind);
+}
+
 void SatOrbit::SortOrbitalVector(std::shared_ptr<OrbitalDataVector> ioDataVector)
 {
     OnSortOrbitalVectorAsync(std::move(ioDataVector));
@@ -408,20 +2904,418 @@ void SatOrbit::SortOrbitalVector(std::shared_ptr<OrbitalDataVector> ioDataVector
     // need to bump the ref count again; therefore move to keep refcount at 2
 }
 
-std::vector<std::vector<OrbitalData>> SatOrbit::CreateTrains(const std::vector<OrbitalData>& inOrbitalVector)
+TrainTable SatOrbit::CreateTrains(const std::vector<OrbitalData>& inOrbitalVector)
 {
     return OnCreateTrains(inOrbitalVector);
 }
 
-void SatOrbit::PrintTrains(const std::vector<std::vector<OrbitalData>>& inTrainVector)
+void SatOrbit::PrintTrains(const std::vector<OrbitalData>& inOrbitalVector, const TrainTable& inTrains)
+{
+    OnPrintTrains(inOrbitalVector, inTrains);
+}
+
+std::vector<double> SatOrbit::GetThreadBusyMs() const
+{
+    return OnGetThreadBusyMs();
+}
+
+SatOrbit::TrackingStats SatOrbit::Track(const std::vector<sat355::TLE>& inTleVector, double inRateHz, std::size_t inTicks, std::size_t inReaderCount)
+{
+    return OnTrack(inTleVector, inRateHz, inTicks, inReaderCount);
+}
+
+std::future<std::vector<sat355::TLE>> SatOrbit::ReadFromFileAsync(int inArgc, char* inArgv[])
 {
-    OnPrintTrains(inTrainVector);
+    return std::async(std::launch::async, [this, inArgc, inArgv]() -> std::vector<sat355::TLE>
+    {
+        return ReadFromFile(inArgc, inArgv);
+    });
+}
+
+std::future<std::shared_ptr<SatOrbit::OrbitalDataVector>> SatOrbit::CalculateOrbitalDataAsync(std::shared_future<std::vector<sat355::TLE>> inTleFuture)
+{
+    return std::async(std::launch::async, [this, tleFuture = std::move(inTleFuture)]() -> std::shared_ptr<OrbitalDataVector>
+    {
+        // The work lists are reused only if the TLEs match the ones they were made from
+        return CalculateOrbitalData(tleFuture.get());
+    });
+}
+
+std::future<std::shared_ptr<SatOrbit::OrbitalDataVector>> SatOrbit::SortOrbitalVectorAsync(std::future<std::shared_ptr<OrbitalDataVector>> inDataFuture)
+{
+    return std::async(std::launch::async, [this, dataFuture = std::move(inDataFuture)]() mutable -> std::shared_ptr<OrbitalDataVector>
+    {
+        std::shared_ptr<OrbitalDataVector> dataVector = dataFuture.get();
+        SortOrbitalVector(dataVector);
+        return dataVector;
+    });
+}
+
+std::future<SatOrbit::SortedTrains> SatOrbit::CreateTrainsAsync(std::future<std::shared_ptr<OrbitalDataVector>> inSortedFuture)
+{
+    return std::async(std::launch::async, [this, sortedFuture = std::move(inSortedFuture)]() mutable -> SortedTrains
+    {
+        SortedTrains sortedTrains{};
+        sortedTrains.mOrbitalData = sortedFuture.get();
+        sortedTrains.mTrains = CreateTrains(std::get<1>(*sortedTrains.mOrbitalData));
+        return sortedTrains;
+    });
+}
+
+std::future<SatOrbit::PipelineResult> SatOrbit::RunPipelineAsync(int inArgc, char* inArgv[], std::size_t inBatchSize)
+{
+    return std::async(std::launch::async, [this, inArgc, inArgv, inBatchSize]() -> PipelineResult
+    {
+        return OnRunPipeline(inArgc, inArgv, inBatchSize);
+    });
 }
 
 #pragma endregion {}
 
 } // namespace app355
 
+//----------------------------------------
+#pragma region Benchmarks
+
+namespace /*anonymous*/ {
+
+/// @brief Prints the time CalculateOrbitalData() takes with 1 to hardware_concurrency() threads, best of several runs
+void PrintSpeedupTable(const std::vector<sat355::TLE>& inTleVector)
+{
+    constexpr int kRuns = 5;
+    const std::size_t maxThreads = std::max(std::thread::hardware_concurrency(), 1u);
+
+    std::cout << "Threads  Calculate (ms)  Speedup  Slowest/mean thread" << std::endl;
+    double baseMs = 0.0;
+    for (std::size_t threads = 1; threads <= maxThreads; ++threads)
+    {
+        auto satOrbit = app355::SatOrbit::Make(app355::SatOrbit::SatOrbitKind::kMulti, threads);
+
+        // The first run partitions the catalog and measures each list's cost
+        satOrbit->CalculateOrbitalData(inTleVector);
+
+        double bestMs = 0.0;
+        double balance = 1.0;
+        for (int run = 0; run < kRuns; ++run)
+        {
+            Timer timer{};
+            timer.Start();
+            satOrbit->CalculateOrbitalData(inTleVector);
+            const double ms = timer.Stop();
+            if ((run == 0) || (ms < bestMs))
+            {
+                bestMs = ms;
+                const std::vector<double> busyMs{satOrbit->GetThreadBusyMs()};
+                const double meanMs = std::accumulate(busyMs.begin(), busyMs.end(), 0.0) / static_cast<double>(busyMs.size());
+                balance = (meanMs > 0.0) ? *std::max_element(busyMs.begin(), busyMs.end()) / meanMs : 1.0;
+            }
+        }
+        if (threads == 1)
+        {
+            baseMs = bestMs;
+        }
+        std::cout << std::setw(7) << threads << std::setw(16) << bestMs << std::setw(9) << (baseMs / bestMs) << std::setw(21) << balance << std::endl;
+    }
+}
+
+/// @brief Times each way SortOrbitalVector() can sort: std::sort on the records, the multi-threaded
+/// merge sort, and the key-index sort with std::sort and with radix sort of the keys, on the
+/// catalog's orbital data repeated and shuffled to each size. The merge sort only runs with
+/// SortKind::kRecords, so this is where it is exercised; it is checked against std::sort.
+void PrintSortBenchmark(const std::vector<sat355::TLE>& inTleVector)
+{
+    using OrbitalDataVector = app355::SatOrbit::OrbitalDataVector;
+
+    using SortKind = app355::SatOrbit::SortKind;
+
+    auto single = app355::SatOrbit::Make(app355::SatOrbit::SatOrbitKind::kSingle);
+    auto multi = app355::SatOrbit::Make(app355::SatOrbit::SatOrbitKind::kMulti);
+    multi->SetSortKind(SortKind::kRecords);
+    const auto catalogData = single->CalculateOrbitalData(inTleVector);
+    const std::vector<app355::OrbitalData>& catalog = std::get<1>(*catalogData);
+    if (catalog.empty())
+    {
+        return;
+    }
+
+    // Mean motions in sorted order, of the last sort timed
+    std::vector<double> sortedKeys{};
+    auto timeSort = [&sortedKeys](app355::SatOrbit& inSatOrbit, const std::vector<app355::OrbitalData>& inRecords) -> double
+    {
+        auto dataVector = std::make_shared<OrbitalDataVector>();
+        std::get<1>(*dataVector) = inRecords;
+        Timer timer{};
+        timer.Start();
+        inSatOrbit.SortOrbitalVector(dataVector);
+        const double ms = timer.Stop();
+
+        sortedKeys.clear();
+        for (const app355::OrbitalData& record : std::get<1>(*dataVector))
+        {
+            sortedKeys.push_back(record.GetMeanMotion());
+        }
+        return ms;
+    };
+
+    std::cout << "Records  std::sort (ms)  Parallel (ms)  Key-index (ms)  Radix (ms)  Same" << std::endl;
+    std::mt19937 random{355};
+    for (const std::size_t size : {std::size_t{6000}, std::size_t{60000}, std::size_t{600000}})
+    {
+        std::vector<app355::OrbitalData> records{};
+        records.reserve(size);
+        for (std::size_t i = 0; i < size; ++i)
+        {
+            records.push_back(catalog[i % catalog.size()]);
+        }
+        std::shuffle(records.begin(), records.end(), random);
+
+        single->SetSortKind(SortKind::kRecords);
+        const double singleMs = timeSort(*single, records);
+        const std::vector<double> expectKeys{sortedKeys};
+        const double multiMs = timeSort(*multi, records);
+        const bool same = (sortedKeys == expectKeys);
+        single->SetSortKind(SortKind::kKeyIndex);
+        const double keyIndexMs = timeSort(*single, records);
+        single->SetSortKind(SortKind::kRadix);
+        const double radixMs = timeSort(*single, records);
+        std::cout << std::setw(7) << size << std::setw(16) << singleMs << std::setw(15) << multiMs << std::setw(16) << keyIndexMs << std::setw(12) << radixMs << std::setw(6) << (same ? "yes" : "NO") << std::endl;
+    }
+}
+
+/// @brief Builds a synthetic catalog of inTrainCount trains of 4 to 6 satellites each, copies of inSample with the
+/// inclination and mean motion of line 2 replaced, sorted by mean motion. Trains are 0.0004 rev/day apart, so each
+/// is within the 0.001 merge distance of its neighbours and the merges chain.
+std::vector<app355::OrbitalData> MakeSyntheticTrains(const sat355::TLE& inSample, std::size_t inTrainCount, std::mt19937& ioRandom)
+{
+    const std::string name{inSample.GetName()};
+    const std::string line1{inSample.GetLine1()};
+    const std::string line2{inSample.GetLine2()};
+    auto makeTLE = [&name, &line1, &line2](double inInclination, double inMeanMotion) -> sat355::TLE
+    {
+        // Line 2 columns 9-16 and 53-63; the library does not check the checksum
+        std::string line = line2;
+        char field[16]{};
+        std::snprintf(field, sizeof(field), "%8.4f", inInclination);
+        line.replace(8, 8, field);
+        std::snprintf(field, sizeof(field), "%11.8f", inMeanMotion);
+        line.replace(52, 11, field);
+        return sat355::TLE{name, line1, line};
+    };
+
+    constexpr double kInclinations[] = {43.0, 53.0, 70.0, 97.6};
+    std::uniform_int_distribution<std::size_t> members{4, 6};
+    std::uniform_int_distribution<std::size_t> shell{0, 3};
+    std::uniform_real_distribution<double> jitter{-0.00005, 0.00005};
+    std::uniform_real_distribution<double> spread{-0.00002, 0.00002};
+    std::uniform_real_distribution<double> longitude{-180.0, 180.0};
+
+    std::vector<app355::OrbitalData> records{};
+    records.reserve(inTrainCount * 6);
+    for (std::size_t train = 0; train < inTrainCount; ++train)
+    {
+        const double meanMotion = 11.0 + 0.0004 * static_cast<double>(train) + jitter(ioRandom);
+        const double inclination = kInclinations[shell(ioRandom)];
+        for (std::size_t n = members(ioRandom); n > 0; --n)
+        {
+            records.emplace_back(makeTLE(inclination, meanMotion + spread(ioRandom)), 0.0, longitude(ioRandom), 550.0);
+        }
+    }
+    std::sort(records.begin(), records.end(), [](const app355::OrbitalData& inLHS, const app355::OrbitalData& inRHS) -> bool
+    {
+        return inLHS.GetMeanMotion() < inRHS.GetMeanMotion();
+    });
+    return records;
+}
+
+/// @brief Times the train stage on synthetic catalogs of 1k to 20k trains: finding the runs, then merging them with
+/// MergeTrainsPairwise() and with MergeTrains(), and checks that both merges make the same trains
+void PrintTrainBenchmark(const std::vector<sat355::TLE>& inTleVector)
+{
+    if (inTleVector.empty())
+    {
+        return;
+    }
+
+    std::cout << " Trains  Satellites  Runs (ms)  Pairwise (ms)  Sweep (ms)  Merged  Same" << std::endl;
+    std::mt19937 random{355};
+    for (const std::size_t trainCount : {std::size_t{1000}, std::size_t{10000}, std::size_t{20000}})
+    {
+        const std::vector<app355::OrbitalData> records{MakeSyntheticTrains(inTleVector.front(), trainCount, random)};
+
+        Timer timer{};
+        timer.Start();
+        const app355::TrainTable runs{FindTrainRuns(records)};
+        const double runsMs = timer.Stop();
+
+        timer.Start();
+        const app355::TrainTable pairwise{MergeTrainsPairwise(runs, records)};
+        const double pairwiseMs = timer.Stop();
+
+        timer.Start();
+        const app355::TrainTable swept{MergeTrains(runs, records)};
+        const double sweptMs = timer.Stop();
+
+        const bool same = (pairwise.GetMembers() == swept.GetMembers()) && (pairwise.GetOffsets() == swept.GetOffsets());
+        std::cout << std::setw(7) << trainCount << std::setw(12) << records.size() << std::setw(11) << runsMs << std::setw(15) << pairwiseMs
+                  << std::setw(12) << sweptMs << std::setw(8) << swept.GetTrainCount() << std::setw(6) << (same ? "yes" : "NO") << std::endl;
+    }
+}
+
+/// @brief Follows the plane trains with a TrainTracker for inHours of simulated time in steps of inStepSec, from the
+/// newest TLE epoch of the catalog, where the elements still say where the satellites are. A few TLEs are updated
+/// every 100 steps, one of them to another satellite's elements. Every 500 steps, half way between updates, and after
+/// the last step the tracked trains are checked against PropagatedPlaneTrains(). Reports the cost of a step, the
+/// events, and how many of the tracked trains the rebuilds found too.
+void PrintTrainTracking(const std::vector<sat355::TLE>& inTleVector, double inHours, long long inStepSec)
+{
+    constexpr std::size_t kCheckSteps = 500;
+    if (inTleVector.empty() || (inStepSec <= 0))
+    {
+        return;
+    }
+
+    double newestEpoch = 0.0;
+    for (const sat355::TLE& tle : inTleVector)
+    {
+        newestEpoch = std::max(newestEpoch, tle.GetEpoch());
+    }
+    const auto start = static_cast<long long>(newestEpoch);
+    Timer timer{};
+    timer.Start();
+    TrainTracker tracker{inTleVector, start};
+    const double buildMs = timer.Stop();
+    const std::size_t startTrains = tracker.GetTrainCount();
+
+    // Trains are compared as sorted sets of sorted members, so the ones found by both are a set intersection
+    std::vector<sat355::TLE> current{inTleVector};
+    std::size_t checks = 0;
+    std::size_t sameChecks = 0;
+    std::size_t trackedTrains = 0;
+    std::size_t foundTrains = 0;
+    double rebuildMs = 0.0;
+    auto check = [&tracker, &current, &timer, &checks, &sameChecks, &trackedTrains, &foundTrains, &rebuildMs](long long inTime)
+    {
+        timer.Start();
+        std::vector<std::vector<std::size_t>> rebuilt{PropagatedPlaneTrains(current, inTime)};
+        rebuildMs += timer.Stop();
+        std::vector<std::vector<std::size_t>> tracked{tracker.GetTrains()};
+        for (std::vector<std::vector<std::size_t>>* trains : {&rebuilt, &tracked})
+        {
+            for (std::vector<std::size_t>& train : *trains)
+            {
+                std::sort(train.begin(), train.end());
+            }
+            std::sort(trains->begin(), trains->end());
+        }
+        std::vector<std::vector<std::size_t>> both{};
+        std::set_intersection(tracked.begin(), tracked.end(), rebuilt.begin(), rebuilt.end(), std::back_inserter(both));
+        ++checks;
+        sameChecks += (rebuilt == tracked) ? 1 : 0;
+        trackedTrains += tracked.size();
+        foundTrains += both.size();
+    };
+
+    const auto steps = static_cast<std::size_t>(inHours * 3600.0 / static_cast<double>(inStepSec));
+    std::array<std::uint64_t, 4> kindCounts{};
+    std::vector<TrainTracker::Event> events{};
+    double totalMs = 0.0;
+    double maxMs = 0.0;
+    for (std::size_t step = 1; step <= steps; ++step)
+    {
+        // As a feed refresh would: ten satellites re-read with the same elements, one replaced by another's
+        if (step % 100 == 0)
+        {
+            for (std::size_t n = 0; n < 10; ++n)
+            {
+                const std::size_t index = (step + n * 997) % inTleVector.size();
+                tracker.UpdateTLE(index, current[index]);
+            }
+            current[step % inTleVector.size()] = inTleVector[(step * 7919) % inTleVector.size()];
+            tracker.UpdateTLE(step % inTleVector.size(), current[step % inTleVector.size()]);
+        }
+
+        events.clear();
+        const long long stepTime = start + static_cast<long long>(step) * inStepSec;
+        timer.Start();
+        tracker.Advance(static_cast<double>(stepTime), events);
+        const double ms = timer.Stop();
+        totalMs += ms;
+        maxMs = std::max(maxMs, ms);
+        for (const TrainTracker::Event& event : events)
+        {
+            ++kindCounts[static_cast<std::size_t>(event.mKind)];
+        }
+
+        if ((step % kCheckSteps == kCheckSteps / 2) || (step == steps))
+        {
+            check(stepTime);
+        }
+    }
+    if (steps == 0)
+    {
+        check(start);
+    }
+
+    std::cout << "Built " << startTrains << " trains of " << inTleVector.size() << " satellites in " << buildMs << " ms" << std::endl;
+    std::cout << "Steps: " << steps << " of " << inStepSec << " s, mean " << ((steps > 0) ? 1000.0 * totalMs / static_cast<double>(steps) : 0.0)
+              << " us, max " << maxMs << " ms, planes ordered: " << tracker.GetReorderCount() << std::endl;
+    std::cout << "Events: join " << kindCounts[0] << ", leave " << kindCounts[1] << ", split " << kindCounts[2] << ", merge " << kindCounts[3] << std::endl;
+    std::cout << "Rebuilds from propagated positions: " << checks << ", mean " << rebuildMs / static_cast<double>(checks) << " ms, "
+              << foundTrains << " of " << trackedTrains << " tracked trains found, same as tracked: " << sameChecks << " of " << checks << std::endl;
+}
+
+/// @brief Times CalculateOrbitalData() for inCount times inStepSec apart, as one (satellite x time) matrix
+/// and as one call per time, and checks that the two agree
+void PrintEpochBenchmark(const std::vector<sat355::TLE>& inTleVector, std::size_t inCount, long long inStepSec)
+{
+    // A satellite that fails is quarantined for later calls, so each way gets its own SatOrbit
+    auto satOrbit = app355::SatOrbit::Make(app355::SatOrbit::SatOrbitKind::kMulti);
+    auto perTime = app355::SatOrbit::Make(app355::SatOrbit::SatOrbitKind::kMulti);
+    const long long start = time(nullptr);
+    std::vector<long long> times(std::max(inCount, std::size_t{1}));
+    for (std::size_t n = 0; n < times.size(); ++n)
+    {
+        times[n] = start + static_cast<long long>(n) * inStepSec;
+    }
+
+    // The first run partitions the catalog
+    satOrbit->CalculateOrbitalData(inTleVector, std::vector<long long>{start});
+    perTime->CalculateOrbitalData(inTleVector, std::vector<long long>{start});
+
+    Timer timer{};
+    timer.Start();
+    const app355::SatOrbit::OrbitalMatrix matrix{satOrbit->CalculateOrbitalData(inTleVector, times)};
+    const double matrixMs = timer.Stop();
+
+    double maxDiffDegs = 0.0;
+    std::size_t mismatches = 0;
+    double separateMs = 0.0;
+    for (std::size_t n = 0; n < times.size(); ++n)
+    {
+        timer.Start();
+        const app355::SatOrbit::OrbitalMatrix column{perTime->CalculateOrbitalData(inTleVector, std::vector<long long>{times[n]})};
+        separateMs += timer.Stop();
+        for (std::size_t i = 0; i < matrix.mSatelliteCount; ++i)
+        {
+            const std::size_t element = i * times.size() + n;
+            if (matrix.mStatus[element] != column.mStatus[i])
+            {
+                ++mismatches;
+                continue;
+            }
+            maxDiffDegs = std::max({maxDiffDegs, std::abs(matrix.mLatDegs[element] - column.mLatDegs[i]), std::abs(matrix.mLonDegs[element] - column.mLonDegs[i])});
+        }
+    }
+
+    std::cout << inTleVector.size() << " satellites x " << times.size() << " times, " << inStepSec << " s apart" << std::endl;
+    std::cout << "    Matrix: " << matrixMs << " ms, one call per time: " << separateMs << " ms" << std::endl;
+    std::cout << "    Status mismatches: " << mismatches << ", largest Lat/Lon difference: " << maxDiffDegs << " degs" << std::endl;
+}
+
+} // anonymous namespace
+
+#pragma endregion {}
+
 //----------------------------------------
 // Main is the only function in global namespace
 int main(int inArgc, char* inArgv[])
@@ -510,6 +3404,32 @@ int main(int inArgc, char* inArgv[])
     app355::shared_ptr<app355::SatOrbit> out = satOrbit2.lock();
     weakTest = out;
 
+    // app355-cpp <file> --pipeline: run the stages as futures instead, then as the batched pipeline
+    if ((inArgc > 2) && (std::string_view{inArgv[2]} == "--pipeline"))
+    {
+        Timer chainTimer{};
+        chainTimer.Start();
+        std::shared_future<std::vector<sat355::TLE>> tleFuture{satOrbit->ReadFromFileAsync(inArgc, inArgv)};
+        auto trainFuture = satOrbit->CreateTrainsAsync(satOrbit->SortOrbitalVectorAsync(satOrbit->CalculateOrbitalDataAsync(tleFuture)));
+        const app355::SatOrbit::SortedTrains chained{trainFuture.get()};
+        std::cout << "Chained stages: " << chained.mTrains.GetTrainCount() << " trains, latency " << chainTimer.Stop() << " ms" << std::endl;
+
+        app355::SatOrbit::PipelineResult result{satOrbit->RunPipelineAsync(inArgc, inArgv).get()};
+        satOrbit->PrintTrains(std::get<1>(*result.mOrbitalData), result.mTrains);
+        std::cout << "Pipeline: " << result.mTrains.GetTrainCount() << " trains, latency " << result.mLatencyMs << " ms" << std::endl;
+
+        // Both sort stably by mean motion, so the satellites must come out in the same order
+        const std::vector<app355::OrbitalData>& chainedVector = std::get<1>(*chained.mOrbitalData);
+        const std::vector<app355::OrbitalData>& pipelineVector = std::get<1>(*result.mOrbitalData);
+        const bool sameOrder = std::equal(chainedVector.begin(), chainedVector.end(), pipelineVector.begin(), pipelineVector.end(),
+                                          [](const app355::OrbitalData& inLHS, const app355::OrbitalData& inRHS) -> bool
+        {
+            return inLHS.GetTLE().GetName() == inRHS.GetTLE().GetName();
+        });
+        std::cout << "Same order as the chained stages: " << (sameOrder ? "yes" : "no") << std::endl;
+        return 0;
+    }
+
     // meaure time for each section in milliseconds using chrono
     Timer totalTimer{};
     Timer timer{};
@@ -519,21 +3439,97 @@ int main(int inArgc, char* inArgv[])
     std::vector<sat355::TLE> tleVector{satOrbit->ReadFromFile(inArgc, inArgv)};
     std::cout << "Read from file: " << timer.Stop() << " ms" << std::endl;
 
+    // app355-cpp <file> --speedup: time the calculation stage from 1 to N threads instead
+    if ((inArgc > 2) && (std::string_view{inArgv[2]} == "--speedup"))
+    {
+        PrintSpeedupTable(tleVector);
+        return 0;
+    }
+
+    // app355-cpp <file> --track [Hz] [seconds]: refresh the catalog's positions continuously instead
+    if ((inArgc > 2) && (std::string_view{inArgv[2]} == "--track"))
+    {
+        constexpr std::size_t kReaderCount = 2;
+        const double rateHz = (inArgc > 3) ? std::stod(inArgv[3]) : 10.0;
+        const double seconds = (inArgc > 4) ? std::stod(inArgv[4]) : 10.0;
+        const auto ticks = static_cast<std::size_t>(std::max(rateHz * seconds, 1.0));
+
+        const app355::SatOrbit::TrackingStats stats{satOrbit->Track(tleVector, rateHz, ticks, kReaderCount)};
+        std::cout << "Tracked " << tleVector.size() << " satellites at " << rateHz << " Hz for " << stats.mTicks << " ticks" << std::endl;
+        std::cout << "Tick latency p50/p90/p99/max: " << stats.mP50Ms << " / " << stats.mP90Ms << " / " << stats.mP99Ms << " / " << stats.mMaxMs << " ms" << std::endl;
+        std::cout << "Missed deadlines: " << stats.mMissedDeadlines << ", ticks that did not move: " << stats.mStaleTicks << std::endl;
+        std::cout << "Snapshots read: " << stats.mSnapshotsRead << " by " << kReaderCount << " readers, torn: " << stats.mTornReads << std::endl;
+        std::cout << "Trains: " << stats.mTrains << ", updates: " << stats.mTrainUpdates << ", events: " << stats.mTrainEvents
+                  << ", slowest update: " << stats.mTrainMaxMs << " ms" << std::endl;
+        return 0;
+    }
+
+    // app355-cpp <file> --trains [hours] [step seconds]: follow the plane trains over simulated time instead
+    if ((inArgc > 2) && (std::string_view{inArgv[2]} == "--trains"))
+    {
+        const double hours = (inArgc > 3) ? std::stod(inArgv[3]) : 24.0;
+        const long long stepSec = (inArgc > 4) ? std::stoll(inArgv[4]) : 10;
+        PrintTrainTracking(tleVector, hours, stepSec);
+        return 0;
+    }
+
+    // app355-cpp <file> --planes: find the trains plane by plane in the staged run
+    if ((inArgc > 2) && (std::string_view{inArgv[2]} == "--planes"))
+    {
+        satOrbit->SetTrainKind(app355::SatOrbit::TrainKind::kPlane);
+    }
+
+    // app355-cpp <file> --trainbench: time the train stage on synthetic catalogs of 1k to 20k trains instead
+    if ((inArgc > 2) && (std::string_view{inArgv[2]} == "--trainbench"))
+    {
+        PrintTrainBenchmark(tleVector);
+        return 0;
+    }
+
+    // app355-cpp <file> --epochs [count] [step seconds]: evaluate the catalog at several times at once instead
+    if ((inArgc > 2) && (std::string_view{inArgv[2]} == "--epochs"))
+    {
+        const auto count = static_cast<std::size_t>((inArgc > 3) ? std::stoul(inArgv[3]) : 60);
+        const long long stepSec = (inArgc > 4) ? std::stoll(inArgv[4]) : 60;
+        PrintEpochBenchmark(tleVector, count, stepSec);
+        return 0;
+    }
+
+    // app355-cpp <file> --sortbench: time the sort stage at 6k, 60k and 600k records instead
+    if ((inArgc > 2) && (std::string_view{inArgv[2]} == "--sortbench"))
+    {
+        PrintSortBenchmark(tleVector);
+        return 0;
+    }
+
     timer.Start();
     auto dataVector = satOrbit->CalculateOrbitalData(tleVector);
     std::cout << "Calculate orbital data: " << timer.Stop() << " ms" << std::endl;
 
+    // The slowest thread sets the stage time; it should finish close to the mean
+    const std::vector<double> busyMs{satOrbit->GetThreadBusyMs()};
+    for (std::size_t thread = 0; thread < busyMs.size(); ++thread)
+    {
+        std::cout << "    Thread " << thread << " busy: " << busyMs[thread] << " ms" << std::endl;
+    }
+    if (!busyMs.empty())
+    {
+        const double meanMs = std::accumulate(busyMs.begin(), busyMs.end(), 0.0) / static_cast<double>(busyMs.size());
+        const double maxMs = *std::max_element(busyMs.begin(), busyMs.end());
+        std::cout << "    Slowest/mean thread: " << ((meanMs > 0.0) ? maxMs / meanMs : 1.0) << std::endl;
+    }
+
     timer.Start();
     satOrbit->SortOrbitalVector(dataVector);
     std::cout << "Sort orbital list: " << timer.Stop() << " ms" << std::endl;
 
     timer.Start();
     auto& [mutex, orbitalVector] = *dataVector;
-    std::vector<std::vector<app355::OrbitalData>> trainVector{satOrbit->CreateTrains(orbitalVector)};
+    const app355::TrainTable trainTable{satOrbit->CreateTrains(orbitalVector)};
     std::cout << "Create trains: " << timer.Stop() << " ms" << std::endl;
 
     timer.Start();
-    satOrbit->PrintTrains(trainVector);
+    satOrbit->PrintTrains(orbitalVector, trainTable);
     std::cout << "Print trains: " << timer.Stop() << " ms" << std::endl;
     
     std::cout << "Total: " << totalTimer.Stop() << " ms" << std::endl;
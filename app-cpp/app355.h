@@ -8,16 +8,36 @@
 
 // std
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
 #include <chrono>
 #include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <exception>
 #include <filesystem>
 #include <fstream>
+#include <functional>
+#include <future>
+#include <iomanip>
 #include <iostream>
+#include <limits>
 #include <list>
+#include <map>
 #include <mutex>
+#include <numeric>
+#include <queue>
+#include <random>
 #include <string>
+#include <string_view>
 #include <tuple>
+#include <type_traits>
 #include <thread>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 // self
@@ -52,6 +72,13 @@ namespace app355
 
         OrbitalData() = delete;
 
+        // Declared so the declared dtor does not suppress the moves; without them every swap in a sort
+        // copies the TLE through the C API
+        OrbitalData(const OrbitalData&) = default;
+        OrbitalData(OrbitalData&&) noexcept = default;
+        OrbitalData& operator=(const OrbitalData&) = default;
+        OrbitalData& operator=(OrbitalData&&) noexcept = default;
+
         ~OrbitalData() = default;
 
         const sat355::TLE &GetTLE() const
@@ -59,6 +86,12 @@ namespace app355
             return mTLE;
         }
 
+        /// @brief Same as GetTLE().GetMeanMotion(), read once at construction
+        double GetMeanMotion() const
+        {
+            return mMeanMotion;
+        }
+
         double GetLatitude() const
         {
             return mLatitude;
@@ -91,6 +124,112 @@ namespace app355
     };
 #pragma endregion{}
 
+//--------------------------------------------------
+#pragma region class TrainTable
+    /// @brief Trains as index spans into the sorted orbital vector they were made from, so no OrbitalData is copied.
+    /// All members are in one flat array of positions in that vector, train after train, and train n is
+    /// [offset n, offset n + 1) of it. Meaningful only together with that vector.
+    class TrainTable
+    {
+    public:
+        /// @brief One train's positions in the orbital vector, in train order
+        class Members
+        {
+        public:
+            Members(const std::uint32_t* inBegin, const std::uint32_t* inEnd) :
+                mBegin{inBegin},
+                mEnd{inEnd}
+            {
+                // Do nothing
+            }
+
+            const std::uint32_t* begin() const
+            {
+                return mBegin;
+            }
+
+            const std::uint32_t* end() const
+            {
+                return mEnd;
+            }
+
+            std::size_t size() const
+            {
+                return static_cast<std::size_t>(mEnd - mBegin);
+            }
+
+            std::uint32_t operator[](std::size_t inMember) const
+            {
+                return mBegin[inMember];
+            }
+
+        private:
+            const std::uint32_t* mBegin;
+            const std::uint32_t* mEnd;
+        };
+
+        TrainTable() = default;
+
+        /// @brief Takes built arrays; inOffsets starts at 0, ends at inMembers.size() and never decreases
+        TrainTable(std::vector<std::uint32_t> inMembers, std::vector<std::size_t> inOffsets) :
+            mMembers{std::move(inMembers)},
+            mOffsets{std::move(inOffsets)}
+        {
+            assert(!mOffsets.empty() && (mOffsets.front() == 0) && (mOffsets.back() == mMembers.size()));
+        }
+
+        void Reserve(std::size_t inMemberCount, std::size_t inTrainCount)
+        {
+            mMembers.reserve(inMemberCount);
+            mOffsets.reserve(inTrainCount + 1);
+        }
+
+        /// @brief Appends a member to the train being built
+        void AddMember(std::uint32_t inPosition)
+        {
+            mMembers.push_back(inPosition);
+        }
+
+        /// @brief Ends the train being built; one with no members is not a train
+        void EndTrain()
+        {
+            if (mMembers.size() > mOffsets.back())
+            {
+                mOffsets.push_back(mMembers.size());
+            }
+        }
+
+        std::size_t GetTrainCount() const
+        {
+            return mOffsets.size() - 1;
+        }
+
+        std::size_t GetMemberCount() const
+        {
+            return mOffsets.back();
+        }
+
+        Members GetTrain(std::size_t inTrain) const
+        {
+            return Members{mMembers.data() + mOffsets[inTrain], mMembers.data() + mOffsets[inTrain + 1]};
+        }
+
+        const std::vector<std::uint32_t>& GetMembers() const
+        {
+            return mMembers;
+        }
+
+        const std::vector<std::size_t>& GetOffsets() const
+        {
+            return mOffsets;
+        }
+
+    private:
+        std::vector<std::uint32_t> mMembers{};
+        std::vector<std::size_t> mOffsets{0};
+    };
+#pragma endregion{}
+
 //--------------------------------------------------
 #pragma region class SatOrbit
     // abstract base class
@@ -108,12 +247,72 @@ namespace app355
         };
         using OrbitalDataVector = std::tuple<std::mutex, std::vector<OrbitalData>>;
 
+        /// @brief How SortOrbitalVector() puts the orbital data in mean motion order
+        enum class SortKind
+        {
+            kRecords = 0,   // Sort the OrbitalData themselves; in parallel for the multi-threaded implementation
+            kKeyIndex,      // Sort (mean motion, index) pairs, then move each OrbitalData into place once
+            kRadix          // As kKeyIndex, sorting the pairs with an LSD radix sort
+        };
+
+        /// @brief How CreateTrains() finds the trains
+        enum class TrainKind
+        {
+            kMeanMotion = 0,    // Runs of close mean motion and inclination, merged by mean motion and ordered by longitude
+            kPlane              // Orbital planes first, then runs along each plane by argument of latitude
+        };
+
+        /// @brief Summary of a Track() run
+        struct TrackingStats
+        {
+            std::size_t mTicks{0};
+            std::size_t mMissedDeadlines{0};    // ticks published after the next one was due
+            std::size_t mStaleTicks{0};         // ticks whose positions were the same as the tick before
+            double mP50Ms{0.0};                 // tick latency, from the tick's scheduled start to its publication
+            double mP90Ms{0.0};
+            double mP99Ms{0.0};
+            double mMaxMs{0.0};
+            std::uint64_t mSnapshotsRead{0};    // by all reader threads
+            std::uint64_t mTornReads{0};        // snapshots written to while being read; always 0 unless broken
+            std::size_t mTrains{0};             // plane trains after the last tick
+            std::uint64_t mTrainUpdates{0};     // ticks the trains were moved to, on their own thread; a slow update skips ticks
+            std::uint64_t mTrainEvents{0};      // joins, leaves, splits and merges over all updates
+            double mTrainMaxMs{0.0};            // slowest train update
+        };
+
+        /// @brief Positions of every satellite at several times, from CalculateOrbitalData() with a list of times.
+        /// One row per satellite, in catalog (TLE file) order, and one column per time: element
+        /// [satellite * mTimes.size() + n] is that satellite at mTimes[n].
+        struct OrbitalMatrix
+        {
+            std::vector<long long> mTimes{};    // seconds since 1970
+            std::size_t mSatelliteCount{0};
+            std::vector<double> mLatDegs{};
+            std::vector<double> mLonDegs{};
+            std::vector<double> mAltKm{};
+            std::vector<int> mStatus{};         // kOK where the satellite propagated
+        };
+
+        /// @brief Trains together with the sorted orbital data they index into
+        struct SortedTrains
+        {
+            std::shared_ptr<OrbitalDataVector> mOrbitalData{};
+            TrainTable mTrains{};
+        };
+
+        /// @brief Trains made by RunPipelineAsync(), and how long the run took
+        struct PipelineResult : SortedTrains
+        {
+            double mLatencyMs{0.0};     // from opening the file to the trains being built
+        };
+
         // Interface
     public:
         /// @brief Creates a new SatOrbit object
         /// @param inKind Determines whether multithreading or singlethreading is utilized in computation
+        /// @param inThreadCount Threads for the multi-threaded implementation; 0 uses one per hardware thread
         /// @return std::unique_ptr pointing to the newly created SatOrbit object
-        static std::unique_ptr<SatOrbit> Make(SatOrbitKind inKind = SatOrbitKind::kDefault);
+        static std::unique_ptr<SatOrbit> Make(SatOrbitKind inKind = SatOrbitKind::kDefault, std::size_t inThreadCount = 0);
 
         /// @brief Scans the inputted text file for satellite TLE data
         /// @param inArgc The number of arguments passed into main()
@@ -121,25 +320,82 @@ namespace app355
         /// @return Vector of all read TLE data
         std::vector<sat355::TLE> ReadFromFile(int inArgc, char* inArgv[]);
 
-        /// @brief Turns the raw TLE data into latitude, longitude, and altitude
+        /// @brief Turns the raw TLE data into latitude, longitude, and altitude at the current time
         /// @param inTleVector Vector of parsed TLE data
         /// @return Vector of computed orbital data
         //std::vector<OrbitalData> CalculateOrbitalData(const std::vector<sat355::TLE> &inTleVector);
         std::shared_ptr<OrbitalDataVector> CalculateOrbitalData(const std::vector<sat355::TLE>& inTleVector);
+
+        /// @brief As above, with every satellite evaluated at inTime
+        /// @param inTime Evaluation time in seconds since 1970
+        std::shared_ptr<OrbitalDataVector> CalculateOrbitalData(const std::vector<sat355::TLE>& inTleVector, long long inTime);
+
+        /// @brief Latitude, longitude, and altitude of every satellite at each of inTimes. Each satellite is
+        /// propagated to all of the times before the next one, so its model is only loaded once.
+        /// @param inTleVector Vector of parsed TLE data
+        /// @param inTimes Evaluation times in seconds since 1970
+        /// @return (satellite x time) matrix of results
+        OrbitalMatrix CalculateOrbitalData(const std::vector<sat355::TLE>& inTleVector, const std::vector<long long>& inTimes);
         
         /// @brief Sorts the vector of orbital data by their mean motion
         /// @param ioOrbitalVector Vector of unsorted orbital data
         //void SortOrbitalVector(std::vector<OrbitalData> &ioOrbitalVector);
         void SortOrbitalVector(std::shared_ptr<OrbitalDataVector> ioDataVector);
 
+        /// @brief Chooses how SortOrbitalVector() sorts; kRadix unless set
+        void SetSortKind(SortKind inKind);
+
+        // Asynchronous versions of the stages. Each starts on its own thread and waits for its input future,
+        // so a chain of them runs as soon as each input is ready. Run one chain at a time per SatOrbit.
+
+        /// @brief ReadFromFile() on another thread
+        std::future<std::vector<sat355::TLE>> ReadFromFileAsync(int inArgc, char* inArgv[]);
+
+        /// @brief CalculateOrbitalData() once inTleFuture is ready
+        std::future<std::shared_ptr<OrbitalDataVector>> CalculateOrbitalDataAsync(std::shared_future<std::vector<sat355::TLE>> inTleFuture);
+
+        /// @brief SortOrbitalVector() once inDataFuture is ready
+        /// @return The same vector, sorted
+        std::future<std::shared_ptr<OrbitalDataVector>> SortOrbitalVectorAsync(std::future<std::shared_ptr<OrbitalDataVector>> inDataFuture);
+
+        /// @brief CreateTrains() once inSortedFuture is ready
+        /// @return The trains, with the sorted vector they index into
+        std::future<SortedTrains> CreateTrainsAsync(std::future<std::shared_ptr<OrbitalDataVector>> inSortedFuture);
+
+        /// @brief Reads the TLE file and builds its trains as one pipeline: batches of inBatchSize satellites are
+        /// parsed, propagated and sorted concurrently while the file is still being read, then merged in order
+        /// @param inArgc The number of arguments passed into main()
+        /// @param inArgv As for ReadFromFile()
+        /// @param inBatchSize Satellites per batch
+        std::future<PipelineResult> RunPipelineAsync(int inArgc, char* inArgv[], std::size_t inBatchSize = 1024);
+
         /// @brief Satellites in close proximity with a similar orbital path are grouped together, and solo satellites are discarded
         /// @param inOrbitalVector Vector of all sorted orbital data by which the train list is made from
-        /// @return Vector of all satellites which can be grouped into trains, where a train is a vector of satellites
-        std::vector<std::vector<OrbitalData>> CreateTrains(const std::vector<OrbitalData> &inOrbitalVector);
+        /// @return Every train, as the positions in inOrbitalVector of its satellites
+        TrainTable CreateTrains(const std::vector<OrbitalData> &inOrbitalVector);
+
+        /// @brief Chooses how CreateTrains() finds the trains; kMeanMotion unless set
+        void SetTrainKind(TrainKind inKind);
 
         /// @brief Prints all satellite data
-        /// @param inTrainVector Vector of all satellite trains
-        void PrintTrains(const std::vector<std::vector<OrbitalData>> &inTrainVector);
+        /// @param inOrbitalVector The sorted orbital data inTrains was made from
+        /// @param inTrains All satellite trains
+        void PrintTrains(const std::vector<OrbitalData> &inOrbitalVector, const TrainTable &inTrains);
+
+        /// @brief Time each thread spent propagating during the last CalculateOrbitalData()
+        /// @return Busy time in milliseconds, one entry per thread
+        std::vector<double> GetThreadBusyMs() const;
+
+        /// @brief Tracking mode: refreshes the positions of the whole catalog inRateHz times a second. Each tick
+        /// propagates into a preallocated back buffer and publishes it with an atomic exchange, while
+        /// inReaderCount threads keep reading the latest snapshot without locks. One more thread follows the plane
+        /// trains to the time of the latest snapshot.
+        /// @param inTleVector Vector of parsed TLE data
+        /// @param inRateHz Ticks per second
+        /// @param inTicks Number of ticks to run
+        /// @param inReaderCount Reader threads to run alongside
+        /// @return Tick latency percentiles and missed deadlines
+        TrackingStats Track(const std::vector<sat355::TLE>& inTleVector, double inRateHz, std::size_t inTicks, std::size_t inReaderCount);
 
         /// @brief dtor is default, giving access to RO5 methods
         virtual ~SatOrbit() = default;
@@ -156,10 +412,16 @@ namespace app355
     private:
         // SatOrbit
         virtual std::vector<sat355::TLE> OnReadFromFile(int inArgc, char* inArgv[]) = 0;
-        virtual void OnCalculateOrbitalDataAsync(const std::vector<sat355::TLE>& inTLEVector, std::shared_ptr<OrbitalDataVector> ioDataVector) = 0;
+        virtual void OnCalculateOrbitalDataAsync(const std::vector<sat355::TLE>& inTLEVector, long long inTime, std::shared_ptr<OrbitalDataVector> ioDataVector) = 0;
+        virtual OrbitalMatrix OnCalculateOrbitalMatrix(const std::vector<sat355::TLE>& inTLEVector, const std::vector<long long>& inTimes) = 0;
         virtual void OnSortOrbitalVectorAsync(std::shared_ptr<OrbitalDataVector> ioDataVector) = 0;
-        virtual std::vector<std::vector<OrbitalData>> OnCreateTrains(const std::vector<OrbitalData> &inOrbitalVector) = 0;
-        virtual void OnPrintTrains(const std::vector<std::vector<OrbitalData>> &inTrainVector) = 0;
+        virtual void OnSetSortKind(SortKind inKind) = 0;
+        virtual void OnSetTrainKind(TrainKind inKind) = 0;
+        virtual TrainTable OnCreateTrains(const std::vector<OrbitalData> &inOrbitalVector) = 0;
+        virtual void OnPrintTrains(const std::vector<OrbitalData> &inOrbitalVector, const TrainTable &inTrains) = 0;
+        virtual std::vector<double> OnGetThreadBusyMs() const = 0;
+        virtual TrackingStats OnTrack(const std::vector<sat355::TLE>& inTleVector, double inRateHz, std::size_t inTicks, std::size_t inReaderCount) = 0;
+        virtual PipelineResult OnRunPipeline(int inArgc, char* inArgv[], std::size_t inBatchSize) = 0;
     };
 #pragma endregion{}
 } // namespace app355
@@ -48,68 +48,6 @@ cJulian::cJulian(time_t time)
    Initialize(year, day);
 }
 
-//////////////////////////////////////////////////////////////////////////////
-// Create a Julian date object from a year and day of year.
-// Example parameters: year = 2001, day = 1.5 (Jan 1 12h)
-cJulian::cJulian(int year, double day)
-{
-   Initialize(year, day);
-}
-
-//////////////////////////////////////////////////////////////////////////////
-// Create a Julian date object.
-cJulian::cJulian(int year,               // i.e., 2004
-                 int mon,                // 1..12
-                 int day,                // 1..31
-                 int hour,               // 0..23
-                 int min,                // 0..59
-                 double sec /* = 0.0 */) // 0..(59.999999...)
-
-{
-   // Calculate N, the day of the year (1..366)
-   int N;
-   int F1 = (int)((275.0 * mon) / 9.0);
-   int F2 = (int)((mon + 9.0) / 12.0);
-
-   if (IsLeapYear(year))
-   {
-      // Leap year
-      N = F1 - F2 + day - 30;
-   }
-   else
-   {
-      // Common year
-      N = F1 - (2 * F2) + day - 30;
-   }
-   
-   double dblDay = N + (hour + (min + (sec / 60.0)) / 60.0) / 24.0;
-
-   Initialize(year, dblDay);
-}
-
-//////////////////////////////////////////////////////////////////////////////
-void cJulian::Initialize(int year, double day)
-{
-   // 1582 A.D.: 10 days removed from calendar
-   // 3000 A.D.: Arbitrary error checking limit
-   assert((year > 1582) && (year < 3000));
-   assert((day >= 1.0) && (day < 367.0));
-
-   // Calculate Julian date
-
-   year--;
-
-   // Centuries are not leap years unless they divide by 400
-   int A = (year / 100);
-   int B = 2 - A + (A / 4);
-
-   double jan01 = trunc(365.25 * year) +
-                  trunc(30.6001 * 14)  +
-                  1720994.5 + B;  // 1720994.5 = Oct 30, year -1
-
-   m_Date = jan01 + day;
-}
-
 //////////////////////////////////////////////////////////////////////////////
 // GetComponent()
 // Return requested components of date.
@@ -6,6 +6,8 @@
 // Version 01/2013
 //
 #pragma once
+#include <assert.h>
+#include <time.h>
 #include "globals.h"
 
 namespace Zeptomoby 
@@ -15,35 +17,40 @@ namespace OrbitTools
 //
 // See note in cJulian.cpp for information on this class and the epoch dates
 //
-const double EPOCH_JAN0_12H_1900 = 2415020.0; // Dec 31.5 1899 = Dec 31 1899 12h UTC
-const double EPOCH_JAN1_00H_1900 = 2415020.5; // Jan  1.0 1900 = Jan  1 1900 00h UTC
-const double EPOCH_JAN1_12H_2000 = 2451545.0; // Jan  1.5 2000 = Jan  1 2000 12h UTC
+constexpr double EPOCH_JAN0_12H_1900 = 2415020.0; // Dec 31.5 1899 = Dec 31 1899 12h UTC
+constexpr double EPOCH_JAN1_00H_1900 = 2415020.5; // Jan  1.0 1900 = Jan  1 1900 00h UTC
+constexpr double EPOCH_JAN1_12H_2000 = 2451545.0; // Jan  1.5 2000 = Jan  1 2000 12h UTC
 
 //////////////////////////////////////////////////////////////////////////////
 class cJulian  
 {
 public:
-   cJulian() { Initialize(2000, 1); }
+   constexpr cJulian() : m_Date(ToDate(2000, 1.0)) {}
    explicit cJulian(time_t t);              // Create from time_t
-   explicit cJulian(int year, double day);  // Create from year, day of year
-   explicit cJulian(int year,               // i.e., 2004
-                    int mon,                // 1..12
-                    int day,                // 1..31
-                    int hour,               // 0..23
-                    int min,                // 0..59
-                    double sec = 0.0);      // 0..(59.999999...)
-   ~cJulian() {};
+
+   // Create from a Julian date, e.g. one returned by Date()
+   static constexpr cJulian FromDate(double jd) { cJulian date; date.m_Date = jd; return date; }
+
+   constexpr explicit cJulian(int year, double day)   // Create from year, day of year
+      : m_Date(ToDate(year, day)) {}
+   constexpr explicit cJulian(int year,     // i.e., 2004
+                              int mon,      // 1..12
+                              int day,      // 1..31
+                              int hour,     // 0..23
+                              int min,      // 0..59
+                              double sec = 0.0)   // 0..(59.999999...)
+      : m_Date(ToDate(year, mon, day, hour, min, sec)) {}
 
    double ToGmst() const;           // Greenwich Mean Sidereal Time
    double ToLmst(double lon) const; // Local Mean Sidereal Time
    time_t ToTime() const;           // To time_t type - avoid using
 
-   double FromJan0_12h_1900() const { return m_Date - EPOCH_JAN0_12H_1900; }
-   double FromJan1_00h_1900() const { return m_Date - EPOCH_JAN1_00H_1900; }
-   double FromJan1_12h_2000() const { return m_Date - EPOCH_JAN1_12H_2000; }
+   constexpr double FromJan0_12h_1900() const { return m_Date - EPOCH_JAN0_12H_1900; }
+   constexpr double FromJan1_00h_1900() const { return m_Date - EPOCH_JAN1_00H_1900; }
+   constexpr double FromJan1_12h_2000() const { return m_Date - EPOCH_JAN1_12H_2000; }
 
    void GetComponent(int *pYear, int *pMon = NULL, double *pDOM = NULL) const;
-   double Date() const { return m_Date; }
+   constexpr double Date() const { return m_Date; }
 
    void AddDay (double day) { m_Date += day;                 }
    void AddHour(double hr ) { m_Date += (hr  / HR_PER_DAY ); }
@@ -55,13 +62,76 @@ public:
    double SpanMin (const cJulian& b) const { return SpanDay(b) * MIN_PER_DAY; }
    double SpanSec (const cJulian& b) const { return SpanDay(b) * SEC_PER_DAY; }
 
-   static bool IsLeapYear(int y)
+   static constexpr bool IsLeapYear(int y)
       { return (y % 4 == 0 && y % 100 != 0) || (y % 400 == 0); }
 
+   // Julian date of a year and day of year, or of a calendar date and
+   // time. Usable in constant expressions.
+   static constexpr double ToDate(int year, double day);
+   static constexpr double ToDate(int year, int mon, int day, int hour, int min, double sec = 0.0);
+
 protected:
-   void Initialize(int year, double day);
+   void Initialize(int year, double day) { m_Date = ToDate(year, day); }
 
    double m_Date; // Julian date
 };
+
+//////////////////////////////////////////////////////////////////////////////
+// ToDate()
+// Julian date from a year and day of year.
+// Example parameters: year = 2001, day = 1.5 (Jan 1 12h)
+constexpr double cJulian::ToDate(int year, double day)
+{
+   // 1582 A.D.: 10 days removed from calendar
+   // 3000 A.D.: Arbitrary error checking limit
+   assert((year > 1582) && (year < 3000));
+   assert((day >= 1.0) && (day < 367.0));
+
+   // Calculate Julian date
+
+   year--;
+
+   // Centuries are not leap years unless they divide by 400
+   int A = (year / 100);
+   int B = 2 - A + (A / 4);
+
+   // The casts truncate as trunc() does; both values are positive
+   double jan01 = (double)(long long)(365.25 * year) +
+                  (double)(long long)(30.6001 * 14)  +
+                  1720994.5 + B;  // 1720994.5 = Oct 30, year -1
+
+   return jan01 + day;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// ToDate()
+// Julian date from a calendar date and time.
+constexpr double cJulian::ToDate(int year,   // i.e., 2004
+                                 int mon,    // 1..12
+                                 int day,    // 1..31
+                                 int hour,   // 0..23
+                                 int min,    // 0..59
+                                 double sec /* = 0.0 */) // 0..(59.999999...)
+{
+   // Calculate N, the day of the year (1..366)
+   int N  = 0;
+   int F1 = (int)((275.0 * mon) / 9.0);
+   int F2 = (int)((mon + 9.0) / 12.0);
+
+   if (IsLeapYear(year))
+   {
+      // Leap year
+      N = F1 - F2 + day - 30;
+   }
+   else
+   {
+      // Common year
+      N = F1 - (2 * F2) + day - 30;
+   }
+
+   double dblDay = N + (hour + (min + (sec / 60.0)) / 60.0) / 24.0;
+
+   return ToDate(year, dblDay);
+}
 }
 }
\ No newline at end of file
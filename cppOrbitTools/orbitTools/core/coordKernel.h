@@ -0,0 +1,328 @@
+//
+// coordKernel.h
+//
+// Template versions of the coordinate conversions in coord.cpp, for use
+// by the batch propagation paths. Instantiate with 'double' for results
+// that match cGeo, or with 'float' for "display grade" results.
+//
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include "globals.h"
+#include "coordTypes.h"
+
+namespace Zeptomoby
+{
+namespace OrbitTools
+{
+
+//////////////////////////////////////////////////////////////////////////////
+// EciToGeo()
+// Convert an ECI position (km) to geodetic latitude (radians, negative
+// south), longitude (radians east, 0..2PI) and altitude (km) for the
+// given Greenwich Mean Sidereal Time (radians). Same ellipsoid and
+// results as cGeo::cGeo(const cEci&, cJulian); the GMST is passed in so a
+// batch can compute it once for all objects.
+//
+// Where cGeo iterates on latitude until successive passes agree to
+// 1.0e-07 radian, this uses the closed form of Vermeille (2011): one
+// cube root and a few square roots, no loop and no branches. Latitude
+// and altitude do not depend on the earth's rotation, so only the
+// longitude needs the GMST.
+//
+// 'Earth' picks the ellipsoid at compile time: cWgs72 (the default, as
+// cGeo) or cWgs84.
+template <typename Real, typename Earth = cWgs72>
+inline void EciToGeo(Real x, Real y, Real z, double gmst,
+                     Real *pLat, Real *pLon, Real *pAlt)
+{
+   constexpr Real one   = Real(1.0);
+   constexpr Real a     = Real(Earth::XKMPER);
+   constexpr Real e2    = Real(Earth::F * (2.0 - Earth::F));
+   constexpr Real e4    = Real((Earth::F * (2.0 - Earth::F)) * (Earth::F * (2.0 - Earth::F)));
+   constexpr Real twoPi = Real(TWOPI);
+
+   // Longitude, wrapped to 0..2PI without fmod
+   Real theta = std::atan2(y, x) - Real(gmst);
+   theta -= twoPi * std::floor(theta / twoPi);
+
+   Real rxy2 = x * x + y * y;
+   Real rxy  = std::sqrt(rxy2);
+   Real p    = rxy2 / (a * a);
+   Real q    = (one - e2) * z * z / (a * a);
+   Real r    = (p + q - e4) / Real(6.0);
+   Real s    = e4 * p * q / (Real(4.0) * r * r * r);
+   Real t    = std::cbrt(one + s + std::sqrt(s * (Real(2.0) + s)));
+   Real u    = r * (one + t + one / t);
+   Real v    = std::sqrt(u * u + e4 * q);
+   Real w    = e2 * (u + v - q) / (Real(2.0) * v);
+   Real k    = std::sqrt(u + v + w * w) - w;
+   Real d    = k * rxy / (k + e2);
+   Real dz   = std::sqrt(d * d + z * z);
+
+   *pLat = Real(2.0) * std::atan2(z, d + dz);
+   *pLon = theta;
+   *pAlt = (k + e2 - one) / k * dz;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+template <typename Earth = cWgs72>
+inline Geodetic EciToGeo(const Vec3 &pos, double gmst)
+{
+   Geodetic geo;
+
+   EciToGeo<double, Earth>(pos.m_x, pos.m_y, pos.m_z, gmst, &geo.m_Lat, &geo.m_Lon, &geo.m_Alt);
+
+   return geo;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// EciToGeoBatch()
+// EciToGeo() for 'count' positions given as separate x, y and z arrays,
+// all at one GMST. The loop body has no branches, so the compiler can
+// vectorize it where vector math functions are available. The outputs
+// may alias the inputs (pLat == pX, pLon == pY, pAlt == pZ).
+template <typename Real, typename Earth = cWgs72>
+inline void EciToGeoBatch(const Real *pX, const Real *pY, const Real *pZ,
+                          size_t count, double gmst,
+                          Real *pLat, Real *pLon, Real *pAlt)
+{
+   for (size_t i = 0; i < count; i++)
+   {
+      EciToGeo<Real, Earth>(pX[i], pY[i], pZ[i], gmst, &pLat[i], &pLon[i], &pAlt[i]);
+   }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// EciToEcefBatch()
+// Rotate 'count' ECI positions (km) and velocities (km/sec), in place,
+// into the earth-fixed frame at the given GMST (radians): a rotation of
+// -GMST about the z axis, the same rotation that takes EciToGeo() from
+// right ascension to longitude. No polar motion or equation of the
+// equinoxes is applied. The earth-fixed velocity is relative to the
+// rotating earth, so the earth's rotation is taken out of it. The
+// velocity arrays may be NULL. z and vz are the same in both frames.
+template <typename Real>
+inline void EciToEcefBatch(Real *pX, Real *pY, Real * /* pZ */,
+                           Real *pVx, Real *pVy, Real * /* pVz */,
+                           size_t count, double gmst)
+{
+   const Real sinG  = Real(std::sin(gmst));
+   const Real cosG  = Real(std::cos(gmst));
+   const Real omega = Real(TWOPI * (OMEGA_E / SEC_PER_DAY));   // rad/sec
+
+   for (size_t i = 0; i < count; i++)
+   {
+      Real x =  cosG * pX[i] + sinG * pY[i];
+      Real y = -sinG * pX[i] + cosG * pY[i];
+
+      pX[i] = x;
+      pY[i] = y;
+   }
+
+   if (pVx == NULL)
+   {
+      return;
+   }
+
+   for (size_t i = 0; i < count; i++)
+   {
+      Real vx =  cosG * pVx[i] + sinG * pVy[i];
+      Real vy = -sinG * pVx[i] + cosG * pVy[i];
+
+      pVx[i] = vx + omega * pY[i];
+      pVy[i] = vy - omega * pX[i];
+   }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// cSiteKernel
+// An observer site for batch look angles. The site's earth-fixed position
+// and its local south/east/up frame are evaluated once, when the site is
+// made; SetGmst() turns them into the ECI frame for one time. Same
+// geometry as cSite::GetLookAngle(), which rebuilds the site's ECI
+// position and frame for every target.
+class cSiteKernel
+{
+public:
+   cSiteKernel(double latRad, double lonRad, double altKm);
+
+   // Rotate the site into the ECI frame at the given GMST (radians).
+   void SetGmst(double gmst);
+
+   // Look angle from the site to one target, any elevation.
+   Topocentric LookAngle(const Vec3 &pos, const Vec3 &vel) const;
+
+   // Look angles from the site to 'count' targets at ECI positions (km)
+   // and velocities (km/sec); the velocity arrays may be NULL, giving a
+   // range rate of 0.
+   //
+   // A first pass over all targets needs only dot products and has no
+   // branches; it keeps the targets at or above 'minElRad'. Azimuth,
+   // elevation, range and range rate are then computed for those only.
+   // The index of each kept target goes to pIndex, its azimuth (radians,
+   // 0..2PI), elevation (radians), range (km) and range rate (km/sec,
+   // negative toward the site) to the same position of the other arrays.
+   // Each output array must hold 'count' elements. Returns the number of
+   // targets kept.
+   size_t LookAngles(const double *pX,  const double *pY,  const double *pZ,
+                     const double *pVx, const double *pVy, const double *pVz,
+                     size_t count, double minElRad,
+                     size_t *pIndex, double *pAz, double *pEl,
+                     double *pRange, double *pRate) const;
+
+protected:
+   void Angles(double dx, double dy, double dz,
+               const double *pVx, const double *pVy, const double *pVz,
+               double *pAz, double *pEl, double *pRange, double *pRate) const;
+
+   // Earth-fixed, set once
+   double m_sinLat;   double m_cosLat;
+   double m_Lon;      double m_achcp;    double m_z;
+
+   // ECI at the last SetGmst(): position, velocity and the south, east
+   // and up unit vectors
+   double m_Pos[3];   double m_Vel[3];
+   double m_S[3];     double m_E[3];     double m_U[3];
+};
+
+//////////////////////////////////////////////////////////////////////////////
+// See cEci::cEci(const cGeo&, cJulian).
+inline cSiteKernel::cSiteKernel(double latRad, double lonRad, double altKm)
+{
+   m_sinLat = std::sin(latRad);
+   m_cosLat = std::cos(latRad);
+   m_Lon    = lonRad;
+
+   double c = 1.0 / std::sqrt(1.0 + F * (F - 2.0) * m_sinLat * m_sinLat);
+   double s = (1.0 - F) * (1.0 - F) * c;
+
+   m_achcp = (XKMPER_WGS72 * c + altKm) * m_cosLat;
+   m_z     = (XKMPER_WGS72 * s + altKm) * m_sinLat;
+
+   SetGmst(0.0);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+inline void cSiteKernel::SetGmst(double gmst)
+{
+   // The site's Local Mean Sidereal Time
+   double theta    = std::fmod(gmst + m_Lon, TWOPI);
+   double sinTheta = std::sin(theta);
+   double cosTheta = std::cos(theta);
+
+   // Velocity due to the earth's rotation
+   const double mfactor = TWOPI * (OMEGA_E / SEC_PER_DAY);
+
+   m_Pos[0] = m_achcp * cosTheta;
+   m_Pos[1] = m_achcp * sinTheta;
+   m_Pos[2] = m_z;
+
+   m_Vel[0] = -mfactor * m_Pos[1];
+   m_Vel[1] =  mfactor * m_Pos[0];
+   m_Vel[2] = 0.0;
+
+   m_S[0] =  m_sinLat * cosTheta;
+   m_S[1] =  m_sinLat * sinTheta;
+   m_S[2] = -m_cosLat;
+
+   m_E[0] = -sinTheta;
+   m_E[1] =  cosTheta;
+   m_E[2] =  0.0;
+
+   m_U[0] = m_cosLat * cosTheta;
+   m_U[1] = m_cosLat * sinTheta;
+   m_U[2] = m_sinLat;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+inline Topocentric cSiteKernel::LookAngle(const Vec3 &pos, const Vec3 &vel) const
+{
+   Topocentric topo;
+
+   Angles(pos.m_x - m_Pos[0], pos.m_y - m_Pos[1], pos.m_z - m_Pos[2], &vel.m_x, &vel.m_y, &vel.m_z,
+          &topo.m_Az, &topo.m_El, &topo.m_Range, &topo.m_RangeRate);
+
+   return topo;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+inline size_t cSiteKernel::LookAngles(const double *pX,  const double *pY,  const double *pZ,
+                                      const double *pVx, const double *pVy, const double *pVz,
+                                      size_t count, double minElRad,
+                                      size_t *pIndex, double *pAz, double *pEl,
+                                      double *pRange, double *pRate) const
+{
+   // Elevation >= minEl is up >= sin(minEl) * range; compared squared so
+   // the first pass needs no square root.
+   const double sinMin  = std::sin(minElRad);
+   const double sinMin2 = sinMin * sinMin;
+   const bool   above   = (minElRad >= 0.0);
+
+   size_t visible = 0;
+
+   for (size_t i = 0; i < count; i++)
+   {
+      double dx = pX[i] - m_Pos[0];
+      double dy = pY[i] - m_Pos[1];
+      double dz = pZ[i] - m_Pos[2];
+      double up = dx * m_U[0] + dy * m_U[1] + dz * m_U[2];
+      double limit = sinMin2 * (dx * dx + dy * dy + dz * dz);
+
+      bool keep = above ? ((up >= 0.0) && (up * up >= limit))
+                        : ((up >= 0.0) || (up * up <= limit));
+
+      pIndex[visible] = i;
+      visible += keep ? 1 : 0;
+   }
+
+   for (size_t n = 0; n < visible; n++)
+   {
+      size_t i = pIndex[n];
+
+      Angles(pX[i] - m_Pos[0], pY[i] - m_Pos[1], pZ[i] - m_Pos[2],
+             (pVx != NULL) ? &pVx[i] : NULL, (pVx != NULL) ? &pVy[i] : NULL, (pVx != NULL) ? &pVz[i] : NULL,
+             &pAz[n], &pEl[n], &pRange[n], &pRate[n]);
+   }
+
+   return visible;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// Angles()
+// Look angle of the target at offset (dx, dy, dz) km from the site, with
+// velocity (*pVx, *pVy, *pVz); pVx may be NULL.
+inline void cSiteKernel::Angles(double dx, double dy, double dz,
+                                const double *pVx, const double *pVy, const double *pVz,
+                                double *pAz, double *pEl, double *pRange, double *pRate) const
+{
+   double range = std::sqrt(dx * dx + dy * dy + dz * dz);
+
+   double topS = dx * m_S[0] + dy * m_S[1] + dz * m_S[2];
+   double topE = dx * m_E[0] + dy * m_E[1];
+   double topZ = dx * m_U[0] + dy * m_U[1] + dz * m_U[2];
+   double az   = std::atan2(topE, -topS);
+
+   if (az < 0.0)
+   {
+      az += TWOPI;
+   }
+
+   double rate = 0.0;
+
+   if (pVx != NULL)
+   {
+      rate = (dx * (*pVx - m_Vel[0]) +
+              dy * (*pVy - m_Vel[1]) +
+              dz * (*pVz - m_Vel[2])) / range;
+   }
+
+   *pAz    = az;
+   *pEl    = std::asin(topZ / range);
+   *pRange = range;
+   *pRate  = rate;
+}
+
+}
+}
@@ -0,0 +1,111 @@
+//
+// coordTypes.h
+//
+// Plain-data counterparts of cVector, cEci/cEciTime, cGeo and cTopo for
+// the batch paths.
+//
+// The legacy classes have virtual destructors, so each object carries a
+// vtable pointer (cVector also carries an unused fourth component), and
+// none of them is trivially copyable: arrays of them are copied object by
+// object and cannot be memcpy'd. These types hold the same values with
+// no vtable and no padding, so arrays of them copy as raw memory and
+// their fields can be split into separate arrays for the kernels in
+// coordKernel.h. Use the To...() functions below to convert.
+//
+#pragma once
+
+#include <type_traits>
+#include "coord.h"
+#include "cEci.h"
+
+namespace Zeptomoby
+{
+namespace OrbitTools
+{
+
+//////////////////////////////////////////////////////////////////////////////
+struct Vec3
+{
+   double m_x;
+   double m_y;
+   double m_z;
+};
+
+//////////////////////////////////////////////////////////////////////////////
+// ECI position (km) and velocity (km/sec) at a Julian date
+struct EciState
+{
+   Vec3   m_Position;
+   Vec3   m_Velocity;
+   double m_Date;
+};
+
+//////////////////////////////////////////////////////////////////////////////
+struct Geodetic
+{
+   double m_Lat;   // Latitude,  radians (negative south)
+   double m_Lon;   // Longitude, radians
+   double m_Alt;   // Altitude,  km      (above ellipsoid height)
+};
+
+//////////////////////////////////////////////////////////////////////////////
+struct Topocentric
+{
+   double m_Az;         // Azimuth, radians
+   double m_El;         // Elevation, radians
+   double m_Range;      // Range, kilometers
+   double m_RangeRate;  // Range rate of change, km/sec
+                        // Negative value means "towards observer"
+};
+
+static_assert(std::is_trivially_copyable<Vec3>::value,        "Vec3 must stay plain data");
+static_assert(std::is_trivially_copyable<EciState>::value,    "EciState must stay plain data");
+static_assert(std::is_trivially_copyable<Geodetic>::value,    "Geodetic must stay plain data");
+static_assert(std::is_trivially_copyable<Topocentric>::value, "Topocentric must stay plain data");
+static_assert(sizeof(Vec3) == 3 * sizeof(double),             "Vec3 must not be padded");
+
+//////////////////////////////////////////////////////////////////////////////
+// Conversions to and from the legacy classes
+
+inline Vec3 ToVec3(const cVector &v)
+{
+   return Vec3{ v.m_x, v.m_y, v.m_z };
+}
+
+inline cVector ToVector(const Vec3 &v)
+{
+   return cVector(v.m_x, v.m_y, v.m_z);
+}
+
+inline EciState ToEciState(const cEciTime &eci)
+{
+   return EciState{ ToVec3(eci.Position()), ToVec3(eci.Velocity()), eci.Date().Date() };
+}
+
+inline cEciTime ToEciTime(const EciState &eci)
+{
+   return cEciTime(ToVector(eci.m_Position), ToVector(eci.m_Velocity), cJulian::FromDate(eci.m_Date));
+}
+
+inline Geodetic ToGeodetic(const cGeo &geo)
+{
+   return Geodetic{ geo.LatitudeRad(), geo.LongitudeRad(), geo.AltitudeKm() };
+}
+
+inline cGeo ToGeo(const Geodetic &geo)
+{
+   return cGeo(geo.m_Lat, geo.m_Lon, geo.m_Alt);
+}
+
+inline Topocentric ToTopocentric(const cTopo &topo)
+{
+   return Topocentric{ topo.AzimuthRad(), topo.ElevationRad(), topo.RangeKm(), topo.RangeRateKmSec() };
+}
+
+inline cTopo ToTopo(const Topocentric &topo)
+{
+   return cTopo(topo.m_Az, topo.m_El, topo.m_Range, topo.m_RangeRate);
+}
+
+}
+}
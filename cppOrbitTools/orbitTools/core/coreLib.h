@@ -14,6 +14,7 @@ using namespace std;
 #include "cJulian.h"
 #include "cEci.h"
 #include "coord.h"
+#include "coordTypes.h"
 #include "cSite.h"
 #include "cTle.h"
 #include "cVector.h"
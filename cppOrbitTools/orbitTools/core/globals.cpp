@@ -13,12 +13,6 @@ namespace Zeptomoby
 {
 namespace OrbitTools
 {
-//////////////////////////////////////////////////////////////////////////////
-double sqr(const double x) 
-{
-   return (x * x);
-}
-
 //////////////////////////////////////////////////////////////////////////////
 double Fmod2p(const double arg)
 {
@@ -47,19 +41,5 @@ double AcTan(const double sinx, const double cosx)
       return (cosx > 0.0) ? (atan(sinx / cosx)) : (PI + atan(sinx / cosx));
    }
 }
-
-//////////////////////////////////////////////////////////////////////////////
-double rad2deg(const double r)
-{
-   const double DEG_PER_RAD = 180.0 / PI;
-   return r * DEG_PER_RAD;
-}
-
-//////////////////////////////////////////////////////////////////////////////
-double deg2rad(const double d)
-{
-   const double RAD_PER_DEG = PI / 180.0;
-   return d * RAD_PER_DEG;
-}
 }
 }
\ No newline at end of file
@@ -11,44 +11,132 @@ namespace Zeptomoby
 {
 namespace OrbitTools
 {
-const double PI           = 3.141592653589793;
-const double TWOPI        = 2.0 * PI;
-const double RADS_PER_DEG = PI / 180.0;
-
-const double GM           = 398601.2;  // Earth gravitational constant, km^3/sec^2
-const double GEOSYNC_ALT  = 42241.892; // km
-const double EARTH_DIA    = 12800.0;   // km
-const double DAY_SIDERAL  = (23 * 3600.0) + (56 * 60.0) + 4.09; // sec
-const double DAY_24HR     = (24 * 3600.0); // sec
-
-const double AE           = 1.0;
-const double AU           = 149597870.0;  // Astronomical unit (km) (IAU 76)
-const double SR           = 696000.0;     // Solar radius (km)      (IAU 76)
-const double XKMPER_WGS72 = 6378.135;     // Earth equatorial radius - km (WGS '72)
-const double F            = 1.0 / 298.26; // Earth flattening (WGS '72)
-const double GE           = 398600.8;     // Earth gravitational constant (WGS '72)
-const double J2           = 1.0826158E-3; // J2 harmonic (WGS '72)
-const double J3           = -2.53881E-6;  // J3 harmonic (WGS '72)
-const double J4           = -1.65597E-6;  // J4 harmonic (WGS '72)
-const double CK2          = J2 / 2.0;
-const double CK4          = -3.0 * J4 / 8.0;
-const double XJ3          = J3;
-const double QO           = AE + 120.0 / XKMPER_WGS72;
-const double S            = AE + 78.0  / XKMPER_WGS72;
-const double HR_PER_DAY   = 24.0;          // Hours per day   (solar)
-const double MIN_PER_DAY  = 1440.0;        // Minutes per day (solar)
-const double SEC_PER_DAY  = 86400.0;       // Seconds per day (solar)
-const double OMEGA_E      = 1.00273790934; // earth rotation per sideral day
-const double XKE          = sqrt(3600.0 * GE /           //sqrt(ge) ER^3/min^2
-                                (XKMPER_WGS72 * XKMPER_WGS72 * XKMPER_WGS72)); 
-const double QOMS2T       = pow((QO - S), 4);            //(QO - S)^4 ER^4
+constexpr double PI           = 3.141592653589793;
+constexpr double TWOPI        = 2.0 * PI;
+constexpr double RADS_PER_DEG = PI / 180.0;
+
+constexpr double GM           = 398601.2;  // Earth gravitational constant, km^3/sec^2
+constexpr double GEOSYNC_ALT  = 42241.892; // km
+constexpr double EARTH_DIA    = 12800.0;   // km
+constexpr double DAY_SIDERAL  = (23 * 3600.0) + (56 * 60.0) + 4.09; // sec
+constexpr double DAY_24HR     = (24 * 3600.0); // sec
+
+//////////////////////////////////////////////////////////////////////////////
+// ConstSqrt()
+// Square root usable in constant expressions, rounded like sqrt(): a
+// Newton iteration, then whichever of the result and its two neighbors
+// has the smallest exact residual x - r * r. Use sqrt() at run time.
+constexpr double ConstSqrtResidual(double r, double x)
+{
+   // Dekker's exact product: r * r == hi + lo
+   const double split = 134217729.0;   // 2^27 + 1
+   double c  = split * r;
+   double rh = c - (c - r);
+   double rl = r - rh;
+   double hi = r * r;
+   double lo = ((rh * rh - hi) + 2.0 * rh * rl) + rl * rl;
+
+   double res = (x - hi) - lo;
+
+   return (res < 0.0) ? -res : res;
+}
+
+constexpr double ConstSqrt(double x)
+{
+   if (!(x > 0.0))
+   {
+      return 0.0;
+   }
+
+   double r    = (x > 1.0) ? x : 1.0;
+   double prev = 0.0;
+
+   for (int i = 0; i < 2048; i++)
+   {
+      double next = 0.5 * (r + x / r);
+
+      if ((next == r) || (next == prev))
+      {
+         break;
+      }
+
+      prev = r;
+      r    = next;
+   }
+
+   // One unit in the last place of r
+   double ulp = 1.0;
+
+   while (ulp > r)  { ulp *= 0.5; }
+   while (ulp * 2.0 <= r) { ulp *= 2.0; }
+   ulp *= 2.220446049250313e-16;   // 2^-52
+
+   double best = r;
+
+   if (ConstSqrtResidual(r - ulp, x) < ConstSqrtResidual(best, x)) { best = r - ulp; }
+   if (ConstSqrtResidual(r + ulp, x) < ConstSqrtResidual(best, x)) { best = r + ulp; }
+
+   return best;
+}
+
+constexpr double AE           = 1.0;
+constexpr double AU           = 149597870.0;  // Astronomical unit (km) (IAU 76)
+constexpr double SR           = 696000.0;     // Solar radius (km)      (IAU 76)
+constexpr double XKMPER_WGS72 = 6378.135;     // Earth equatorial radius - km (WGS '72)
+constexpr double F            = 1.0 / 298.26; // Earth flattening (WGS '72)
+constexpr double GE           = 398600.8;     // Earth gravitational constant (WGS '72)
+constexpr double J2           = 1.0826158E-3; // J2 harmonic (WGS '72)
+constexpr double J3           = -2.53881E-6;  // J3 harmonic (WGS '72)
+constexpr double J4           = -1.65597E-6;  // J4 harmonic (WGS '72)
+constexpr double CK2          = J2 / 2.0;
+constexpr double CK4          = -3.0 * J4 / 8.0;
+constexpr double XJ3          = J3;
+constexpr double QO           = AE + 120.0 / XKMPER_WGS72;
+constexpr double S            = AE + 78.0  / XKMPER_WGS72;
+constexpr double HR_PER_DAY   = 24.0;          // Hours per day   (solar)
+constexpr double MIN_PER_DAY  = 1440.0;        // Minutes per day (solar)
+constexpr double SEC_PER_DAY  = 86400.0;       // Seconds per day (solar)
+constexpr double OMEGA_E      = 1.00273790934; // earth rotation per sideral day
+constexpr double XKE          = ConstSqrt(3600.0 * GE /   //sqrt(ge) ER^3/min^2
+                                   (XKMPER_WGS72 * XKMPER_WGS72 * XKMPER_WGS72));
+constexpr double QOMS2T       = (QO - S) * (QO - S) * (QO - S) * (QO - S); //(QO - S)^4 ER^4
+
+//////////////////////////////////////////////////////////////////////////////
+// cWgs72, cWgs84
+// Earth constant sets for templates that take the earth model as a
+// parameter, e.g. EciToGeo<double, cWgs84>(). Every member is a compile
+// time constant, so the choice costs nothing at run time. cWgs72 holds
+// the globals above. The NORAD models (SGP4/SDP4) are defined with
+// WGS-72 and always use it.
+struct cWgs72
+{
+   static constexpr double XKMPER = XKMPER_WGS72;                 // Equatorial radius, km
+   static constexpr double F      = ::Zeptomoby::OrbitTools::F;   // Flattening
+   static constexpr double GE     = ::Zeptomoby::OrbitTools::GE;  // km^3/sec^2
+   static constexpr double J2     = ::Zeptomoby::OrbitTools::J2;
+   static constexpr double J3     = ::Zeptomoby::OrbitTools::J3;
+   static constexpr double J4     = ::Zeptomoby::OrbitTools::J4;
+   static constexpr double XKE    = ::Zeptomoby::OrbitTools::XKE;
+};
+
+struct cWgs84
+{
+   static constexpr double XKMPER = 6378.137;
+   static constexpr double F      = 1.0 / 298.257223563;
+   static constexpr double GE     = 398600.5;
+   static constexpr double J2     = 1.08262998905E-3;
+   static constexpr double J3     = -2.53215306E-6;
+   static constexpr double J4     = -1.61098761E-6;
+   static constexpr double XKE    = ConstSqrt(3600.0 * GE / (XKMPER * XKMPER * XKMPER));
+};
 
 // Utility functions
-double sqr   (const double x);
+constexpr double sqr(const double x) { return (x * x); }
+
 double Fmod2p(const double arg);
 double AcTan (const double sinx, const double cosx);
 
-double rad2deg(const double);
-double deg2rad(const double);
+constexpr double rad2deg(const double r) { return r * (180.0 / PI); }
+constexpr double deg2rad(const double d) { return d * (PI / 180.0); }
 }
 }
\ No newline at end of file
@@ -0,0 +1,340 @@
+//
+// cEphemeris.cpp
+//
+// Piecewise Chebyshev ephemeris cache. See note in cEphemeris.h
+//
+#include "stdafx.h"
+
+#include <cmath>
+#include "cEphemeris.h"
+#include "exceptions.h"
+
+namespace Zeptomoby
+{
+namespace OrbitTools
+{
+
+//////////////////////////////////////////////////////////////////////////////
+cEphemeris::cEphemeris(const cSatellite &sat,
+                       double segMin      /* = 10.0  */,
+                       double toleranceKm /* = 0.010 */,
+                       int    order       /* = DEFAULT_ORDER */,
+                       bool   velocity    /* = false */) :
+   m_Sat(sat),
+   m_SegMin(segMin),
+   m_ToleranceKm(toleranceKm),
+   m_Order(order),
+   m_Axes(velocity ? 6 : 3),
+   m_LastKey(0),
+   m_pLast(NULL),
+   m_Hits(0),
+   m_Misses(0),
+   m_Direct(0),
+   m_MaxFitErrorKm(0.0)
+{
+}
+
+//////////////////////////////////////////////////////////////////////////////
+void cEphemeris::Position(double mpe, double pos[3])
+{
+   bool fitted = false;
+   const cSegment &seg = Find(mpe, &fitted);
+
+   if (seg.m_Pieces == 0)
+   {
+      ++m_Direct;
+
+      cEciTime eci = m_Sat.PositionEci(mpe);
+
+      pos[0] = eci.Position().m_x;
+      pos[1] = eci.Position().m_y;
+      pos[2] = eci.Position().m_z;
+      return;
+   }
+
+   fitted ? ++m_Misses : ++m_Hits;
+
+   Evaluate(seg, mpe, pos, 3);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+bool cEphemeris::PositionVelocity(double mpe, double pos[3], double vel[3])
+{
+   // Segments of a position-only ephemeris hold 3 axes of coefficients
+   if (m_Axes != 6)
+   {
+      return false;
+   }
+
+   bool fitted = false;
+   const cSegment &seg = Find(mpe, &fitted);
+
+   if (seg.m_Pieces == 0)
+   {
+      ++m_Direct;
+
+      cEciTime eci = m_Sat.PositionEci(mpe);
+
+      pos[0] = eci.Position().m_x;
+      pos[1] = eci.Position().m_y;
+      pos[2] = eci.Position().m_z;
+      vel[0] = eci.Velocity().m_x;
+      vel[1] = eci.Velocity().m_y;
+      vel[2] = eci.Velocity().m_z;
+      return true;
+   }
+
+   fitted ? ++m_Misses : ++m_Hits;
+
+   double out[6];
+
+   Evaluate(seg, mpe, out, 6);
+
+   for (int i = 0; i < 3; i++)
+   {
+      pos[i] = out[i];
+      vel[i] = out[i + 3];
+   }
+
+   return true;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// Bytes()
+// Coefficient storage plus the hash table's nodes and buckets.
+size_t cEphemeris::Bytes() const
+{
+   size_t bytes = m_Segments.bucket_count() * sizeof(void*);
+
+   for (const auto &entry : m_Segments)
+   {
+      bytes += sizeof(entry) + 2 * sizeof(void*) +
+               entry.second.m_Coef.capacity() * sizeof(double);
+   }
+
+   return bytes;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+void cEphemeris::Clear()
+{
+   m_Segments.clear();
+
+   m_pLast  = NULL;
+   m_Hits   = 0;
+   m_Misses = 0;
+   m_Direct = 0;
+   m_MaxFitErrorKm = 0.0;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// Find()
+// The segment holding 'mpe', fitted on first use. Repeated queries in the
+// same segment skip the hash lookup.
+const cEphemeris::cSegment& cEphemeris::Find(double mpe, bool *pFitted)
+{
+   const long long key = (long long)std::floor(mpe / m_SegMin);
+
+   *pFitted = false;
+
+   if ((m_pLast != NULL) && (key == m_LastKey))
+   {
+      return *m_pLast;
+   }
+
+   auto found = m_Segments.find(key);
+
+   if (found == m_Segments.end())
+   {
+      found = m_Segments.emplace(key, cSegment()).first;
+      Fit(key, &found->second);
+      *pFitted = true;
+   }
+
+   // Element references survive rehashing
+   m_LastKey = key;
+   m_pLast   = &found->second;
+
+   return *m_pLast;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+void cEphemeris::Fit(long long key, cSegment *pSeg)
+{
+   const double start = key * m_SegMin;
+
+   pSeg->m_Start  = start;
+   pSeg->m_Pieces = 0;
+
+   try
+   {
+      for (int pieces = 1; pieces <= (1 << MAX_SPLIT); pieces *= 2)
+      {
+         double maxErrKm = 0.0;
+
+         if (FitPieces(start, pieces, &pSeg->m_Coef, &maxErrKm))
+         {
+            pSeg->m_Pieces = pieces;
+
+            if (maxErrKm > m_MaxFitErrorKm)
+            {
+               m_MaxFitErrorKm = maxErrKm;
+            }
+
+            return;
+         }
+      }
+   }
+   catch (cPropagationException &)
+   {
+      // Decayed or bad elements somewhere in the segment; answer its
+      // queries directly so the caller sees cSatellite's behavior.
+   }
+
+   std::vector<double>().swap(pSeg->m_Coef);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// FitPieces()
+// Interpolate each of 'pieces' equal parts of the segment starting at
+// 'start' at the Chebyshev nodes, then compare the fit with cSatellite at
+// 2 * (order + 1) + 1 evenly spaced points. Returns false if any point
+// misses the tolerance.
+bool cEphemeris::FitPieces(double start, int pieces,
+                           std::vector<double> *pCoef, double *pMaxErrKm) const
+{
+   const int    n      = m_Order + 1;
+   const double len    = m_SegMin / pieces;
+   const double velTol = m_ToleranceKm / 60.0;
+
+   pCoef->assign((size_t)(pieces * m_Axes * n), 0.0);
+
+   std::vector<double> f((size_t)(m_Axes * n));
+
+   for (int p = 0; p < pieces; p++)
+   {
+      const double pieceStart = start + p * len;
+      double *pPiece = &(*pCoef)[(size_t)(p * m_Axes * n)];
+
+      // Sample at the nodes
+      for (int k = 0; k < n; k++)
+      {
+         double x = cos(PI * (k + 0.5) / n);
+         cEciTime eci = m_Sat.PositionEci(pieceStart + 0.5 * (x + 1.0) * len);
+
+         f[0 * n + k] = eci.Position().m_x;
+         f[1 * n + k] = eci.Position().m_y;
+         f[2 * n + k] = eci.Position().m_z;
+
+         if (m_Axes == 6)
+         {
+            f[3 * n + k] = eci.Velocity().m_x;
+            f[4 * n + k] = eci.Velocity().m_y;
+            f[5 * n + k] = eci.Velocity().m_z;
+         }
+      }
+
+      for (int a = 0; a < m_Axes; a++)
+      {
+         for (int j = 0; j < n; j++)
+         {
+            double sum = 0.0;
+
+            for (int k = 0; k < n; k++)
+            {
+               sum += f[a * n + k] * cos(PI * j * (k + 0.5) / n);
+            }
+
+            pPiece[a * n + j] = (j == 0 ? 1.0 : 2.0) * sum / n;
+         }
+      }
+
+      // Check the fit
+      const int checks = 2 * n;
+
+      for (int i = 0; i <= checks; i++)
+      {
+         double x = 2.0 * i / checks - 1.0;
+         cEciTime eci = m_Sat.PositionEci(pieceStart + 0.5 * (x + 1.0) * len);
+
+         double dx = Clenshaw(pPiece + 0 * n, n, x) - eci.Position().m_x;
+         double dy = Clenshaw(pPiece + 1 * n, n, x) - eci.Position().m_y;
+         double dz = Clenshaw(pPiece + 2 * n, n, x) - eci.Position().m_z;
+         double errKm = sqrt(dx * dx + dy * dy + dz * dz);
+
+         if (errKm > m_ToleranceKm)
+         {
+            return false;
+         }
+
+         if (errKm > *pMaxErrKm)
+         {
+            *pMaxErrKm = errKm;
+         }
+
+         if (m_Axes == 6)
+         {
+            double du = Clenshaw(pPiece + 3 * n, n, x) - eci.Velocity().m_x;
+            double dv = Clenshaw(pPiece + 4 * n, n, x) - eci.Velocity().m_y;
+            double dw = Clenshaw(pPiece + 5 * n, n, x) - eci.Velocity().m_z;
+
+            if (sqrt(du * du + dv * dv + dw * dw) > velTol)
+            {
+               return false;
+            }
+         }
+      }
+   }
+
+   return true;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+void cEphemeris::Evaluate(const cSegment &seg, double mpe, double *pOut, int axes) const
+{
+   const int    n     = m_Order + 1;
+   const double len   = m_SegMin / seg.m_Pieces;
+   const double start = seg.m_Start;
+
+   int p = (int)((mpe - start) / len);
+
+   if (p < 0)
+   {
+      p = 0;
+   }
+   else if (p >= seg.m_Pieces)
+   {
+      p = seg.m_Pieces - 1;
+   }
+
+   const double  x      = 2.0 * (mpe - (start + p * len)) / len - 1.0;
+   const double *pPiece = &seg.m_Coef[(size_t)(p * m_Axes * n)];
+
+   for (int a = 0; a < axes; a++)
+   {
+      pOut[a] = Clenshaw(pPiece + a * n, n, x);
+   }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// Clenshaw()
+// Sum of pCoef[j] * T_j(x), j = 0 .. count - 1.
+double cEphemeris::Clenshaw(const double *pCoef, int count, double x)
+{
+   const double x2 = 2.0 * x;
+   double b1 = 0.0;
+   double b2 = 0.0;
+
+   for (int j = count - 1; j > 0; j--)
+   {
+      double b0 = x2 * b1 - b2 + pCoef[j];
+
+      b2 = b1;
+      b1 = b0;
+   }
+
+   return x * b1 - b2 + pCoef[0];
+}
+
+}
+}
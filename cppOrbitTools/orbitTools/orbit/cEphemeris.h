@@ -0,0 +1,105 @@
+//
+// cEphemeris.h
+//
+// Piecewise Chebyshev approximation of a satellite's ECI position, and
+// optionally velocity, fitted lazily from cSatellite::PositionEci().
+//
+// Time is cut into fixed segments of 'segMin' minutes past epoch. The
+// first query that lands in a segment fits it; later queries in the same
+// segment cost one Clenshaw recurrence (a few multiply-adds) per axis.
+//
+// Every fit is checked against cSatellite at points between the fit
+// nodes, including both segment ends. A segment that misses the
+// tolerance is split in halves, up to MAX_SPLIT times. If it still
+// misses, or cSatellite throws while fitting it, the segment is marked
+// "direct" and its queries are answered by cSatellite itself.
+//
+// The check is against cSatellite at sample points only. The NORAD
+// models are not perfectly smooth themselves: Kepler's equation is solved
+// to 1.0e-06 radian (a few meters in LEO), and SDP4 refreshes its
+// lunar-solar periodics in steps. The fit follows the smooth orbit, so
+// between sample points it can differ from cSatellite by that much.
+//
+#pragma once
+
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+#include "cSatellite.h"
+
+namespace Zeptomoby
+{
+namespace OrbitTools
+{
+
+//////////////////////////////////////////////////////////////////////////////
+class cEphemeris
+{
+public:
+   enum { DEFAULT_ORDER = 8, MAX_SPLIT = 3 };
+
+   // segMin      - segment length, minutes
+   // toleranceKm - largest position error accepted at fit time; velocity
+   //               is held to toleranceKm per minute (in km/sec)
+   // order       - Chebyshev order of each fit
+   // velocity    - also fit the velocity
+   cEphemeris(const cSatellite &sat,
+              double segMin      = 10.0,
+              double toleranceKm = 0.010,
+              int    order       = DEFAULT_ORDER,
+              bool   velocity    = false);
+
+   // ECI position (km) at 'mpe' minutes past epoch. Throws the same
+   // exceptions as cSatellite::PositionEci() for a "direct" segment.
+   void Position(double mpe, double pos[3]);
+
+   // ECI position (km) and velocity (km/sec). Returns false, and leaves
+   // pos and vel untouched, if the ephemeris was made without velocity.
+   bool PositionVelocity(double mpe, double pos[3], double vel[3]);
+
+   const cSatellite& Satellite() const { return m_Sat; }
+   bool   HasVelocity()   const { return m_Axes == 6; }
+
+   // Statistics
+   unsigned long long Hits()   const { return m_Hits;   } // answered from a fitted segment
+   unsigned long long Misses() const { return m_Misses; } // fitted a new segment
+   unsigned long long Direct() const { return m_Direct; } // answered by cSatellite
+   size_t Segments() const { return m_Segments.size(); }
+   size_t Bytes() const;                                  // approximate heap use
+   double MaxFitErrorKm() const { return m_MaxFitErrorKm; }
+
+   void Clear();
+
+protected:
+   struct cSegment
+   {
+      double              m_Start;   // minutes past epoch
+      int                 m_Pieces;  // 0 for a "direct" segment
+      std::vector<double> m_Coef;    // [piece][axis][order + 1]
+   };
+
+   const cSegment& Find(double mpe, bool *pFitted);
+   void Fit(long long key, cSegment *pSeg);
+   bool FitPieces(double start, int pieces, std::vector<double> *pCoef, double *pMaxErrKm) const;
+   void Evaluate(const cSegment &seg, double mpe, double *pOut, int axes) const;
+
+   static double Clenshaw(const double *pCoef, int count, double x);
+
+   cSatellite m_Sat;
+   double     m_SegMin;
+   double     m_ToleranceKm;
+   int        m_Order;
+   int        m_Axes;
+
+   std::unordered_map<long long, cSegment> m_Segments;
+   long long       m_LastKey;
+   const cSegment *m_pLast;
+
+   unsigned long long m_Hits;
+   unsigned long long m_Misses;
+   unsigned long long m_Direct;
+   double             m_MaxFitErrorKm;
+};
+
+}
+}
@@ -0,0 +1,296 @@
+//
+// cJ2Kernel.h
+//
+// Analytic J2 propagator for short horizons, e.g. animating a catalog
+// many times a second.
+//
+// The kernel is anchored to the full model (cSgp4Kernel or cSdp4Kernel)
+// at one time: the state there is turned into osculating Keplerian
+// elements, and from there only closed-form J2 secular rates are applied.
+// The RAAN and the argument of perigee drift and the mean anomaly
+// advances; a, e and i stay fixed. Each call is one Kepler solve and a
+// rotation, with no drag, no periodics and no lunar-solar terms.
+//
+// The RAAN and perigee rates are evaluated from the TLE's mean elements,
+// as SGP4 does. The mean anomaly rate is the osculating mean motion plus
+// the J2 secular correction to it: over a few minutes the satellite moves
+// at its osculating rate, and the mean rate alone would put it hundreds
+// of meters off within a minute.
+//
+// SGP4/SDP4 velocities leave out the rates of the short period terms, so
+// they are not quite the derivative of the positions. Anchoring to a
+// velocity as it is drifts by a few hundred meters per minute in LEO.
+// Anchor() can instead be given the full model's position at the end of
+// the span the kernel will be used for; the anchor velocity is then
+// corrected once so the kernel meets the full model at both ends, and
+// consecutive spans join without a jump.
+//
+// Units are those of cNoradKernel.h: earth radii, earth radii per minute
+// and minutes from EpochJd(), which here is the anchor time.
+//
+#pragma once
+
+#include <cmath>
+#include "globals.h"
+#include "cNoradKernel.h"
+
+namespace Zeptomoby
+{
+namespace OrbitTools
+{
+
+//////////////////////////////////////////////////////////////////////////////
+class cJ2Kernel
+{
+public:
+   typedef double RealType;
+
+   // Secular rates from the mean elements. The kernel cannot propagate
+   // until it has been anchored.
+   explicit cJ2Kernel(const cNoradElements &el);
+
+   // Anchor to the full model's position and velocity at Julian date 'jd'.
+   // Returns false, and leaves the kernel unusable, if the state is not
+   // a bound orbit.
+   bool Anchor(double jd, const double pos[3], const double vel[3]);
+
+   // As above, then correct the velocity so the kernel passes through
+   // 'posEnd', the full model's position 'span' minutes after 'jd'.
+   bool Anchor(double jd, const double pos[3], const double vel[3],
+               double span, const double posEnd[3]);
+
+   // Position and velocity at 'tsince' minutes past the anchor.
+   // NORAD_BAD_ELEMENTS if the kernel is not anchored.
+   eNoradResult Propagate(double tsince, double pos[3], double vel[3]) const
+   {
+      return Evaluate<true>(tsince, pos, vel);
+   }
+
+   eNoradResult Position(double tsince, double pos[3]) const
+   {
+      return Evaluate<false>(tsince, pos, nullptr);
+   }
+
+   double EpochJd() const { return m_jdAnchor; }
+
+   // J2 secular rates of the RAAN and the argument of perigee, and the
+   // J2 correction to the mean motion; radians per minute
+   double RaanDot()   const { return m_RaanDot; }
+   double ArgpDot()   const { return m_ArgpDot; }
+   double MeanDotJ2() const { return m_MeanDotJ2; }
+
+protected:
+   template <bool Velocity>
+   eNoradResult Evaluate(double tsince, double pos[3], double vel[3]) const;
+
+   // J2 secular rates, radians per minute
+   double m_RaanDot;
+   double m_ArgpDot;
+   double m_MeanDotJ2;     // correction to the mean motion
+
+   // Osculating elements at the anchor
+   double m_jdAnchor;
+   double m_SemiMajor;     // earth radii; 0 until anchored
+   double m_Eccentricity;
+   double m_Beta;          // sqrt(1 - e^2)
+   double m_RAAN;
+   double m_ArgPerigee;
+   double m_MeanAnomaly;
+   double m_MeanDot;       // osculating mean motion plus m_MeanDotJ2
+   double m_cosi;
+   double m_sini;
+};
+
+//////////////////////////////////////////////////////////////////////////////
+inline cJ2Kernel::cJ2Kernel(const cNoradElements &el) :
+   m_jdAnchor(el.m_jdEpoch),
+   m_SemiMajor(0.0),
+   m_Eccentricity(0.0),
+   m_Beta(1.0),
+   m_RAAN(0.0),
+   m_ArgPerigee(0.0),
+   m_MeanAnomaly(0.0),
+   m_MeanDot(0.0),
+   m_cosi(1.0),
+   m_sini(0.0)
+{
+   // First order terms of xmdot, omgdot and xnodot in cNoradBase::Initialize()
+   const double cosio  = cos(el.m_Inclination);
+   const double theta2 = cosio * cosio;
+   const double betao2 = 1.0 - sqr(el.m_Eccentricity);
+   const double pinvsq = 1.0 / (sqr(el.m_SemiMajor) * sqr(betao2));
+   const double temp1  = 3.0 * CK2 * pinvsq * el.m_MeanMotion;
+
+   m_MeanDotJ2 = 0.5 * temp1 * sqrt(betao2) * (3.0 * theta2 - 1.0);
+   m_ArgpDot   = -0.5 * temp1 * (1.0 - 5.0 * theta2);
+   m_RaanDot   = -temp1 * cosio;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// Anchor()
+// Osculating elements from the state vector, with mu = XKE^2.
+inline bool cJ2Kernel::Anchor(double jd, const double pos[3], const double vel[3])
+{
+   const double mu = XKE * XKE;
+
+   m_jdAnchor  = jd;
+   m_SemiMajor = 0.0;
+
+   const double r  = sqrt(pos[0] * pos[0] + pos[1] * pos[1] + pos[2] * pos[2]);
+   const double v2 = vel[0] * vel[0] + vel[1] * vel[1] + vel[2] * vel[2];
+   const double rv = pos[0] * vel[0] + pos[1] * vel[1] + pos[2] * vel[2];
+
+   const double a = 1.0 / (2.0 / r - v2 / mu);
+
+   if (!(a > 0.0))
+   {
+      return false;
+   }
+
+   // Angular momentum
+   const double hx = pos[1] * vel[2] - pos[2] * vel[1];
+   const double hy = pos[2] * vel[0] - pos[0] * vel[2];
+   const double hz = pos[0] * vel[1] - pos[1] * vel[0];
+   const double h  = sqrt(hx * hx + hy * hy + hz * hz);
+
+   // Eccentric anomaly from e cos(E) and e sin(E)
+   const double ecosE = 1.0 - r / a;
+   const double esinE = rv / sqrt(mu * a);
+   const double e     = sqrt(ecosE * ecosE + esinE * esinE);
+
+   if (!(e < 1.0) || !(h > 0.0))
+   {
+      return false;
+   }
+
+   const double E    = atan2(esinE, ecosE);
+   const double beta = sqrt(1.0 - e * e);
+   const double nu   = atan2(beta * sin(E), cos(E) - e);
+
+   // Ascending node (z cross h). An equatorial orbit has no node; measure
+   // from the x axis.
+   const double nodeLen = sqrt(hx * hx + hy * hy);
+   const double nx = (nodeLen > 0.0) ? -hy / nodeLen : 1.0;
+   const double ny = (nodeLen > 0.0) ?  hx / nodeLen : 0.0;
+
+   // Argument of latitude, from the node toward (h cross node)
+   const double u = atan2((-hz * ny * pos[0] + hz * nx * pos[1] + (hx * ny - hy * nx) * pos[2]) / h,
+                          nx * pos[0] + ny * pos[1]);
+
+   // At e = 0 this puts perigee at the satellite; only u matters then.
+   m_SemiMajor    = a;
+   m_Eccentricity = e;
+   m_Beta         = beta;
+   m_RAAN         = atan2(ny, nx);
+   m_ArgPerigee   = u - nu;
+   m_MeanAnomaly  = E - esinE;
+   m_MeanDot      = sqrt(mu / (a * a * a)) + m_MeanDotJ2;
+   m_cosi         = hz / h;
+   m_sini         = nodeLen / h;
+
+   return true;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// Anchor()
+// One correction step is enough: the miss at the end of the span depends
+// almost linearly on the velocity, and a second step changes the error by
+// less than the full model's own noise.
+inline bool cJ2Kernel::Anchor(double jd, const double pos[3], const double vel[3],
+                              double span, const double posEnd[3])
+{
+   double end[3];
+
+   if (!Anchor(jd, pos, vel) || (Position(span, end) != NORAD_OK))
+   {
+      return false;
+   }
+
+   const double corrected[3] =
+   {
+      vel[0] + (posEnd[0] - end[0]) / span,
+      vel[1] + (posEnd[1] - end[1]) / span,
+      vel[2] + (posEnd[2] - end[2]) / span
+   };
+
+   return Anchor(jd, pos, corrected);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+template <bool Velocity>
+eNoradResult cJ2Kernel::Evaluate(double tsince, double pos[3], double vel[3]) const
+{
+   if (m_SemiMajor <= 0.0)
+   {
+      return NORAD_BAD_ELEMENTS;
+   }
+
+   const double a = m_SemiMajor;
+   const double e = m_Eccentricity;
+
+   const double raan = m_RAAN       + m_RaanDot * tsince;
+   const double argp = m_ArgPerigee + m_ArgpDot * tsince;
+   const double M    = NoradReduce(m_MeanAnomaly + m_MeanDot * tsince);
+
+   // Kepler's equation
+   double E = M + e * sin(M);
+
+   for (int i = 0; i < 10; i++)
+   {
+      const double dE = (E - e * sin(E) - M) / (1.0 - e * cos(E));
+
+      E -= dE;
+
+      if (fabs(dE) < 1.0e-12)
+      {
+         break;
+      }
+   }
+
+   const double cosE = cos(E);
+   const double sinE = sin(E);
+
+   // Perifocal position
+   const double xp = a * (cosE - e);
+   const double yp = a * m_Beta * sinE;
+
+   const double cosO = cos(raan);
+   const double sinO = sin(raan);
+   const double cosw = cos(argp);
+   const double sinw = sin(argp);
+
+   // Perifocal axes in ECI
+   const double px =  cosO * cosw - sinO * sinw * m_cosi;
+   const double py =  sinO * cosw + cosO * sinw * m_cosi;
+   const double pz =  sinw * m_sini;
+   const double qx = -cosO * sinw - sinO * cosw * m_cosi;
+   const double qy = -sinO * sinw + cosO * cosw * m_cosi;
+   const double qz =  cosw * m_sini;
+
+   pos[0] = xp * px + yp * qx;
+   pos[1] = xp * py + yp * qy;
+   pos[2] = xp * pz + yp * qz;
+
+   if constexpr (Velocity)
+   {
+      // Derivative of the model: motion in the plane, plus the plane
+      // turning about z (RAAN) and the apsides turning about its normal.
+      const double Edot = m_MeanDot / (1.0 - e * cosE);
+      const double vxp  = -a * sinE * Edot;
+      const double vyp  =  a * m_Beta * cosE * Edot;
+
+      // Orbit normal
+      const double wx =  sinO * m_sini;
+      const double wy = -cosO * m_sini;
+      const double wz =  m_cosi;
+
+      vel[0] = vxp * px + vyp * qx + m_ArgpDot * (wy * pos[2] - wz * pos[1]) - m_RaanDot * pos[1];
+      vel[1] = vxp * py + vyp * qy + m_ArgpDot * (wz * pos[0] - wx * pos[2]) + m_RaanDot * pos[0];
+      vel[2] = vxp * pz + vyp * qz + m_ArgpDot * (wx * pos[1] - wy * pos[0]);
+   }
+
+   return NORAD_OK;
+}
+
+}
+}
@@ -0,0 +1,1600 @@
+//
+// cNoradKernel.h
+//
+// Value-type template versions of the NORAD SGP4 and SDP4 models, for use
+// by the batch propagation paths. The equations are the ones in
+// cNoradBase, cNoradSGP4 and cNoradSDP4; all time-independent terms are
+// evaluated once, in double precision.
+//
+// Where cOrbit holds a cNoradBase* and the models test isimp, gp_reso and
+// gp_sync on every call, here the model variant is a template parameter
+// chosen once when the kernel is made. A batch of one kernel type then
+// propagates with no virtual calls and no model branches.
+//
+// The SGP4 kernel is also templated on 'Real': instantiate with 'double'
+// for results that match cOrbit, or with 'float' for "display grade"
+// results. In single precision the secular (time-linear) angles are
+// accumulated in double and reduced to 0..2PI before they are narrowed;
+// only the periodic terms, Kepler's equation and the orientation vectors
+// run in 'Real'.
+//
+// Positions are in earth radii and velocities in earth radii per minute,
+// the same units cNoradBase::FinalPosition() produces. Each kernel also
+// has a Position() call for callers that only need the position (e.g.
+// lat/lon/alt): it skips the radial and along-track rate terms and the
+// velocity vector, and produces bit-identical positions.
+//
+#pragma once
+
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <unordered_map>
+#include <variant>
+#include "globals.h"
+#include "cJulian.h"
+
+namespace Zeptomoby
+{
+namespace OrbitTools
+{
+
+//////////////////////////////////////////////////////////////////////////////
+// cNoradElements
+// Mean orbital elements, as recovered by cOrbit, in the units the NORAD
+// models use internally.
+struct cNoradElements
+{
+   double m_jdEpoch;       // TLE epoch, Julian date
+   double m_Inclination;   // radians
+   double m_Eccentricity;
+   double m_RAAN;          // radians
+   double m_ArgPerigee;    // radians
+   double m_MeanAnomaly;   // radians
+   double m_BStar;         // drag term, 1 / earth radii
+   double m_MeanMotion;    // recovered mean motion, radians per minute
+   double m_SemiMajor;     // recovered semi-major axis, earth radii
+
+   // True for periods >= 225 minutes; these orbits need the SDP4 model.
+   bool IsDeepSpace() const { return (TWOPI / m_MeanMotion) >= 225.0; }
+
+   // True if the elements are a bound orbit the models can start from:
+   // 0 <= e < 1 and a positive mean motion and semi-major axis. A TLE can
+   // pass the field checks of NoradElementsFromTle() and still fail this.
+   bool IsValid() const
+   {
+      return (m_Eccentricity >= 0.0) && (m_Eccentricity < 1.0) &&
+             (m_MeanMotion > 0.0) && (m_SemiMajor > 0.0);
+   }
+};
+
+//////////////////////////////////////////////////////////////////////////////
+// eNoradResult
+// Outcome of one kernel call. cNoradBase throws cPropagationException or
+// cDecayException for these; the kernels return them instead, so a batch
+// can carry on past a bad object with no exception on the hot path.
+enum eNoradResult
+{
+   NORAD_OK,
+   NORAD_DECAYED,        // position is below the earth's surface
+   NORAD_ECCENTRICITY,   // propagated eccentricity is out of range
+   NORAD_BAD_ELEMENTS    // semi-major axis or position is not a number
+};
+
+//////////////////////////////////////////////////////////////////////////////
+// Reduce an angle to 0..2PI before it is narrowed to 'Real'. Large secular
+// angles (hundreds of radians after a few days) would otherwise lose
+// several meters of along-track resolution in single precision.
+inline double NoradReduce(double arg)
+{
+   return arg - TWOPI * std::floor(arg / TWOPI);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// cNoradFinal
+// Time-independent terms used by FinalPosition(), shared by SGP4 and SDP4.
+template <typename Real>
+class cNoradFinal
+{
+public:
+   typedef Real RealType;
+
+   explicit cNoradFinal(const cNoradElements &el);
+
+   // Long period periodics, Kepler's equation, short period periodics and
+   // the orientation vectors; see cNoradBase::FinalPosition(). Returns why
+   // the propagation failed, if it did. With 'Velocity' false, 'vel' is
+   // not used and may be null.
+   template <bool Velocity>
+   eNoradResult FinalPosition(Real incl, Real omega, Real e, Real a,
+                      Real xl, Real xnode, Real xn,
+                      Real pos[3], Real vel[3]) const;
+
+protected:
+   Real m_cosio;   Real m_sinio;   Real m_aycof;   Real m_xlcof;
+   Real m_x3thm1;  Real m_x1mth2;  Real m_x7thm1;
+};
+
+//////////////////////////////////////////////////////////////////////////////
+// cNoradInit
+// The time-independent terms of cNoradBase::Initialize(), shared by the
+// SGP4 and SDP4 kernels. Always double precision.
+struct cNoradInit
+{
+   explicit cNoradInit(const cNoradElements &el);
+
+   double m_sinio;   double m_cosio;   double m_betao;   double m_betao2;
+   double m_s4;      double m_tsi;     double m_eta;     double m_eeta;
+   double m_coef;    double m_coef1;   double m_c1;      double m_c3;
+   double m_c4;      double m_xmdot;   double m_omgdot;  double m_xnodot;
+   double m_xnodcf;  double m_t2cof;
+};
+
+//////////////////////////////////////////////////////////////////////////////
+// For perigee less than 220 kilometers SGP4 uses the "simple" equations,
+// truncated to linear variation in sqrt a and quadratic variation in mean
+// anomaly. cNoradSGP4 tests this on every call; the kernels take it as a
+// template parameter instead.
+inline bool NoradIsSimple(const cNoradElements &el)
+{
+   return (el.m_SemiMajor * (1.0 - el.m_Eccentricity) / AE) < (220.0 / XKMPER_WGS72 + AE);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// Geopotential resonance class of a deep space orbit; see gp_reso and
+// gp_sync in cNoradSDP4.
+enum eResonance
+{
+   RES_NONE,   // no resonance terms
+   RES_12H,    // 12-hour resonant (Molniya type)
+   RES_24H     // 24-hour resonant (geosynchronous)
+};
+
+inline eResonance NoradResonance(const cNoradElements &el)
+{
+   if ((el.m_MeanMotion > 0.0034906585) && (el.m_MeanMotion < 0.0052359877))
+   {
+      return RES_24H;
+   }
+
+   if ((el.m_MeanMotion >= 8.26E-03) && (el.m_MeanMotion <= 9.24E-03) && (el.m_Eccentricity >= 0.5))
+   {
+      return RES_12H;
+   }
+
+   return RES_NONE;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// cLunarSolarEpoch
+// The terms of SDP4 initialization that depend only on the epoch: the
+// Greenwich Mean Sidereal Time and the lunar-solar geometry (dpi_... in
+// cNoradSDP4). Every deep space object with the same epoch has the same
+// values; see cLunarSolarCache.
+struct cLunarSolarEpoch
+{
+   double m_jdEpoch;   // Julian date these terms are for
+   double m_Gmst;      // radians
+   double m_zmol;      double m_zmos;
+   double m_zcosil;    double m_zsinil;
+   double m_zcoshl;    double m_zsinhl;
+   double m_zcosgl;    double m_zsingl;
+};
+
+// Evaluate the terms for one epoch, as cNoradSDP4::cNoradSDP4() does.
+inline cLunarSolarEpoch NoradLunarSolarEpoch(double jdEpoch);
+
+//////////////////////////////////////////////////////////////////////////////
+// cLunarSolarCache
+// cLunarSolarEpoch terms for the epochs seen so far, so a batch of deep
+// space objects evaluates them once per distinct epoch.
+//
+// With the default tolerance of 0 only identical epochs share terms, and
+// kernels are bit-identical to uncached ones. With a tolerance, time is
+// cut into slots of 'toleranceMin' minutes and every epoch in a slot
+// uses the lunar-solar geometry of the slot's start. The GMST and the
+// lunar and solar mean anomalies (zmol, zmos) change quickly, so they
+// are moved from there to the exact epoch; the geometry left over drifts
+// by about 3.0e-03 radian per day. The terms of an epoch depend only on
+// the epoch and the tolerance, not on which epochs were seen before.
+class cLunarSolarCache
+{
+public:
+   explicit cLunarSolarCache(double toleranceMin = 0.0) :
+      m_TolDays(toleranceMin / MIN_PER_DAY),
+      m_Hits(0)
+   {
+   }
+
+   cLunarSolarEpoch Find(double jdEpoch);
+
+   size_t Size() const { return m_Epochs.size(); }
+   size_t Hits() const { return m_Hits; }
+
+protected:
+   static double Wrap2p(double arg);
+
+   std::unordered_map<long long, cLunarSolarEpoch> m_Epochs;
+   double m_TolDays;
+   size_t m_Hits;
+};
+
+//////////////////////////////////////////////////////////////////////////////
+// NoradElementsFromTle()
+// Decode the two data lines of a TLE straight into mean elements, with the
+// same field parsing as cTle and the same mean motion recovery as cOrbit.
+// Unlike cTle/cOrbit this needs no heap memory. Returns false if a line is
+// too short or does not start with its line number.
+inline bool NoradElementsFromTle(const char *line1, const char *line2, cNoradElements *pEl);
+
+//////////////////////////////////////////////////////////////////////////////
+// cSgp4Kernel
+// The SGP4 ("near earth") model as a value type. 'Simple' must equal
+// NoradIsSimple() for the elements; the propagation loop then has no
+// model branches.
+template <typename Real, bool Simple>
+class cSgp4Kernel : public cNoradFinal<Real>
+{
+public:
+   explicit cSgp4Kernel(const cNoradElements &el);
+
+   // Position and velocity at 'tsince' minutes past the TLE epoch.
+   eNoradResult Propagate(double tsince, Real pos[3], Real vel[3]) const
+   {
+      return Evaluate<true>(tsince, pos, vel);
+   }
+
+   // Position only.
+   eNoradResult Position(double tsince, Real pos[3]) const
+   {
+      return Evaluate<false>(tsince, pos, nullptr);
+   }
+
+   double EpochJd() const { return m_jdEpoch; }
+
+protected:
+   template <bool Velocity>
+   eNoradResult Evaluate(double tsince, Real pos[3], Real vel[3]) const;
+
+   // Secular rates are kept in double; see note at top of file.
+   double m_jdEpoch;
+   double m_MeanAnomaly;   double m_ArgPerigee;   double m_RAAN;
+   double m_xmdot;         double m_omgdot;       double m_xnodot;
+   double m_xnodcf;        double m_t2cof;        double m_MeanMotion;
+   double m_omgcof;
+
+   Real m_Inclination;     Real m_Eccentricity;   Real m_SemiMajor;
+   Real m_BStar;           Real m_c1;             Real m_c4;
+   Real m_c5;              Real m_xmcof;          Real m_eta;
+   Real m_delmo;           Real m_sinmo;
+   Real m_d2;              Real m_d3;             Real m_d4;
+   Real m_t3cof;           Real m_t4cof;          Real m_t5cof;
+};
+
+//////////////////////////////////////////////////////////////////////////////
+// cSdp4Kernel
+// The SDP4 ("deep space") model as a value type, double precision only.
+// 'Res' must equal NoradResonance() for the elements.
+//
+// cNoradSDP4 keeps the resonance integrator state between calls and steps
+// from wherever the last call left it. This kernel has no mutable state:
+// every call integrates from the epoch, which is what cNoradSDP4 does on
+// its first call, so results are identical to a freshly made cOrbit.
+template <eResonance Res>
+class cSdp4Kernel : public cNoradFinal<double>
+{
+public:
+   explicit cSdp4Kernel(const cNoradElements &el);
+
+   // With the epoch terms already evaluated, e.g. by cLunarSolarCache
+   cSdp4Kernel(const cNoradElements &el, const cLunarSolarEpoch &ls);
+
+   eNoradResult Propagate(double tsince, double pos[3], double vel[3]) const
+   {
+      return Evaluate<true>(tsince, pos, vel);
+   }
+
+   eNoradResult Position(double tsince, double pos[3]) const
+   {
+      return Evaluate<false>(tsince, pos, nullptr);
+   }
+
+   double EpochJd() const { return m_jdEpoch; }
+
+protected:
+   template <bool Velocity>
+   eNoradResult Evaluate(double tsince, double pos[3], double vel[3]) const;
+
+   void DeepSecular(double *xmdf,  double *omgadf, double *xnode, double *emm,
+                    double *xincc, double *xnn,    double tsince) const;
+   void DeepDotTerms(double xli, double xni, double atime,
+                     double *pxndot, double *pxnddt, double *pxldot) const;
+   void DeepPeriodics(double *e,     double *xincc, double *omgadf,
+                      double *xnode, double *xmam,  double tsince) const;
+
+   double m_jdEpoch;
+   double m_Inclination;   double m_Eccentricity;  double m_RAAN;
+   double m_ArgPerigee;    double m_MeanAnomaly;   double m_BStar;
+   double m_MeanMotion;
+   double m_xmdot;         double m_omgdot;        double m_xnodot;
+   double m_xnodcf;        double m_t2cof;         double m_c1;
+   double m_c4;
+
+   // Lunar-solar terms
+   double dp_e3;     double dp_ee2;    double dp_se2;    double dp_se3;
+   double dp_sgh2;   double dp_sgh3;   double dp_sgh4;   double dp_sh2;
+   double dp_sh3;    double dp_si2;    double dp_si3;    double dp_sl2;
+   double dp_sl3;    double dp_sl4;    double dp_xgh2;   double dp_xgh3;
+   double dp_xgh4;   double dp_xh2;    double dp_xh3;    double dp_xi2;
+   double dp_xi3;    double dp_xl2;    double dp_xl3;    double dp_xl4;
+   double dp_zmol;   double dp_zmos;
+   double dp_sse;    double dp_ssg;    double dp_ssh;    double dp_ssi;
+   double dp_ssl;    double dp_thgr;
+
+   // Resonance terms
+   double dp_d2201;  double dp_d2211;  double dp_d3210;  double dp_d3222;
+   double dp_d4410;  double dp_d4422;  double dp_d5220;  double dp_d5232;
+   double dp_d5421;  double dp_d5433;  double dp_del1;   double dp_del2;
+   double dp_del3;   double dp_xfact;  double dp_xlamo;
+
+   bool m_lyddane;   // inclination < 0.2 rad: apply periodics with Lyddane modification
+
+   static constexpr double zes  = 0.01675;
+   static constexpr double zel  = 0.05490;
+   static constexpr double zns  = 1.19459e-05;
+   static constexpr double znl  = 1.5835218e-04;
+   static constexpr double thdt = 4.3752691e-03;
+
+   static constexpr double dp_stepp = 720.0;
+   static constexpr double dp_stepn = -720.0;
+   static constexpr double dp_step2 = 259200.0;
+};
+
+//////////////////////////////////////////////////////////////////////////////
+// cNoradModel
+// Any one of the double precision kernels, chosen from the elements when
+// it is made. This is the single-object counterpart of a batch of one
+// kernel type: one trivially copyable value with no heap memory, at the
+// cost of one jump-table dispatch per call.
+class cNoradModel
+{
+public:
+   typedef double RealType;
+
+   explicit cNoradModel(const cNoradElements &el);
+
+   eNoradResult Propagate(double tsince, double pos[3], double vel[3]) const
+   {
+      return std::visit([&](const auto &k) { return k.Propagate(tsince, pos, vel); }, m_Kernel);
+   }
+
+   eNoradResult Position(double tsince, double pos[3]) const
+   {
+      return std::visit([&](const auto &k) { return k.Position(tsince, pos); }, m_Kernel);
+   }
+
+   double EpochJd() const
+   {
+      return std::visit([](const auto &k) { return k.EpochJd(); }, m_Kernel);
+   }
+
+protected:
+   std::variant<cSgp4Kernel<double, true>,
+                cSgp4Kernel<double, false>,
+                cSdp4Kernel<RES_NONE>,
+                cSdp4Kernel<RES_12H>,
+                cSdp4Kernel<RES_24H>> m_Kernel;
+
+   static decltype(m_Kernel) MakeKernel(const cNoradElements &el);
+};
+
+//////////////////////////////////////////////////////////////////////////////
+template <typename Real>
+cNoradFinal<Real>::cNoradFinal(const cNoradElements &el)
+{
+   const double a3ovk2 = -XJ3 / CK2 * pow(AE, 3.0);
+   const double sinip  = sin(el.m_Inclination);
+   const double cosip  = cos(el.m_Inclination);
+   const double cosip2 = cosip * cosip;
+
+   m_sinio  = Real(sinip);
+   m_cosio  = Real(cosip);
+   m_aycof  = Real(0.25 * a3ovk2 * sinip);
+   m_xlcof  = Real((0.125 * a3ovk2 * sinip * (3.0 + 5.0 * cosip)) / (1.0 + cosip));
+   m_x3thm1 = Real(3.0 * cosip2 - 1.0);
+   m_x1mth2 = Real(1.0 - cosip2);
+   m_x7thm1 = Real(7.0 * cosip2 - 1.0);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+template <typename Real>
+template <bool Velocity>
+eNoradResult cNoradFinal<Real>::FinalPosition(Real incl, Real omega, Real e, Real a,
+                                              Real xl, Real xnode, Real xn,
+                                              Real pos[3], Real vel[3]) const
+{
+   const Real one = Real(1.0);
+
+   if ((e * e) > one)
+   {
+      return NORAD_ECCENTRICITY;
+   }
+
+   // Drag can take a to 0 (or the elements make it NaN); cNoradBase goes
+   // on and returns a position that is not a number.
+   if (!(a > Real(0.0)))
+   {
+      return NORAD_BAD_ELEMENTS;
+   }
+
+   Real beta = std::sqrt(one - e * e);
+
+   // Long period periodics
+   Real axn  = e * std::cos(omega);
+   Real temp = one / (a * beta * beta);
+   Real xll  = temp * m_xlcof * axn;
+   Real aynl = temp * m_aycof;
+   Real xlt  = xl + xll;
+   Real ayn  = e * std::sin(omega) + aynl;
+
+   // Same convergence test as cNoradBase; single precision resolves it
+   // (float spacing near 2PI is ~5.0e-07) and the pass count is capped.
+   const Real E6A = Real(1.0e-06);
+
+   // Solve Kepler's Equation
+   Real capu   = Real(NoradReduce(double(xlt - xnode)));
+   Real temp2  = capu;
+   Real temp3  = 0;
+   Real temp4  = 0;
+   Real temp5  = 0;
+   Real temp6  = 0;
+   Real sinepw = 0;
+   Real cosepw = 0;
+   bool fDone  = false;
+
+   for (int i = 1; (i <= 10) && !fDone; i++)
+   {
+      sinepw = std::sin(temp2);
+      cosepw = std::cos(temp2);
+      temp3 = axn * sinepw;
+      temp4 = ayn * cosepw;
+      temp5 = axn * cosepw;
+      temp6 = ayn * sinepw;
+
+      Real epw = (capu - temp4 + temp3 - temp2) /
+                 (one - temp5 - temp6) + temp2;
+
+      if (std::fabs(epw - temp2) <= E6A)
+      {
+         fDone = true;
+      }
+      else
+      {
+         temp2 = epw;
+      }
+   }
+
+   // Short period preliminary quantities
+   Real ecose = temp5 + temp6;
+   Real esine = temp3 - temp4;
+   Real elsq  = axn * axn + ayn * ayn;
+   temp  = one - elsq;
+   Real pl = a * temp;
+   Real r  = a * (one - ecose);
+   Real temp1 = one / r;
+   Real rdot  = 0;
+   Real rfdot = 0;
+
+   if constexpr (Velocity)
+   {
+      rdot  = Real(XKE) * std::sqrt(a) * esine * temp1;
+      rfdot = Real(XKE) * std::sqrt(pl) * temp1;
+   }
+
+   temp2 = a * temp1;
+   Real betal = std::sqrt(temp);
+   temp3 = one / (one + betal);
+   Real cosu  = temp2 * (cosepw - axn + ayn * esine * temp3);
+   Real sinu  = temp2 * (sinepw - ayn - axn * esine * temp3);
+   Real u     = std::atan2(sinu, cosu);
+   Real sin2u = Real(2.0) * sinu * cosu;
+   Real cos2u = Real(2.0) * cosu * cosu - one;
+
+   temp  = one / pl;
+   temp1 = Real(CK2) * temp;
+   temp2 = temp1 * temp;
+
+   // Update for short periodics
+   Real rk = r * (one - Real(1.5) * temp2 * betal * m_x3thm1) +
+             Real(0.5) * temp1 * m_x1mth2 * cos2u;
+   Real uk = u - Real(0.25) * temp2 * m_x7thm1 * sin2u;
+   Real xnodek = xnode + Real(1.5) * temp2 * m_cosio * sin2u;
+   Real xinck  = incl + Real(1.5) * temp2 * m_cosio * m_sinio * cos2u;
+
+   // Orientation vectors
+   Real sinuk  = std::sin(uk);
+   Real cosuk  = std::cos(uk);
+   Real sinik  = std::sin(xinck);
+   Real cosik  = std::cos(xinck);
+   Real sinnok = std::sin(xnodek);
+   Real cosnok = std::cos(xnodek);
+   Real xmx = -sinnok * cosik;
+   Real xmy = cosnok * cosik;
+   Real ux  = xmx * sinuk + cosnok * cosuk;
+   Real uy  = xmy * sinuk + sinnok * cosuk;
+   Real uz  = sinik * sinuk;
+
+   // Position
+   pos[0] = rk * ux;
+   pos[1] = rk * uy;
+   pos[2] = rk * uz;
+
+   // Validate on altitude
+   const Real radius = std::sqrt(pos[0] * pos[0] + pos[1] * pos[1] + pos[2] * pos[2]);
+
+   if (radius < Real(AE))
+   {
+      return NORAD_DECAYED;
+   }
+
+   if (!(radius == radius))
+   {
+      return NORAD_BAD_ELEMENTS;
+   }
+
+   if constexpr (Velocity)
+   {
+      Real rdotk  = rdot - xn * temp1 * m_x1mth2 * sin2u;
+      Real rfdotk = rfdot + xn * temp1 * (m_x1mth2 * cos2u + Real(1.5) * m_x3thm1);
+      Real vx = xmx * cosuk - cosnok * sinuk;
+      Real vy = xmy * cosuk - sinnok * sinuk;
+      Real vz = sinik * cosuk;
+
+      // Velocity
+      vel[0] = rdotk * ux + rfdotk * vx;
+      vel[1] = rdotk * uy + rfdotk * vy;
+      vel[2] = rdotk * uz + rfdotk * vz;
+   }
+
+   return NORAD_OK;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// Copy one fixed-column TLE field into 'buf' and convert it with strtod(),
+// as cTle does with atof(). 'prefix' is prepended (cTle uses "0." for the
+// eccentricity).
+inline double NoradTleField(const char *line, int col, int len, const char *prefix = "")
+{
+   char buf[32];
+   int  n = 0;
+
+   while (*prefix)
+   {
+      buf[n++] = *prefix++;
+   }
+
+   for (int i = 0; i < len; i++)
+   {
+      buf[n++] = line[col + i];
+   }
+
+   buf[n] = '\0';
+
+   return strtod(buf, NULL);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// Convert a TLE exponential field such as " 12345-3" (0.12345e-3); see
+// cTle::ExpToAtof().
+inline double NoradTleExpField(const char *line, int col)
+{
+   char buf[16];
+   int  n = 0;
+
+   buf[n++] = line[col];           // sign
+   buf[n++] = '0';
+   buf[n++] = '.';
+
+   for (int i = 1; i <= 5; i++)
+   {
+      buf[n++] = line[col + i];    // mantissa
+   }
+
+   buf[n++] = 'e';
+
+   for (int i = 6; i <= 7; i++)
+   {
+      if (line[col + i] != ' ')
+      {
+         buf[n++] = line[col + i]; // exponent
+      }
+   }
+
+   buf[n] = '\0';
+
+   return strtod(buf, NULL);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+inline bool NoradElementsFromTle(const char *line1, const char *line2, cNoradElements *pEl)
+{
+   // Column offsets are zero based; see cTle.cpp
+   const int TLE1_LEN_USED = 61;   // through BSTAR
+   const int TLE2_LEN_USED = 63;   // through mean motion
+
+   for (int i = 0; i < TLE1_LEN_USED; i++)
+   {
+      if (line1[i] == '\0') { return false; }
+   }
+
+   for (int i = 0; i < TLE2_LEN_USED; i++)
+   {
+      if (line2[i] == '\0') { return false; }
+   }
+
+   if ((line1[0] != '1') || (line2[0] != '2'))
+   {
+      return false;
+   }
+
+   int    epochYear = (int)NoradTleField(line1, 18, 2);
+   double epochDay  = NoradTleField(line1, 20, 12);
+
+   if (epochYear < 57)
+   {
+      epochYear += 2000;
+   }
+   else
+   {
+      epochYear += 1900;
+   }
+
+   const cJulian jdEpoch(epochYear, epochDay);
+
+   pEl->m_jdEpoch      = jdEpoch.Date();
+   pEl->m_BStar        = NoradTleExpField(line1, 53) / AE;
+   pEl->m_Inclination  = NoradTleField(line2,  8,  8) * RADS_PER_DEG;
+   pEl->m_RAAN         = NoradTleField(line2, 17,  8) * RADS_PER_DEG;
+   pEl->m_Eccentricity = NoradTleField(line2, 26,  7, "0.");
+   pEl->m_ArgPerigee   = NoradTleField(line2, 34,  8) * RADS_PER_DEG;
+   pEl->m_MeanAnomaly  = NoradTleField(line2, 43,  8) * RADS_PER_DEG;
+
+   // Recover the original mean motion and semimajor axis from the
+   // input elements; see cOrbit::cOrbit().
+   double mm     = NoradTleField(line2, 52, 11);
+   double rpmin  = mm * TWOPI / MIN_PER_DAY;   // rads per minute
+
+   double a1     = pow(XKE / rpmin, 2.0 / 3.0);
+   double e      = pEl->m_Eccentricity;
+   double i      = pEl->m_Inclination;
+   double temp   = (1.5 * CK2 * (3.0 * sqr(cos(i)) - 1.0) /
+                   pow(1.0 - e * e, 1.5));
+   double delta1 = temp / (a1 * a1);
+   double a0     = a1 *
+                   (1.0 - delta1 *
+                   ((1.0 / 3.0) + delta1 *
+                   (1.0 + 134.0 / 81.0 * delta1)));
+
+   double delta0 = temp / (a0 * a0);
+
+   pEl->m_MeanMotion = rpmin / (1.0 + delta0);
+   pEl->m_SemiMajor  = a0 / (1.0 - delta0);
+
+   return true;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+inline cNoradInit::cNoradInit(const cNoradElements &el)
+{
+   // Same as cNoradBase::Initialize()
+   m_sinio = sin(el.m_Inclination);
+   m_cosio = cos(el.m_Inclination);
+
+   const double aodp   = el.m_SemiMajor;
+   const double ecc    = el.m_Eccentricity;
+   const double xnodp  = el.m_MeanMotion;
+   const double theta2 = m_cosio * m_cosio;
+   const double x3thm1 = 3.0 * theta2 - 1.0;
+   const double eosq   = sqr(ecc);
+
+   m_betao2 = 1.0 - eosq;
+   m_betao  = sqrt(m_betao2);
+
+   // For perigee below 156 km, the values of S and QOMS2T are altered.
+   double rp      = aodp * (1.0 - ecc);
+   double perigee = (rp - 1.0) * XKMPER_WGS72;
+   double qoms24  = QOMS2T;
+
+   m_s4 = S;
+
+   if (perigee < 156.0)
+   {
+      m_s4 = perigee - 78.0;
+
+      if (perigee <= 98.0)
+      {
+         m_s4 = 20.0;
+      }
+
+      qoms24 = pow((120.0 - m_s4) * AE / XKMPER_WGS72, 4.0);
+      m_s4 = m_s4 / XKMPER_WGS72 + AE;
+   }
+
+   const double pinvsq = 1.0 / (sqr(aodp) * sqr(m_betao2));
+
+   m_tsi  = 1.0 / (aodp - m_s4);
+   m_eta  = aodp * ecc * m_tsi;
+   m_eeta = ecc * m_eta;
+
+   const double etasq = m_eta * m_eta;
+   const double psisq = fabs(1.0 - etasq);
+
+   m_coef  = qoms24 * pow(m_tsi, 4.0);
+   m_coef1 = m_coef / pow(psisq, 3.5);
+
+   const double c2 = m_coef1 * xnodp *
+                     (aodp * (1.0 + 1.5 * etasq + m_eeta * (4.0 + etasq)) +
+                     0.75 * CK2 * m_tsi / psisq * x3thm1 *
+                     (8.0 + 3.0 * etasq * (8.0 + etasq)));
+
+   const double a3ovk2 = -XJ3 / CK2 * pow(AE, 3.0);
+
+   m_c1 = el.m_BStar * c2;
+   m_c3 = m_coef * m_tsi * a3ovk2 * xnodp * AE * m_sinio / ecc;
+
+   const double x1mth2 = 1.0 - theta2;
+
+   m_c4 = 2.0 * xnodp * m_coef1 * aodp * m_betao2 *
+          (m_eta * (2.0 + 0.5 * etasq) +
+          ecc * (0.5 + 2.0 * etasq) -
+          2.0 * CK2 * m_tsi / (aodp * psisq) *
+          (-3.0 * x3thm1 * (1.0 - 2.0 * m_eeta + etasq * (1.5 - 0.5 * m_eeta)) +
+          0.75 * x1mth2 *
+          (2.0 * etasq - m_eeta * (1.0 + etasq)) *
+          cos(2.0 * el.m_ArgPerigee)));
+
+   const double theta4 = theta2 * theta2;
+   const double temp1  = 3.0 * CK2 * pinvsq * xnodp;
+   const double temp2  = temp1 * CK2 * pinvsq;
+   const double temp3  = 1.25 * CK4 * pinvsq * pinvsq * xnodp;
+
+   m_xmdot = xnodp + 0.5 * temp1 * m_betao * x3thm1 +
+             0.0625 * temp2 * m_betao *
+             (13.0 - 78.0 * theta2 + 137.0 * theta4);
+
+   const double x1m5th = 1.0 - 5.0 * theta2;
+
+   m_omgdot = -0.5 * temp1 * x1m5th + 0.0625 * temp2 *
+              (7.0 - 114.0 * theta2 +  395.0 * theta4) +
+              temp3 * (3.0 - 36.0 * theta2 + 49.0 * theta4);
+
+   const double xhdot1 = -temp1 * m_cosio;
+
+   m_xnodot = xhdot1 + (0.5 * temp2 * (4.0 - 19.0 * theta2) +
+              2.0 * temp3 * (3.0 - 7.0 * theta2)) * m_cosio;
+   m_xnodcf = 3.5 * m_betao2 * xhdot1 * m_c1;
+   m_t2cof  = 1.5 * m_c1;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+template <typename Real, bool Simple>
+cSgp4Kernel<Real, Simple>::cSgp4Kernel(const cNoradElements &el) :
+   cNoradFinal<Real>(el)
+{
+   const cNoradInit init(el);
+   const double aodp  = el.m_SemiMajor;
+   const double etasq = init.m_eta * init.m_eta;
+
+   // Same as cNoradSGP4::cNoradSGP4()
+   const double c5 = 2.0 * init.m_coef1 * aodp * init.m_betao2 *
+                     (1.0 + 2.75 * (etasq + init.m_eeta) + init.m_eeta * etasq);
+
+   m_omgcof = el.m_BStar * init.m_c3 * cos(el.m_ArgPerigee);
+
+   const double xmcof = -(2.0 / 3.0) * init.m_coef * el.m_BStar * AE / init.m_eeta;
+   const double delmo = pow(1.0 + init.m_eta * cos(el.m_MeanAnomaly), 3.0);
+
+   // cNoradSGP4::GetPosition() works these terms out on every call;
+   // here they are done once.
+   double d2 = 0.0;
+   double d3 = 0.0;
+   double d4 = 0.0;
+   double t3cof = 0.0;
+   double t4cof = 0.0;
+   double t5cof = 0.0;
+
+   if (!Simple)
+   {
+      const double c1   = init.m_c1;
+      const double c1sq = c1 * c1;
+      const double tsi  = init.m_tsi;
+      const double s4   = init.m_s4;
+
+      d2 = 4.0 * aodp * tsi * c1sq;
+
+      double temp = d2 * tsi * c1 / 3.0;
+
+      d3 = (17.0 * aodp + s4) * temp;
+      d4 = 0.5 * temp * aodp * tsi * (221.0 * aodp + 31.0 * s4) * c1;
+      t3cof = d2 + 2.0 * c1sq;
+      t4cof = 0.25 * (3.0 * d3 + c1 * (12.0 * d2 + 10.0 * c1sq));
+      t5cof = 0.2 * (3.0 * d4 + 12.0 * c1 * d3 + 6.0 *
+              d2 * d2 + 15.0 * c1sq * (2.0 * d2 + c1sq));
+   }
+
+   m_jdEpoch     = el.m_jdEpoch;
+   m_MeanAnomaly = el.m_MeanAnomaly;
+   m_ArgPerigee  = el.m_ArgPerigee;
+   m_RAAN        = el.m_RAAN;
+   m_MeanMotion  = el.m_MeanMotion;
+   m_xmdot  = init.m_xmdot;
+   m_omgdot = init.m_omgdot;
+   m_xnodot = init.m_xnodot;
+   m_xnodcf = init.m_xnodcf;
+   m_t2cof  = init.m_t2cof;
+
+   m_Inclination  = Real(el.m_Inclination);
+   m_Eccentricity = Real(el.m_Eccentricity);
+   m_SemiMajor    = Real(aodp);
+   m_BStar        = Real(el.m_BStar);
+   m_c1    = Real(init.m_c1);
+   m_c4    = Real(init.m_c4);
+   m_c5    = Real(c5);
+   m_xmcof = Real(xmcof);
+   m_eta   = Real(init.m_eta);
+   m_delmo = Real(delmo);
+   m_sinmo = Real(sin(el.m_MeanAnomaly));
+   m_d2    = Real(d2);
+   m_d3    = Real(d3);
+   m_d4    = Real(d4);
+   m_t3cof = Real(t3cof);
+   m_t4cof = Real(t4cof);
+   m_t5cof = Real(t5cof);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// Evaluate()
+// See cNoradSGP4::GetPosition().
+template <typename Real, bool Simple>
+template <bool Velocity>
+eNoradResult cSgp4Kernel<Real, Simple>::Evaluate(double tsince, Real pos[3], Real vel[3]) const
+{
+   const Real one = Real(1.0);
+
+   // Update for secular gravity and atmospheric drag.
+   double xmdf   = m_MeanAnomaly + m_xmdot * tsince;
+   double omgadf = m_ArgPerigee  + m_omgdot * tsince;
+   double xnoddf = m_RAAN + m_xnodot * tsince;
+   double tsq    = tsince * tsince;
+   double xnode  = xnoddf + m_xnodcf * tsq;
+   double omega  = omgadf;
+   double xmp    = xmdf;
+   Real   t      = Real(tsince);
+   Real   tempa  = one - m_c1 * t;
+   Real   tempe  = m_BStar * m_c4 * t;
+   double templ  = m_t2cof * tsq;
+
+   if constexpr (!Simple)
+   {
+      double delomg = m_omgcof * tsince;
+      Real   delm   = m_xmcof * (std::pow(one + m_eta * std::cos(Real(NoradReduce(xmdf))), Real(3.0)) - m_delmo);
+      double temp   = delomg + double(delm);
+
+      xmp   = xmdf   + temp;
+      omega = omgadf - temp;
+
+      double tcube = tsq * tsince;
+      double tfour = tsince * tcube;
+
+      tempa = tempa - m_d2 * Real(tsq) - m_d3 * Real(tcube) - m_d4 * Real(tfour);
+      tempe = tempe + m_BStar * m_c5 * (std::sin(Real(NoradReduce(xmp))) - m_sinmo);
+      templ = templ + double(m_t3cof) * tcube + tfour * (double(m_t4cof) + tsince * double(m_t5cof));
+   }
+
+   Real   a  = m_SemiMajor * tempa * tempa;
+   Real   e  = m_Eccentricity - tempe;
+   double xl = xmp + omega + xnode + m_MeanMotion * templ;
+   Real   xn = Real(XKE) / std::pow(a, Real(1.5));
+
+   return this->template FinalPosition<Velocity>(m_Inclination, Real(NoradReduce(omgadf)), e, a,
+                              Real(NoradReduce(xl)), Real(NoradReduce(xnode)), xn,
+                              pos, vel);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+template <eResonance Res>
+cSdp4Kernel<Res>::cSdp4Kernel(const cNoradElements &el) :
+   cSdp4Kernel(el, NoradLunarSolarEpoch(el.m_jdEpoch))
+{
+}
+
+//////////////////////////////////////////////////////////////////////////////
+template <eResonance Res>
+cSdp4Kernel<Res>::cSdp4Kernel(const cNoradElements &el, const cLunarSolarEpoch &ls) :
+   cNoradFinal<double>(el)
+{
+   const cNoradInit init(el);
+
+   m_jdEpoch      = el.m_jdEpoch;
+   m_Inclination  = el.m_Inclination;
+   m_Eccentricity = el.m_Eccentricity;
+   m_RAAN         = el.m_RAAN;
+   m_ArgPerigee   = el.m_ArgPerigee;
+   m_MeanAnomaly  = el.m_MeanAnomaly;
+   m_BStar        = el.m_BStar;
+   m_MeanMotion   = el.m_MeanMotion;
+   m_xmdot  = init.m_xmdot;
+   m_omgdot = init.m_omgdot;
+   m_xnodot = init.m_xnodot;
+   m_xnodcf = init.m_xnodcf;
+   m_t2cof  = init.m_t2cof;
+   m_c1     = init.m_c1;
+   m_c4     = init.m_c4;
+   m_lyddane = (el.m_Inclination < 0.2);
+
+   // Same as cNoradSDP4::cNoradSDP4()
+   const double sinio  = init.m_sinio;
+   const double cosio  = init.m_cosio;
+   const double betao  = init.m_betao;
+   const double betao2 = init.m_betao2;
+
+   double sinarg = sin(el.m_ArgPerigee);
+   double cosarg = cos(el.m_ArgPerigee);
+   double eqsq   = sqr(el.m_Eccentricity);
+
+   // Deep space initialization
+   dp_thgr = ls.m_Gmst;
+
+   double eq     = el.m_Eccentricity;
+   double aqnv   = 1.0 / el.m_SemiMajor;
+   double xmao   = el.m_MeanAnomaly;
+   double xpidot = m_omgdot + m_xnodot;
+   double sinq   = sin(el.m_RAAN);
+   double cosq   = cos(el.m_RAAN);
+
+   // Lunar solar terms
+   dp_zmol = ls.m_zmol;
+   dp_zmos = ls.m_zmos;
+
+   const double dpi_zcosil = ls.m_zcosil;
+   const double dpi_zsinil = ls.m_zsinil;
+   const double dpi_zcoshl = ls.m_zcoshl;
+   const double dpi_zsinhl = ls.m_zsinhl;
+   const double dpi_zcosgl = ls.m_zcosgl;
+   const double dpi_zsingl = ls.m_zsingl;
+
+   const double zcosis = 0.91744867;
+   const double zsinis = 0.39785416;
+   const double c1ss   = 2.9864797e-06;
+   const double zsings = -0.98088458;
+   const double zcosgs =  0.1945905;
+
+   double zcosg = zcosgs;
+   double zsing = zsings;
+   double zcosi = zcosis;
+   double zsini = zsinis;
+   double zcosh = cosq;
+   double zsinh = sinq;
+   double cc  = c1ss;
+   double zn  = zns;
+   double ze  = zes;
+   double xnoi = 1.0 / el.m_MeanMotion;
+
+   double se  = 0.0;  double si = 0.0;  double sl = 0.0;
+   double sgh = 0.0;  double sh = 0.0;
+
+   // Apply the solar and lunar terms on the first pass, then re-apply the
+   // solar terms again on the second pass.
+
+   for (int pass = 1; pass <= 2; pass++)
+   {
+      // Do solar terms
+      double a1  =  zcosg * zcosh + zsing * zcosi * zsinh;
+      double a3  = -zsing * zcosh + zcosg * zcosi * zsinh;
+      double a7  = -zcosg * zsinh + zsing * zcosi * zcosh;
+      double a8  = zsing * zsini;
+      double a9  = zsing * zsinh + zcosg * zcosi * zcosh;
+      double a10 = zcosg * zsini;
+
+      double a2 = cosio * a7 +  sinio * a8;
+      double a4 = cosio * a9 +  sinio * a10;
+      double a5 = -sinio * a7 +  cosio * a8;
+      double a6 = -sinio * a9 +  cosio * a10;
+      double x1 = a1 * cosarg + a2 * sinarg;
+      double x2 = a3 * cosarg + a4 * sinarg;
+      double x3 = -a1 * sinarg + a2 * cosarg;
+      double x4 = -a3 * sinarg + a4 * cosarg;
+      double x5 = a5 * sinarg;
+      double x6 = a6 * sinarg;
+      double x7 = a5 * cosarg;
+      double x8 = a6 * cosarg;
+      double z31 = 12.0 * x1 * x1 - 3.0 * x3 * x3;
+      double z32 = 24.0 * x1 * x2 - 6.0 * x3 * x4;
+      double z33 = 12.0 * x2 * x2 - 3.0 * x4 * x4;
+      double z1 = 3.0 * (a1 * a1 + a2 * a2) + z31 * eqsq;
+      double z2 = 6.0 * (a1 * a3 + a2 * a4) + z32 * eqsq;
+      double z3 = 3.0 * (a3 * a3 + a4 * a4) + z33 * eqsq;
+      double z11 = -6.0 * a1 * a5 + eqsq*(-24.0 * x1 * x7 - 6.0 * x3 * x5);
+      double z12 = -6.0 * (a1 * a6 + a3 * a5) +
+                   eqsq * (-24.0 * (x2 * x7 + x1 * x8) - 6.0 * (x3 * x6 + x4 * x5));
+      double z13 = -6.0 * a3 * a6 + eqsq * (-24.0 * x2 * x8 - 6.0 * x4 * x6);
+      double z21 = 6.0 * a2 * a5 + eqsq * (24.0 * x1 * x5 - 6.0 * x3 * x7);
+      double z22 = 6.0*(a4 * a5 + a2 * a6) +
+                   eqsq * (24.0 * (x2 * x5 + x1 * x6) - 6.0 * (x4 * x7 + x3 * x8));
+      double z23 = 6.0 * a4 * a6 + eqsq*(24.0 * x2 * x6 - 6.0 * x4 * x8);
+      z1 = z1 + z1 + betao2 * z31;
+      z2 = z2 + z2 + betao2 * z32;
+      z3 = z3 + z3 + betao2 * z33;
+      double s3  = cc * xnoi;
+      double s2  = -0.5 * s3 / betao;
+      double s4  = s3 * betao;
+      double s1  = -15.0 * eq * s4;
+      double s5  = x1 * x3 + x2 * x4;
+      double s6  = x2 * x3 + x1 * x4;
+      double s7  = x2 * x4 - x1 * x3;
+      se  = s1 * zn * s5;
+      si  = s2 * zn * (z11 + z13);
+      sl  = -zn * s3 * (z1 + z3 - 14.0 - 6.0 * eqsq);
+      sgh =  s4 * zn * (z31 + z33 - 6.0);
+      sh  = -zn * s2 * (z21 + z23);
+
+      if (el.m_Inclination < 5.2359877E-2)
+      {
+         // Term not used for inclinations < 3.0 degrees
+         sh = 0.0;
+      }
+
+      dp_ee2 =  2.0 * s1 * s6;
+      dp_e3  =  2.0 * s1 * s7;
+      dp_xi2 =  2.0 * s2 * z12;
+      dp_xi3 =  2.0 * s2 * (z13 - z11);
+      dp_xl2 = -2.0 * s3 * z2;
+      dp_xl3 = -2.0 * s3 * (z3 - z1);
+      dp_xl4 = -2.0 * s3 * (-21.0 - 9.0 * eqsq) * ze;
+      dp_xgh2 = 2.0 * s4 * z32;
+      dp_xgh3 = 2.0 * s4 * (z33 - z31);
+      dp_xgh4 = -18.0 * s4 * ze;
+      dp_xh2 = -2.0 * s2 * z22;
+      dp_xh3 = -2.0 * s2 * (z23 - z21);
+
+      if (pass == 1)
+      {
+         // Do lunar terms
+         dp_sse = se;
+         dp_ssi = si;
+         dp_ssl = sl;
+         dp_ssh = (sh == 0.0) ? 0.0 : (sh / sinio);
+         dp_ssg = sgh - cosio * dp_ssh;
+         dp_se2 = dp_ee2;
+         dp_si2 = dp_xi2;
+         dp_sl2 = dp_xl2;
+         dp_sgh2 = dp_xgh2;
+         dp_sh2 = dp_xh2;
+         dp_se3 = dp_e3;
+         dp_si3 = dp_xi3;
+         dp_sl3 = dp_xl3;
+         dp_sgh3 = dp_xgh3;
+         dp_sh3 = dp_xh3;
+         dp_sl4 = dp_xl4;
+         dp_sgh4 = dp_xgh4;
+         zcosg = dpi_zcosgl;
+         zsing = dpi_zsingl;
+         zcosi = dpi_zcosil;
+         zsini = dpi_zsinil;
+         zcosh = dpi_zcoshl * cosq + dpi_zsinhl * sinq;
+         zsinh = sinq * dpi_zcoshl - cosq * dpi_zsinhl;
+         zn = znl;
+
+         const double c1l = 4.7968065e-07;
+
+         cc = c1l;
+         ze = zel;
+      }
+   }
+
+   dp_sse = dp_sse + se;
+   dp_ssi = dp_ssi + si;
+   dp_ssl = dp_ssl + sl;
+   dp_ssg = dp_ssg + sgh - ((sh == 0.0) ? 0.0 : (cosio / sinio) * sh);
+   dp_ssh = dp_ssh + ((sh == 0.0) ? 0.0 : (sh / sinio));
+
+   // Geopotential resonance initialization
+   dp_d2201 = 0.0;  dp_d2211 = 0.0;  dp_d3210 = 0.0;  dp_d3222 = 0.0;
+   dp_d4410 = 0.0;  dp_d4422 = 0.0;  dp_d5220 = 0.0;  dp_d5232 = 0.0;
+   dp_d5421 = 0.0;  dp_d5433 = 0.0;  dp_del1  = 0.0;  dp_del2  = 0.0;
+   dp_del3  = 0.0;  dp_xfact = 0.0;  dp_xlamo = 0.0;
+
+   double bfact = 0.0;
+
+   if (Res == RES_24H)
+   {
+      // Synchronous resonance terms initialization
+      double g200 = 1.0 + eqsq * (-2.5 + 0.8125 * eqsq);
+      double g310 = 1.0 + 2.0 * eqsq;
+      double g300 = 1.0 + eqsq * (-6.0 + 6.60937 * eqsq);
+      double f220 = 0.75 * (1.0 + cosio) * (1.0 + cosio);
+      double f311 = 0.9375 * sinio * sinio * (1.0 + 3 * cosio) - 0.75 * (1.0 + cosio);
+      double f330 = 1.0 + cosio;
+
+      const double q22 = 1.7891679e-06;
+      const double q31 = 2.1460748e-06;
+      const double q33 = 2.2123015e-07;
+
+      f330 = 1.875 * f330 * f330 * f330;
+      dp_del1 = 3.0 * el.m_MeanMotion * el.m_MeanMotion * aqnv * aqnv;
+      dp_del2 = 2.0 * dp_del1 * f220 * g200 * q22;
+      dp_del3 = 3.0 * dp_del1 * f330 * g300 * q33 * aqnv;
+      dp_del1 = dp_del1 * f311 * g310 * q31 * aqnv;
+      dp_xlamo = xmao + el.m_RAAN + el.m_ArgPerigee - dp_thgr;
+      bfact = m_xmdot + xpidot - thdt;
+      bfact = bfact + dp_ssl + dp_ssg + dp_ssh;
+   }
+   else if (Res == RES_12H)
+   {
+      double eoc  = eq * eqsq;
+      double g201 = -0.306 - (eq - 0.64) * 0.440;
+
+      double g211;   double g310;   double g322;
+      double g410;   double g422;
+      double g520;
+
+      if (eq <= 0.65)
+      {
+         g211 =    3.616 -  13.247  * eq + 16.290   * eqsq;
+         g310 =  -19.302 +  117.390 * eq - 228.419  * eqsq + 156.591  * eoc;
+         g322 = -18.9068 + 109.7927 * eq - 214.6334 * eqsq + 146.5816 * eoc;
+         g410 =  -41.122 +  242.694 * eq - 471.094  * eqsq +  313.953 * eoc;
+         g422 = -146.407 +  841.880 * eq - 1629.014 * eqsq + 1083.435 * eoc;
+         g520 = -532.114 + 3017.977 * eq - 5740.0   * eqsq + 3708.276 * eoc;
+      }
+      else
+      {
+         g211 =   -72.099 +  331.819 * eq -  508.738 * eqsq +  266.724 * eoc;
+         g310 =  -346.844 + 1582.851 * eq - 2415.925 * eqsq + 1246.113 * eoc;
+         g322 =  -342.585 + 1554.908 * eq - 2366.899 * eqsq + 1215.972 * eoc;
+         g410 = -1052.797 + 4758.686 * eq - 7193.992 * eqsq + 3651.957 * eoc;
+         g422 = -3581.69  + 16178.11 * eq - 24462.77 * eqsq + 12422.52 * eoc;
+
+         if (eq <= 0.715)
+         {
+            g520 = 1464.74 - 4664.75 * eq + 3763.64 * eqsq;
+         }
+         else
+         {
+            g520 = -5149.66 + 29936.92 * eq - 54087.36 * eqsq + 31324.56 * eoc;
+         }
+      }
+
+      double g533;
+      double g521;
+      double g532;
+
+      if (eq < 0.7)
+      {
+         g533 = -919.2277  + 4988.61   * eq - 9064.77   * eqsq + 5542.21  * eoc;
+         g521 = -822.71072 + 4568.6173 * eq - 8491.4146 * eqsq + 5337.524 * eoc;
+         g532 = -853.666   + 4690.25   * eq - 8624.77   * eqsq + 5341.4   * eoc;
+      }
+      else
+      {
+         g533 = -37995.78  + 161616.52 * eq - 229838.2  * eqsq + 109377.94 * eoc;
+         g521 = -51752.104 + 218913.95 * eq - 309468.16 * eqsq + 146349.42 * eoc;
+         g532 = -40023.88  + 170470.89 * eq - 242699.48 * eqsq + 115605.82 * eoc;
+      }
+
+      double sini2  = sqr(sinio);
+      double theta2 = sqr(cosio);
+      double f220   = 0.75 * (1.0 + 2.0 * cosio + theta2);
+
+      const double root22 = 1.7891679e-06;
+      const double root32 = 3.7393792e-07;
+      const double root44 = 7.3636953e-09;
+      const double root52 = 1.1428639e-07;
+      const double root54 = 2.1765803e-09;
+
+      double f221 = 1.5 * sini2;
+      double f321 =  1.875 * sinio * (1.0 - 2.0 * cosio - 3.0 * theta2);
+      double f322 = -1.875 * sinio * (1.0 + 2.0 * cosio - 3.0 * theta2);
+      double f441 = 35.0 * sini2 * f220;
+      double f442 = 39.3750 * sini2 * sini2;
+      double f522 = 9.84375 * sinio * (sini2 * (1.0 - 2.0 * cosio - 5.0 * theta2) +
+                    0.33333333*(-2.0 + 4.0 * cosio + 6.0 * theta2));
+      double f523 = sinio * (4.92187512 * sini2 * (-2.0 - 4.0 * cosio + 10.0 * theta2) +
+                    6.56250012 * (1.0 + 2.0 * cosio - 3.0 * theta2));
+      double f542 = 29.53125 * sinio * ( 2.0 - 8.0 * cosio + theta2 * (-12.0 + 8.0 * cosio + 10.0 * theta2));
+      double f543 = 29.53125 * sinio * (-2.0 - 8.0 * cosio + theta2 * ( 12.0 + 8.0 * cosio - 10.0 * theta2));
+      double xno2  = el.m_MeanMotion * el.m_MeanMotion;
+      double ainv2 = aqnv * aqnv;
+      double temp1 = 3.0 * xno2 * ainv2;
+      double temp  = temp1 * root22;
+
+      dp_d2201 = temp * f220 * g201;
+      dp_d2211 = temp * f221 * g211;
+      temp1 = temp1 * aqnv;
+      temp = temp1 * root32;
+      dp_d3210 = temp * f321 * g310;
+      dp_d3222 = temp * f322 * g322;
+      temp1 = temp1 * aqnv;
+      temp = 2.0 * temp1 * root44;
+      dp_d4410 = temp * f441 * g410;
+      dp_d4422 = temp * f442 * g422;
+      temp1 = temp1 * aqnv;
+      temp  = temp1 * root52;
+      dp_d5220 = temp * f522 * g520;
+      dp_d5232 = temp * f523 * g532;
+      temp = 2.0 * temp1 * root54;
+      dp_d5421 = temp * f542 * g521;
+      dp_d5433 = temp * f543 * g533;
+      dp_xlamo = xmao + el.m_RAAN + el.m_RAAN - dp_thgr - dp_thgr;
+      bfact = m_xmdot + m_xnodot + m_xnodot - thdt - thdt;
+      bfact = bfact + dp_ssl + dp_ssh + dp_ssh;
+   }
+
+   if (Res != RES_NONE)
+   {
+      dp_xfact = bfact - el.m_MeanMotion;
+   }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// See cNoradSDP4::DeepCalcDotTerms(); the integrator state is passed in.
+template <eResonance Res>
+void cSdp4Kernel<Res>::DeepDotTerms(double xli, double xni, double atime,
+                                    double *pxndot, double *pxnddt, double *pxldot) const
+{
+   const double fasx2 = 0.13130908;
+   const double fasx4 = 2.8843198;
+   const double fasx6 = 0.37448087;
+
+   if constexpr (Res == RES_24H)
+   {
+      *pxndot = dp_del1 * sin(xli - fasx2) +
+                dp_del2 * sin(2.0 * (xli - fasx4)) +
+                dp_del3 * sin(3.0 * (xli - fasx6));
+      *pxnddt = dp_del1 * cos(xli - fasx2) +
+                2.0 * dp_del2 * cos(2.0 * (xli - fasx4)) +
+                3.0 * dp_del3 * cos(3.0 * (xli - fasx6));
+   }
+   else
+   {
+      const double g22 = 5.7686396;
+      const double g32 = 0.95240898;
+      const double g44 = 1.8014998;
+      const double g52 = 1.0508330;
+      const double g54 = 4.4108898;
+
+      double xomi  = m_ArgPerigee + m_omgdot * atime;
+      double x2omi = xomi + xomi;
+      double x2li  = xli + xli;
+
+      *pxndot = dp_d2201 * sin(x2omi + xli - g22) +
+                dp_d2211 * sin(xli - g22)         +
+                dp_d3210 * sin( xomi + xli - g32) +
+                dp_d3222 * sin(-xomi + xli - g32) +
+                dp_d4410 * sin(x2omi + x2li - g44) +
+                dp_d4422 * sin(x2li - g44)         +
+                dp_d5220 * sin( xomi + xli - g52) +
+                dp_d5232 * sin(-xomi + xli - g52) +
+                dp_d5421 * sin( xomi + x2li - g54) +
+                dp_d5433 * sin(-xomi + x2li - g54);
+
+      *pxnddt = dp_d2201 * cos(x2omi + xli - g22) +
+                dp_d2211 * cos(xli - g22)         +
+                dp_d3210 * cos( xomi + xli - g32) +
+                dp_d3222 * cos(-xomi + xli - g32) +
+                dp_d5220 * cos( xomi + xli - g52) +
+                dp_d5232 * cos(-xomi + xli - g52) +
+                2.0 * (dp_d4410 * cos(x2omi + x2li - g44) +
+                dp_d4422 * cos(x2li - g44)         +
+                dp_d5421 * cos( xomi + x2li - g54) +
+                dp_d5433 * cos(-xomi + x2li - g54));
+   }
+
+   *pxldot = xni + dp_xfact;
+   *pxnddt = (*pxnddt) * (*pxldot);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// See cNoradSDP4::DeepSecular()
+template <eResonance Res>
+void cSdp4Kernel<Res>::DeepSecular(double *xmdf,  double *omgadf, double *xnode,
+                                   double *emm,   double *xincc,  double *xnn,
+                                   double tsince) const
+{
+   // Deep space secular effects
+   *xmdf   = (*xmdf)   + dp_ssl * tsince;
+   *omgadf = (*omgadf) + dp_ssg * tsince;
+   *xnode  = (*xnode)  + dp_ssh * tsince;
+   *emm    = m_Eccentricity + dp_sse * tsince;
+   *xincc  = m_Inclination  + dp_ssi * tsince;
+
+   if ((*xincc) < 0.0)
+   {
+      *xincc  = -(*xincc);
+      *xnode  = (*xnode)  + PI;
+      *omgadf = (*omgadf) - PI;
+   }
+
+   if constexpr (Res != RES_NONE)
+   {
+      // Integrate from the epoch, in steps of dp_stepp minutes
+      const double delt = (tsince < 0.0) ? dp_stepn : dp_stepp;
+
+      double atime = 0.0;
+      double xni   = m_MeanMotion;
+      double xli   = dp_xlamo;
+      double xndot = 0.0;
+      double xnddt = 0.0;
+      double xldot = 0.0;
+
+      while (fabs(tsince - atime) >= dp_stepp)
+      {
+         DeepDotTerms(xli, xni, atime, &xndot, &xnddt, &xldot);
+
+         xli   = xli + xldot * delt + xndot * dp_step2;
+         xni   = xni + xndot * delt + xnddt * dp_step2;
+         atime = atime + delt;
+      }
+
+      double ft = tsince - atime;
+
+      DeepDotTerms(xli, xni, atime, &xndot, &xnddt, &xldot);
+
+      *xnn = xni + xndot * ft + xnddt * ft * ft * 0.5;
+
+      double xl   = xli + xldot * ft + xndot * ft * ft * 0.5;
+      double temp = -(*xnode) + dp_thgr + tsince * thdt;
+
+      if constexpr (Res == RES_24H)
+      {
+         *xmdf = xl - (*omgadf) + temp;
+      }
+      else
+      {
+         *xmdf = xl + temp + temp;
+      }
+   }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// See cNoradSDP4::DeepPeriodics()
+template <eResonance Res>
+void cSdp4Kernel<Res>::DeepPeriodics(double *e,      double *xincc,
+                                     double *omgadf, double *xnode,
+                                     double *xmam,   double tsince) const
+{
+   // Lunar-solar periodics
+   double zm = dp_zmos + zns * tsince;
+   double zf = zm + 2.0 * zes * sin(zm);
+   double sinzf = sin(zf);
+   double f2  = 0.5 * sinzf * sinzf - 0.25;
+   double f3  = -0.5 * sinzf * cos(zf);
+   double ses = dp_se2 * f2 + dp_se3 * f3;
+   double sis = dp_si2 * f2 + dp_si3 * f3;
+   double sls = dp_sl2 * f2 + dp_sl3 * f3 + dp_sl4 * sinzf;
+
+   double sghs = dp_sgh2 * f2 + dp_sgh3 * f3 + dp_sgh4 * sinzf;
+   double shs  = dp_sh2  * f2 + dp_sh3  * f3;
+
+   zm = dp_zmol + znl * tsince;
+   zf = zm + 2.0 * zel * sin(zm);
+   sinzf = sin(zf);
+   f2 = 0.5 * sinzf * sinzf - 0.25;
+   f3 = -0.5 * sinzf * cos(zf);
+
+   double sel = dp_ee2 * f2 + dp_e3  * f3;
+   double sil = dp_xi2 * f2 + dp_xi3 * f3;
+   double sll = dp_xl2 * f2 + dp_xl3 * f3 + dp_xl4 * sinzf;
+
+   double sghl = dp_xgh2 * f2 + dp_xgh3 * f3 + dp_xgh4 * sinzf;
+   double sh1  = dp_xh2  * f2 + dp_xh3  * f3;
+   double pe   = ses + sel;
+   double pinc = sis + sil;
+   double pl   = sls + sll;
+   double pgh  = sghs + sghl;
+   double ph   = shs  + sh1;
+
+   // sin/cos of the inclination before the periodics are applied
+   double sinis = sin(*xincc);
+   double cosis = cos(*xincc);
+
+   *xincc = (*xincc) + pinc;
+   *e = (*e) + pe;
+
+   if (!m_lyddane)
+   {
+      // Apply periodics directly
+      ph  = ph / m_sinio;
+      pgh = pgh - m_cosio * ph;
+      *omgadf = (*omgadf) + pgh;
+      *xnode  = (*xnode) + ph;
+      *xmam   = (*xmam) + pl;
+   }
+   else
+   {
+      // Apply periodics with Lyddane modification
+      double sinok = sin(*xnode);
+      double cosok = cos(*xnode);
+      double alfdp = sinis * sinok;
+      double betdp = sinis * cosok;
+      double dalf  =  ph * cosok + pinc * cosis * sinok;
+      double dbet  = -ph * sinok + pinc * cosis * cosok;
+
+      alfdp = alfdp + dalf;
+      betdp = betdp + dbet;
+
+      double xls = (*xmam) + (*omgadf) + cosis * (*xnode);
+      double dls = pl + pgh - pinc * (*xnode) * sinis;
+
+      xls     = xls + dls;
+      *xnode  = AcTan(alfdp, betdp);
+      *xmam   = (*xmam) + pl;
+      *omgadf = xls - (*xmam) - cos(*xincc) * (*xnode);
+   }
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// Evaluate()
+// See cNoradSDP4::GetPosition().
+template <eResonance Res>
+template <bool Velocity>
+eNoradResult cSdp4Kernel<Res>::Evaluate(double tsince, double pos[3], double vel[3]) const
+{
+   // Update for secular gravity and atmospheric drag
+   double xmdf   = m_MeanAnomaly + m_xmdot  * tsince;
+   double omgadf = m_ArgPerigee  + m_omgdot * tsince;
+   double xnoddf = m_RAAN + m_xnodot * tsince;
+   double tsq    = tsince * tsince;
+   double xnode  = xnoddf + m_xnodcf * tsq;
+   double tempa  = 1.0 - m_c1 * tsince;
+   double tempe  = m_BStar * m_c4 * tsince;
+   double templ  = m_t2cof * tsq;
+   double xn     = m_MeanMotion;
+   double em;
+   double xinc;
+
+   DeepSecular(&xmdf, &omgadf, &xnode, &em, &xinc, &xn, tsince);
+
+   double a    = pow(XKE / xn, 2.0 / 3.0) * sqr(tempa);
+   double e    = em - tempe;
+   double xmam = xmdf + m_MeanMotion * templ;
+
+   DeepPeriodics(&e, &xinc, &omgadf, &xnode, &xmam, tsince);
+
+   double xl = xmam + omgadf + xnode;
+
+   xn = XKE / pow(a, 1.5);
+
+   return FinalPosition<Velocity>(xinc, omgadf, e, a, xl, xnode, xn, pos, vel);
+}
+
+
+//////////////////////////////////////////////////////////////////////////////
+inline cLunarSolarEpoch NoradLunarSolarEpoch(double jdEpoch)
+{
+   cLunarSolarEpoch ls;
+
+   ls.m_jdEpoch = jdEpoch;
+   ls.m_Gmst    = cJulian::FromDate(jdEpoch).ToGmst();
+
+   // Same as cNoradSDP4::cNoradSDP4()
+   double day = jdEpoch - EPOCH_JAN0_12H_1900;
+   double dpi_xnodce = 4.5236020 - 9.2422029E-4 * day;
+   double dpi_stem   = sin(dpi_xnodce);
+   double dpi_ctem   = cos(dpi_xnodce);
+   double dpi_zcosil = 0.91375164 - 0.03568096 * dpi_ctem;
+   double dpi_zsinil = sqrt(1.0 - dpi_zcosil * dpi_zcosil);
+   double dpi_zsinhl = 0.089683511 *dpi_stem / dpi_zsinil;
+   double dpi_zcoshl = sqrt(1.0 - dpi_zsinhl * dpi_zsinhl);
+   double dpi_c      = 4.7199672 + 0.22997150 * day;
+   double dpi_gam    = 5.8351514 + 0.0019443680 * day;
+
+   ls.m_zmol = Fmod2p(dpi_c - dpi_gam);
+
+   double dpi_zx = 0.39785416 * dpi_stem / dpi_zsinil;
+   double dpi_zy = dpi_zcoshl * dpi_ctem + 0.91744867 * dpi_zsinhl * dpi_stem;
+
+   dpi_zx = AcTan(dpi_zx,dpi_zy) + dpi_gam - dpi_xnodce;
+
+   ls.m_zcosgl = cos(dpi_zx);
+   ls.m_zsingl = sin(dpi_zx);
+   ls.m_zcosil = dpi_zcosil;
+   ls.m_zsinil = dpi_zsinil;
+   ls.m_zcoshl = dpi_zcoshl;
+   ls.m_zsinhl = dpi_zsinhl;
+
+   ls.m_zmos = Fmod2p(6.2565837 + 0.017201977 * day);
+
+   return ls;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+inline cLunarSolarEpoch cLunarSolarCache::Find(double jdEpoch)
+{
+   // Exact epochs are keyed by their bits, others by their slot
+   long long key = 0;
+
+   if (m_TolDays > 0.0)
+   {
+      key = (long long)std::floor(jdEpoch / m_TolDays);
+   }
+   else
+   {
+      std::memcpy(&key, &jdEpoch, sizeof(key));
+   }
+
+   auto found = m_Epochs.find(key);
+
+   if (found == m_Epochs.end())
+   {
+      // A slot's terms are for its start, whichever epoch in it came first
+      const double jdTerms = (m_TolDays > 0.0) ? (double)key * m_TolDays : jdEpoch;
+
+      found = m_Epochs.emplace(key, NoradLunarSolarEpoch(jdTerms)).first;
+   }
+   else
+   {
+      ++m_Hits;
+   }
+
+   cLunarSolarEpoch ls = found->second;
+
+   if (ls.m_jdEpoch != jdEpoch)
+   {
+      // Move the fast terms by their rates in NoradLunarSolarEpoch() and
+      // cJulian::ToGmst(). The step is under a day, so one wrap will do.
+      const double dt = jdEpoch - ls.m_jdEpoch;
+
+      ls.m_jdEpoch = jdEpoch;
+      ls.m_Gmst    = Wrap2p(ls.m_Gmst + (TWOPI * OMEGA_E) * dt);
+      ls.m_zmol    = Wrap2p(ls.m_zmol + (0.22997150 - 0.0019443680) * dt);
+      ls.m_zmos    = Wrap2p(ls.m_zmos + 0.017201977 * dt);
+   }
+
+   return ls;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+// Wrap2p()
+// Wrap an angle within one turn of 0..2PI back into 0..2PI.
+inline double cLunarSolarCache::Wrap2p(double arg)
+{
+   if (arg < 0.0)
+   {
+      return arg + TWOPI;
+   }
+
+   return (arg >= TWOPI) ? (arg - TWOPI) : arg;
+}
+
+//////////////////////////////////////////////////////////////////////////////
+inline cNoradModel::cNoradModel(const cNoradElements &el) :
+   m_Kernel(MakeKernel(el))
+{
+}
+
+//////////////////////////////////////////////////////////////////////////////
+inline decltype(cNoradModel::m_Kernel) cNoradModel::MakeKernel(const cNoradElements &el)
+{
+   typedef decltype(m_Kernel) cKernel;
+
+   if (!el.IsDeepSpace())
+   {
+      if (NoradIsSimple(el))
+      {
+         return cKernel(std::in_place_type<cSgp4Kernel<double, true>>, el);
+      }
+
+      return cKernel(std::in_place_type<cSgp4Kernel<double, false>>, el);
+   }
+
+   switch (NoradResonance(el))
+   {
+      case RES_12H: return cKernel(std::in_place_type<cSdp4Kernel<RES_12H>>, el);
+      case RES_24H: return cKernel(std::in_place_type<cSdp4Kernel<RES_24H>>, el);
+      default:      return cKernel(std::in_place_type<cSdp4Kernel<RES_NONE>>, el);
+   }
+}
+
+}
+}
@@ -2,90 +2,1800 @@
 #include "libsat355.h"
 
 // std
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#if (!WIN32)
+#define gmtime_s(x, y) (gmtime_r(y, x))
+#define _get_timezone(x)
+#define _snprintf_s (snprintf)
+#endif // WIN32
+
+// orbittools
+// *NOTE: Large portions of this was stolen from orbittools demo
+// "coreLib.h" includes basic types from the core library,
+// such as cSite, cJulian, etc. The header file also contains a
+// "using namespace" statement for Zeptomoby::OrbitTools.
+// C:\Users\mn-fi\Projects\git\libsat355\cppOrbitTools\orbitTools\core\coreLib.h
+#include "coreLib.h"
+// "orbitLib.h" includes basic types from the orbit library,
+// including cOrbit.
+#include "orbitLib.h"
+// Value-type template kernels used by the batch (Catalog) paths
+#include "cNoradKernel.h"
+#include "cJ2Kernel.h"
+#include "coordKernel.h"
+// Chebyshev ephemeris cache used by the Ephemeris API
+#include "cEphemeris.h"
+
+// Notes on DLLs: 
+// Must use C ABI
+// When using C++ in a Dll, you must prevent C++ from escaping the DLL boundary. 
+//   Notice all the extern "C" declarations and try catches.
+// The reason for this is that DLLs are fundamentally C based, and there is no industry standard that allows C++ to interoperate between compilers.
+// Raw C++ objects or APIs can't be exposed in the DLL interface because of the C ABI restriction.
+// C++ exceptions in the DLL implementation must be caught, handled, and turned into error codes before they cross the DLL boundary.
+// Any resources allocated by DLL implementation must also be de-allocated by DLL implementation. 
+//   Alllocating memory is done through C++ runtime, but we don't know if the DLL and the application are using the same runtime.
+//   Therefore, allocation and deallocation must be done in the same module, else you risk heap corruption.
+// https://docs.microsoft.com/en-us/cpp/build/walkthrough-creating-and-using-a-dynamic-link-library-cpp?view=msvc-160
+
+// Best Practices:
+// C API using opaque data types
+// The DLL implementation defines concrete data types for the opaque data types that wraps any internal classes.
+
+// IOS Core Foundation: Date::init(timeIntervalSinceReferenceDate: TimeInterval)
+constexpr double EPOCH_JAN1_00H_2001 = 2451910.5; // Jan  1.0 2001 = Jan  1 2001 00h UTC
+static_assert(EPOCH_JAN1_00H_2001 == cJulian(2001, 1, 1, 0, 0).Date(), "Julian date of Jan 1 2001");
+
+// struct TLE wraps the concrete zeptomoby class to fix
+// problems with the zeptomoby std::string getters
+// zeptomoby returns its strings as values, instead of const reference
+//
+// Q: Should we prefer to aggregate(has-a) or inherit(is-a) zeptmoby cTle?
+// A: In general, prefer aggregation
+// Why? Aggregation eliminates unwanted dependencies on the wrapped class
+// https://en.wikipedia.org/wiki/Composition_over_inheritance#Benefits
+
+struct TLE //: public Zeptomoby::OrbitTools::cTle // prefer aggregation over inheritance
+{
+	std::string mName{};
+	std::string mLine1{};
+	std::string mLine2{};
+	Zeptomoby::OrbitTools::cTle mTLE;
+
+	TLE(const char* inName, const char* inLine1, const char* inLine2) :
+		mTLE{inName, inLine1, inLine2}
+	{
+		mName = std::move(mTLE.Name());
+		mLine1 = std::move(mTLE.Line1());
+		mLine2 = std::move(mTLE.Line2());
+	}
+};
+
+namespace /*anonymous*/ {
+
+// Julian date for in_time, in seconds since 1970
+cJulian JulianFromUnixTime(long long in_time)
+{
+	return cJulian(static_cast<time_t>(in_time));
+}
+
+// Julian date for in_time, in seconds since 1970, keeping fractional seconds.
+// Offsets one Julian date for the Unix epoch instead of calling gmtime()
+// per query.
+cJulian JulianFromUnixTime(double in_time)
+{
+	static const cJulian unixEpoch = JulianFromUnixTime(0LL);
+	cJulian julian = unixEpoch;
+	julian.AddSec(in_time);
+	return julian;
+}
+
+// Julian dates for in_count times in seconds since 1970
+template <typename Time>
+std::vector<cJulian> JulianFromUnixTimes(const Time in_times[], size_t in_count)
+{
+	std::vector<cJulian> times{};
+	times.reserve(in_count);
+	for (size_t n = 0; n < in_count; ++n)
+	{
+		times.push_back(JulianFromUnixTime(in_times[n]));
+	}
+	return times;
+}
+
+// Longitude in degs, W)est as negative values for googlemaps compatibility
+double ToLonDegs(double inLonRad)
+{
+	double londeg = rad2deg(inLonRad);
+	if (londeg > 180.0)
+	{
+		londeg -= 360.0;
+	}
+	return londeg;
+}
+
+// ECI output arrays, one element per catalog entry. Position in km;
+// velocity in km/sec, written only when propagating with velocity.
+struct EciArrays
+{
+	double* mX{nullptr};
+	double* mY{nullptr};
+	double* mZ{nullptr};
+	double* mVx{nullptr};
+	double* mVy{nullptr};
+	double* mVz{nullptr};
+};
+
+// ErrorCode for a kernel result
+int ToErrorCode(eNoradResult inResult)
+{
+	switch (inResult)
+	{
+	case NORAD_OK:
+		return kOK;
+	case NORAD_DECAYED:
+		return kDecayed;
+	case NORAD_ECCENTRICITY:
+		return kEccentricityOutOfRange;
+	case NORAD_BAD_ELEMENTS:
+		return kBadElements;
+	}
+	return kInternalError;
+}
+
+// Propagate one kernel to inJd into element inIndex of outEci; returns an ErrorCode.
+// PositionOnly skips the velocity terms; the position is the same.
+template <bool PositionOnly, class Kernel>
+int KernelToEci(const Kernel& inKernel, double inJd, const EciArrays& outEci, std::size_t inIndex)
+{
+	using Real = typename Kernel::RealType;
+
+	const double tsince = (inJd - inKernel.EpochJd()) * MIN_PER_DAY;
+	Real pos[3]{};
+	Real vel[3]{};
+	eNoradResult result = NORAD_OK;
+	if constexpr (PositionOnly)
+	{
+		result = inKernel.Position(tsince, pos);
+	}
+	else
+	{
+		result = inKernel.Propagate(tsince, pos, vel);
+	}
+
+	if (result != NORAD_OK)
+	{
+		return ToErrorCode(result);
+	}
+
+	const double kmPerAe = XKMPER_WGS72 / AE;
+	outEci.mX[inIndex] = pos[0] * kmPerAe;
+	outEci.mY[inIndex] = pos[1] * kmPerAe;
+	outEci.mZ[inIndex] = pos[2] * kmPerAe;
+	if constexpr (!PositionOnly)
+	{
+		// earth radii per minute to km/sec
+		const double kmsPerAem = kmPerAe / 60.0;
+		outEci.mVx[inIndex] = vel[0] * kmsPerAem;
+		outEci.mVy[inIndex] = vel[1] * kmsPerAem;
+		outEci.mVz[inIndex] = vel[2] * kmsPerAem;
+	}
+	return kOK;
+}
+
+// Propagate one kernel to inJd and convert to Lat/Lon/Alt; returns an ErrorCode
+template <bool PositionOnly, class Kernel>
+int KernelToLLA(const Kernel& inKernel, double inJd, double inGmst, double* out_latdegs, double* out_londegs, double* out_altkm)
+{
+	double pos[3]{};
+	double vel[3]{};
+	const EciArrays eci{&pos[0], &pos[1], &pos[2], &vel[0], &vel[1], &vel[2]};
+	const int result = KernelToEci<PositionOnly>(inKernel, inJd, eci, 0);
+	if (result != kOK)
+	{
+		return result;
+	}
+
+	double lat = 0.0;
+	double lon = 0.0;
+	EciToGeo(pos[0], pos[1], pos[2], inGmst, &lat, &lon, out_altkm);
+	*out_latdegs = rad2deg(lat);
+	*out_londegs = ToLonDegs(lon);
+	return kOK;
+}
+
+// Model class of each catalog entry; each class is propagated as its
+// own homogeneous batch.
+enum ModelClass : unsigned char
+{
+	kModelSgp4Simple,	// SGP4, perigee < 220 km
+	kModelSgp4,			// SGP4
+	kModelSdp4,			// SDP4, no resonance
+	kModelSdp4Res12h,	// SDP4, 12-hour resonant
+	kModelSdp4Res24h	// SDP4, geosynchronous
+};
+
+// Near earth satellites of one SGP4 variant. Each satellite has a kernel
+// in each precision; the single precision kernels are in their own array
+// so a "display grade" pass only streams half as much model data.
+template <bool Simple>
+struct NearBatch
+{
+	std::vector<std::uint32_t> mIndex{};	// catalog index of each slot
+	std::vector<cSgp4Kernel<double, Simple>> mDouble{};
+	std::vector<cSgp4Kernel<float, Simple>> mFloat{};
+
+	// Single precision error of each slot, and the slots that pass/fail
+	// the Catalog's tolerance
+	std::vector<double> mFloatMaxKm{};
+	std::vector<double> mFloatRmsKm{};
+	std::vector<std::uint32_t> mFloatSlots{};
+	std::vector<std::uint32_t> mDoubleSlots{};
+};
+
+// Deep space satellites of one SDP4 variant
+template <eResonance Res>
+struct DeepBatch
+{
+	std::vector<std::uint32_t> mIndex{};	// catalog index of each slot
+	std::vector<cSdp4Kernel<Res>> mKernels{};
+};
+
+// Analytic J2 kernels of every catalog index, anchored to the full model
+// for one re-anchor interval; see kPropagateJ2
+struct J2Batch
+{
+	long long mInterval{0};				// interval number: anchor time since 1970 / interval length
+	std::vector<cJ2Kernel> mKernels{};
+	std::vector<int> mStatus{};			// ErrorCode of each anchor
+};
+
+} // namespace anonymous
+
+// struct Catalog holds decoded models for a whole set of TLEs so that
+// a batch can be propagated without re-parsing anything.
+//
+// Satellites are sorted by model class into homogeneous batches when the
+// Catalog is made, so each batch loop calls one kernel type directly with
+// no virtual dispatch and no per-call model branches.
+// Deep space (SDP4) satellites are always propagated in double precision.
+//
+// A satellite that fails to propagate is quarantined: its ErrorCode is
+// kept and reported again by every later call, without running its
+// model, until UpdateTLE() replaces its elements.
+struct Catalog
+{
+	static constexpr double kDefaultFloatToleranceKm = 0.010;
+	static constexpr double kFloatCheckSpanMin = 3.0 * 24.0 * 60.0;	// +/-3 days from epoch
+	static constexpr double kFloatCheckStepMin = 120.0;
+	// Deep space epochs take their lunar-solar terms at the start of a
+	// slot this long; see cLunarSolarCache. Moves positions by at most
+	// ~0.1 m over +/-3 days.
+	static constexpr double kLunarSolarToleranceMin = 10.0;
+	static constexpr double kDefaultJ2IntervalMin = 1.0;
+	static constexpr int kJ2ErrorSamples = 10;	// per interval, see GetJ2Error()
+
+	// What a failed propagation does: quarantine the satellite, at the
+	// times a caller asked for, or only report it, for the J2 anchors and
+	// GetJ2Error(), which propagate at times of their own
+	enum class OnFailure { kQuarantine, kReport };
+
+	std::size_t mCount{0};
+	std::vector<ModelClass> mModel{};		// model class of each catalog index
+	std::vector<std::uint32_t> mSlot{};		// slot of each catalog index within its batch
+
+	NearBatch<true> mSgp4Simple{};
+	NearBatch<false> mSgp4{};
+	DeepBatch<RES_NONE> mSdp4{};
+	DeepBatch<RES_12H> mSdp4Res12h{};
+	DeepBatch<RES_24H> mSdp4Res24h{};
+
+	// Single precision validation of the near earth batches; measured lazily
+	// the first time it is needed since it propagates every satellite
+	// many times.
+	double mFloatToleranceKm{kDefaultFloatToleranceKm};
+	mutable std::once_flag mFloatChecked{};
+	bool mFloatMeasured{false};
+
+	// ErrorCode of each quarantined catalog index, kOK for the rest, and
+	// what has been quarantined and skipped so far. Set from the const
+	// entry points, which may run on several threads at once.
+	mutable std::vector<std::atomic<int>> mQuarantine{};
+	mutable std::atomic<std::uint64_t> mDecayed{0};
+	mutable std::atomic<std::uint64_t> mEccentricity{0};
+	mutable std::atomic<std::uint64_t> mBadElements{0};
+	mutable std::atomic<std::uint64_t> mSkipped{0};
+	mutable std::atomic<std::size_t> mQuarantined{0};
+
+	// kPropagateJ2: unanchored kernels of every catalog index, and the
+	// anchors of the interval propagated last. Anchor times are whole
+	// multiples of the interval, so results do not depend on call order.
+	std::vector<cJ2Kernel> mJ2{};
+	double mJ2IntervalMin{kDefaultJ2IntervalMin};
+	mutable std::mutex mJ2Mutex{};
+	mutable std::shared_ptr<const J2Batch> mJ2Anchors{};
+
+	Catalog(const TLE* const inTLEs[], std::size_t inCount) :
+		mCount{inCount},
+		mModel(inCount),
+		mSlot(inCount),
+		mQuarantine(inCount)
+	{
+		mJ2.reserve(inCount);
+		cLunarSolarCache lunarSolar(kLunarSolarToleranceMin);
+		for (std::size_t i = 0; i < inCount; ++i)
+		{
+			cNoradElements elements{};
+			if (!NoradElementsFromTle(inTLEs[i]->mLine1.c_str(), inTLEs[i]->mLine2.c_str(), &elements))
+			{
+				throw std::invalid_argument("Invalid TLE");
+			}
+			const auto index = static_cast<std::uint32_t>(i);
+			mJ2.emplace_back(elements);
+			Add(index, elements, lunarSolar);
+			if (!elements.IsValid())
+			{
+				Quarantine(index, kBadElements);
+			}
+		}
+	}
+
+	// Put catalog index inIndex in the batch of its model class
+	void Add(std::uint32_t inIndex, const cNoradElements& inElements, cLunarSolarCache& ioLunarSolar)
+	{
+		if (!inElements.IsDeepSpace())
+		{
+			if (NoradIsSimple(inElements))
+			{
+				AddNear(mSgp4Simple, kModelSgp4Simple, inIndex, inElements);
+			}
+			else
+			{
+				AddNear(mSgp4, kModelSgp4, inIndex, inElements);
+			}
+			return;
+		}
+
+		switch (NoradResonance(inElements))
+		{
+		case RES_NONE:
+			AddDeep(mSdp4, kModelSdp4, inIndex, inElements, ioLunarSolar);
+			break;
+		case RES_12H:
+			AddDeep(mSdp4Res12h, kModelSdp4Res12h, inIndex, inElements, ioLunarSolar);
+			break;
+		case RES_24H:
+			AddDeep(mSdp4Res24h, kModelSdp4Res24h, inIndex, inElements, ioLunarSolar);
+			break;
+		}
+	}
+
+	template <bool Simple>
+	void AddNear(NearBatch<Simple>& ioBatch, ModelClass inModel, std::uint32_t inIndex, const cNoradElements& inElements)
+	{
+		const auto slot = static_cast<std::uint32_t>(ioBatch.mIndex.size());
+		mModel[inIndex] = inModel;
+		mSlot[inIndex] = slot;
+		ioBatch.mIndex.push_back(inIndex);
+		ioBatch.mDouble.emplace_back(inElements);
+		ioBatch.mFloat.emplace_back(inElements);
+		if (mFloatMeasured)
+		{
+			ioBatch.mFloatMaxKm.push_back(0.0);
+			ioBatch.mFloatRmsKm.push_back(0.0);
+			CheckFloat(ioBatch, slot);
+		}
+	}
+
+	template <eResonance Res>
+	void AddDeep(DeepBatch<Res>& ioBatch, ModelClass inModel, std::uint32_t inIndex, const cNoradElements& inElements,
+				 cLunarSolarCache& ioLunarSolar)
+	{
+		mModel[inIndex] = inModel;
+		mSlot[inIndex] = static_cast<std::uint32_t>(ioBatch.mIndex.size());
+		ioBatch.mIndex.push_back(inIndex);
+		ioBatch.mKernels.emplace_back(inElements, ioLunarSolar.Find(inElements.m_jdEpoch));
+	}
+
+	// Take catalog index inIndex out of its batch; the batch's last slot
+	// moves into its place
+	void Remove(std::uint32_t inIndex)
+	{
+		switch (mModel[inIndex])
+		{
+		case kModelSgp4Simple:
+			RemoveNear(mSgp4Simple, inIndex);
+			break;
+		case kModelSgp4:
+			RemoveNear(mSgp4, inIndex);
+			break;
+		case kModelSdp4:
+			RemoveDeep(mSdp4, inIndex);
+			break;
+		case kModelSdp4Res12h:
+			RemoveDeep(mSdp4Res12h, inIndex);
+			break;
+		case kModelSdp4Res24h:
+			RemoveDeep(mSdp4Res24h, inIndex);
+			break;
+		}
+	}
+
+	template <class T>
+	static void RemoveSlot(std::vector<T>& ioSlots, std::uint32_t inSlot)
+	{
+		ioSlots[inSlot] = ioSlots.back();
+		ioSlots.pop_back();
+	}
+
+	template <bool Simple>
+	void RemoveNear(NearBatch<Simple>& ioBatch, std::uint32_t inIndex)
+	{
+		const std::uint32_t slot = mSlot[inIndex];
+		mSlot[ioBatch.mIndex.back()] = slot;
+		RemoveSlot(ioBatch.mIndex, slot);
+		RemoveSlot(ioBatch.mDouble, slot);
+		RemoveSlot(ioBatch.mFloat, slot);
+		if (mFloatMeasured)
+		{
+			RemoveSlot(ioBatch.mFloatMaxKm, slot);
+			RemoveSlot(ioBatch.mFloatRmsKm, slot);
+		}
+	}
+
+	template <eResonance Res>
+	void RemoveDeep(DeepBatch<Res>& ioBatch, std::uint32_t inIndex)
+	{
+		const std::uint32_t slot = mSlot[inIndex];
+		mSlot[ioBatch.mIndex.back()] = slot;
+		RemoveSlot(ioBatch.mIndex, slot);
+		RemoveSlot(ioBatch.mKernels, slot);
+	}
+
+	// Replace the elements of catalog index inIndex and lift its quarantine
+	void UpdateTLE(std::size_t inIndex, const cNoradElements& inElements)
+	{
+		const auto index = static_cast<std::uint32_t>(inIndex);
+		cLunarSolarCache lunarSolar(kLunarSolarToleranceMin);
+		Remove(index);
+		Add(index, inElements, lunarSolar);
+		if (mFloatMeasured)
+		{
+			UpdateUseFloat(mSgp4Simple, mFloatToleranceKm);
+			UpdateUseFloat(mSgp4, mFloatToleranceKm);
+		}
+
+		mJ2[inIndex] = cJ2Kernel(inElements);
+		{
+			std::lock_guard<std::mutex> lock(mJ2Mutex);
+			mJ2Anchors.reset();
+		}
+
+		if (mQuarantine[inIndex].exchange(kOK) != kOK)
+		{
+			--mQuarantined;
+		}
+		if (!inElements.IsValid())
+		{
+			Quarantine(index, kBadElements);
+		}
+	}
+
+	// Quarantine catalog index inIndex with ErrorCode inStatus. Counted
+	// once, however many threads see it fail.
+	void Quarantine(std::size_t inIndex, int inStatus) const
+	{
+		int expected = kOK;
+		if (!mQuarantine[inIndex].compare_exchange_strong(expected, inStatus))
+		{
+			return;
+		}
+
+		++mQuarantined;
+		switch (inStatus)
+		{
+		case kDecayed:
+			++mDecayed;
+			break;
+		case kEccentricityOutOfRange:
+			++mEccentricity;
+			break;
+		default:
+			++mBadElements;
+			break;
+		}
+	}
+
+	void GetStats(CatalogStats* outStats) const
+	{
+		outStats->mDecayed = mDecayed;
+		outStats->mEccentricity = mEccentricity;
+		outStats->mBadElements = mBadElements;
+		outStats->mSkipped = mSkipped;
+		outStats->mQuarantined = mQuarantined;
+	}
+
+	// Measure single precision error of one near earth slot against double
+	template <bool Simple>
+	static void CheckFloat(NearBatch<Simple>& ioBatch, std::size_t inSlot)
+	{
+		double maxKm = 0.0;
+		double sumSq = 0.0;
+		int samples = 0;
+
+		for (double tsince = -kFloatCheckSpanMin; tsince <= kFloatCheckSpanMin; tsince += kFloatCheckStepMin)
+		{
+			double posD[3]{};
+			double velD[3]{};
+			float posF[3]{};
+			float velF[3]{};
+			const bool okD = (ioBatch.mDouble[inSlot].Propagate(tsince, posD, velD) == NORAD_OK);
+			const bool okF = (ioBatch.mFloat[inSlot].Propagate(tsince, posF, velF) == NORAD_OK);
+			if (okD != okF)
+			{
+				// Precisions disagree on decay; never trust float for this one
+				maxKm = std::numeric_limits<double>::infinity();
+				continue;
+			}
+			if (!okD)
+			{
+				continue;
+			}
+
+			const double dx = posD[0] - posF[0];
+			const double dy = posD[1] - posF[1];
+			const double dz = posD[2] - posF[2];
+			const double errKm = std::sqrt(dx * dx + dy * dy + dz * dz) * XKMPER_WGS72;
+			maxKm = std::max(maxKm, errKm);
+			sumSq += errKm * errKm;
+			++samples;
+		}
+
+		ioBatch.mFloatMaxKm[inSlot] = maxKm;
+		ioBatch.mFloatRmsKm[inSlot] = (samples > 0) ? std::sqrt(sumSq / samples) : 0.0;
+	}
+
+	template <bool Simple>
+	static void CheckFloat(NearBatch<Simple>& ioBatch)
+	{
+		const std::size_t count = ioBatch.mIndex.size();
+		ioBatch.mFloatMaxKm.assign(count, 0.0);
+		ioBatch.mFloatRmsKm.assign(count, 0.0);
+
+		for (std::size_t slot = 0; slot < count; ++slot)
+		{
+			CheckFloat(ioBatch, slot);
+		}
+	}
+
+	// Split a near earth batch into slots that use float and slots that fall back to double
+	template <bool Simple>
+	static void UpdateUseFloat(NearBatch<Simple>& ioBatch, double inToleranceKm)
+	{
+		ioBatch.mFloatSlots.clear();
+		ioBatch.mDoubleSlots.clear();
+		for (std::size_t slot = 0; slot < ioBatch.mIndex.size(); ++slot)
+		{
+			auto& slots = (ioBatch.mFloatMaxKm[slot] <= inToleranceKm) ? ioBatch.mFloatSlots : ioBatch.mDoubleSlots;
+			slots.push_back(static_cast<std::uint32_t>(slot));
+		}
+	}
+
+	// Float error is measured on first use; the const entry points share it
+	void CheckFloat() const
+	{
+		std::call_once(mFloatChecked, [this]()
+		{
+			auto& self = const_cast<Catalog&>(*this);
+			CheckFloat(self.mSgp4Simple);
+			CheckFloat(self.mSgp4);
+			UpdateUseFloat(self.mSgp4Simple, mFloatToleranceKm);
+			UpdateUseFloat(self.mSgp4, mFloatToleranceKm);
+			self.mFloatMeasured = true;
+		});
+	}
+
+	void SetFloatTolerance(double inToleranceKm)
+	{
+		mFloatToleranceKm = inToleranceKm;
+		CheckFloat();
+		UpdateUseFloat(mSgp4Simple, mFloatToleranceKm);
+		UpdateUseFloat(mSgp4, mFloatToleranceKm);
+	}
+
+	// Propagate one slot, unless its satellite is quarantined; returns
+	// true if it was skipped
+	template <bool PositionOnly, OnFailure Failure, class Kernel>
+	bool SlotToEci(const Kernel& inKernel, std::uint32_t inIndex, double inJd, const EciArrays& outEci, int* out_status) const
+	{
+		const int quarantined = mQuarantine[inIndex].load(std::memory_order_relaxed);
+		if (quarantined != kOK)
+		{
+			out_status[inIndex] = quarantined;
+			return true;
+		}
+
+		const int status = KernelToEci<PositionOnly>(inKernel, inJd, outEci, inIndex);
+		out_status[inIndex] = status;
+		if (status != kOK && Failure == OnFailure::kQuarantine)
+		{
+			Quarantine(inIndex, status);
+		}
+		return false;
+	}
+
+	// Skips only count against the calls that can quarantine
+	template <OnFailure Failure>
+	void CountSkipped(std::uint64_t inSkipped) const
+	{
+		if (inSkipped != 0 && Failure == OnFailure::kQuarantine)
+		{
+			mSkipped.fetch_add(inSkipped, std::memory_order_relaxed);
+		}
+	}
+
+	// Propagate the listed slots of one batch
+	template <bool PositionOnly, OnFailure Failure, class Kernel>
+	void BatchToEci(const std::vector<Kernel>& inKernels, const std::vector<std::uint32_t>& inIndex, const std::vector<std::uint32_t>& inSlots,
+					double inJd, const EciArrays& outEci, int* out_status) const
+	{
+		std::uint64_t skipped = 0;
+		for (const std::uint32_t slot : inSlots)
+		{
+			skipped += SlotToEci<PositionOnly, Failure>(inKernels[slot], inIndex[slot], inJd, outEci, out_status);
+		}
+		CountSkipped<Failure>(skipped);
+	}
+
+	// Propagate every slot of one batch
+	template <bool PositionOnly, OnFailure Failure, class Kernel>
+	void BatchToEci(const std::vector<Kernel>& inKernels, const std::vector<std::uint32_t>& inIndex,
+					double inJd, const EciArrays& outEci, int* out_status) const
+	{
+		std::uint64_t skipped = 0;
+		for (std::size_t slot = 0; slot < inKernels.size(); ++slot)
+		{
+			skipped += SlotToEci<PositionOnly, Failure>(inKernels[slot], inIndex[slot], inJd, outEci, out_status);
+		}
+		CountSkipped<Failure>(skipped);
+	}
+
+	template <bool PositionOnly, OnFailure Failure, bool Simple>
+	void NearToEci(const NearBatch<Simple>& inBatch, bool inFloat, double inJd, const EciArrays& outEci, int* out_status) const
+	{
+		if (inFloat)
+		{
+			BatchToEci<PositionOnly, Failure>(inBatch.mFloat, inBatch.mIndex, inBatch.mFloatSlots, inJd, outEci, out_status);
+			BatchToEci<PositionOnly, Failure>(inBatch.mDouble, inBatch.mIndex, inBatch.mDoubleSlots, inJd, outEci, out_status);
+		}
+		else
+		{
+			BatchToEci<PositionOnly, Failure>(inBatch.mDouble, inBatch.mIndex, inJd, outEci, out_status);
+		}
+	}
+
+	template <bool PositionOnly, OnFailure Failure = OnFailure::kQuarantine>
+	void AllToEci(bool inFloat, double inJd, const EciArrays& outEci, int* out_status) const
+	{
+		NearToEci<PositionOnly, Failure>(mSgp4Simple, inFloat, inJd, outEci, out_status);
+		NearToEci<PositionOnly, Failure>(mSgp4, inFloat, inJd, outEci, out_status);
+		BatchToEci<PositionOnly, Failure>(mSdp4.mKernels, mSdp4.mIndex, inJd, outEci, out_status);
+		BatchToEci<PositionOnly, Failure>(mSdp4Res12h.mKernels, mSdp4Res12h.mIndex, inJd, outEci, out_status);
+		BatchToEci<PositionOnly, Failure>(mSdp4Res24h.mKernels, mSdp4Res24h.mIndex, inJd, outEci, out_status);
+	}
+
+	// Call inVisit with the double precision full model of catalog index
+	// inIndex; returns what it returned
+	template <class Visit>
+	auto VisitIndex(std::uint32_t inIndex, const Visit& inVisit) const
+	{
+		const std::uint32_t slot = mSlot[inIndex];
+		switch (mModel[inIndex])
+		{
+		case kModelSgp4Simple:
+			return inVisit(mSgp4Simple.mDouble[slot]);
+		case kModelSgp4:
+			return inVisit(mSgp4.mDouble[slot]);
+		case kModelSdp4:
+			return inVisit(mSdp4.mKernels[slot]);
+		case kModelSdp4Res12h:
+			return inVisit(mSdp4Res12h.mKernels[slot]);
+		default:
+			return inVisit(mSdp4Res24h.mKernels[slot]);
+		}
+	}
+
+	// kPropagateFloat does not apply to the J2 kernels
+	static bool WantsFloat(int in_flags)
+	{
+		return (in_flags & (kPropagateFloat | kPropagateJ2)) == kPropagateFloat;
+	}
+
+	// Full models, or the J2 kernels with kPropagateJ2
+	template <bool PositionOnly>
+	void PropagateToEci(int in_flags, double inJd, const EciArrays& outEci, int* out_status) const
+	{
+		if ((in_flags & kPropagateJ2) == 0)
+		{
+			AllToEci<PositionOnly>(WantsFloat(in_flags), inJd, outEci, out_status);
+			return;
+		}
+
+		const std::shared_ptr<const J2Batch> anchors = J2Anchors(inJd);
+		J2ToEci<PositionOnly>(*anchors, inJd, outEci, out_status);
+	}
+
+	// Satellites that could not be anchored fall back to the full model
+	// at inJd, which quarantines them if it fails there too. Reporting
+	// only gives their anchor's ErrorCode.
+	template <bool PositionOnly, OnFailure Failure = OnFailure::kQuarantine>
+	void J2ToEci(const J2Batch& inAnchors, double inJd, const EciArrays& outEci, int* out_status) const
+	{
+		std::uint64_t skipped = 0;
+		for (std::uint32_t i = 0; i < mCount; ++i)
+		{
+			out_status[i] = inAnchors.mStatus[i];
+			if (out_status[i] == kOK)
+			{
+				out_status[i] = KernelToEci<PositionOnly>(inAnchors.mKernels[i], inJd, outEci, i);
+			}
+			else if (Failure == OnFailure::kQuarantine)
+			{
+				skipped += VisitIndex(i, [&](const auto& inKernel)
+				{
+					return SlotToEci<PositionOnly, Failure>(inKernel, i, inJd, outEci, out_status);
+				});
+			}
+		}
+		CountSkipped<Failure>(skipped);
+	}
+
+	// Number of the re-anchor interval holding inJd. Intervals count from
+	// 1970, so every anchor is a whole multiple of the interval in Unix time.
+	// A Julian date is only good to ~40 us, so a time that close before an
+	// anchor counts as at it.
+	static long long J2Interval(double inJd, double inIntervalMin)
+	{
+		constexpr double kAnchorSlackMin = 1.0e-4 / 60.0;
+		const double minutes = (inJd - JulianFromUnixTime(0LL).Date()) * MIN_PER_DAY;
+		return static_cast<long long>(std::floor((minutes + kAnchorSlackMin) / inIntervalMin));
+	}
+
+	// Julian date of the start of interval inInterval. On a whole second
+	// it is the date a call for that second propagates to, so the fit
+	// there matches the full model exactly.
+	static double J2IntervalStart(long long inInterval, double inIntervalMin)
+	{
+		const double seconds = static_cast<double>(inInterval) * inIntervalMin * (SEC_PER_DAY / MIN_PER_DAY);
+		if (seconds == std::floor(seconds))
+		{
+			return JulianFromUnixTime(static_cast<long long>(seconds)).Date();
+		}
+		return JulianFromUnixTime(seconds).Date();
+	}
+
+	// Anchor the J2 kernels to the full models at the start of interval
+	// inInterval, aimed at the full models' positions at its end. Nothing
+	// is quarantined: neither end is a time the caller asked for.
+	std::shared_ptr<const J2Batch> AnchorJ2(long long inInterval, double inIntervalMin) const
+	{
+		auto anchors = std::make_shared<J2Batch>();
+		anchors->mInterval = inInterval;
+		anchors->mKernels = mJ2;
+		anchors->mStatus.resize(mCount);
+
+		const double jdStart = J2IntervalStart(inInterval, inIntervalMin);
+		const double jdEnd = J2IntervalStart(inInterval + 1, inIntervalMin);
+
+		std::vector<double> state(9 * mCount);
+		std::vector<int> endStatus(mCount);
+		const EciArrays start{state.data(), state.data() + mCount, state.data() + 2 * mCount,
+							  state.data() + 3 * mCount, state.data() + 4 * mCount, state.data() + 5 * mCount};
+		const EciArrays end{state.data() + 6 * mCount, state.data() + 7 * mCount, state.data() + 8 * mCount};
+		AllToEci<false, OnFailure::kReport>(false, jdStart, start, anchors->mStatus.data());
+		AllToEci<true, OnFailure::kReport>(false, jdEnd, end, endStatus.data());
+
+		// Back to the kernels' units
+		const double kmPerAe = XKMPER_WGS72 / AE;
+		const double kmsPerAem = kmPerAe / 60.0;
+		for (std::size_t i = 0; i < mCount; ++i)
+		{
+			int& status = anchors->mStatus[i];
+			if (status == kOK)
+			{
+				status = endStatus[i];
+			}
+			if (status != kOK)
+			{
+				continue;
+			}
+
+			const double pos[3]{start.mX[i] / kmPerAe, start.mY[i] / kmPerAe, start.mZ[i] / kmPerAe};
+			const double vel[3]{start.mVx[i] / kmsPerAem, start.mVy[i] / kmsPerAem, start.mVz[i] / kmsPerAem};
+			const double posEnd[3]{end.mX[i] / kmPerAe, end.mY[i] / kmPerAe, end.mZ[i] / kmPerAe};
+			if (!anchors->mKernels[i].Anchor(jdStart, pos, vel, inIntervalMin, posEnd))
+			{
+				// Not a bound orbit
+				status = kBadElements;
+			}
+		}
+		return anchors;
+	}
+
+	// Anchors of the interval holding inJd; re-anchors when it changes
+	std::shared_ptr<const J2Batch> J2Anchors(double inJd) const
+	{
+		std::lock_guard<std::mutex> lock(mJ2Mutex);
+		const long long interval = J2Interval(inJd, mJ2IntervalMin);
+		if (!mJ2Anchors || mJ2Anchors->mInterval != interval)
+		{
+			mJ2Anchors = AnchorJ2(interval, mJ2IntervalMin);
+		}
+		return mJ2Anchors;
+	}
+
+	void SetJ2Interval(double inIntervalMin)
+	{
+		std::lock_guard<std::mutex> lock(mJ2Mutex);
+		mJ2IntervalMin = inIntervalMin;
+		mJ2Anchors.reset();
+	}
+
+	// Worst and RMS position error of the J2 kernels against the full
+	// models, sampled through the interval of length inIntervalMin that
+	// holds inTime
+	void GetJ2Error(const cJulian& inTime, double inIntervalMin, double* outMaxKm, double* outRmsKm) const
+	{
+		const long long interval = J2Interval(inTime.Date(), inIntervalMin);
+		const std::shared_ptr<const J2Batch> anchors = AnchorJ2(interval, inIntervalMin);
+		const double jdStart = J2IntervalStart(interval, inIntervalMin);
+
+		std::vector<double> pos(6 * mCount);
+		std::vector<int> status(2 * mCount);
+		const EciArrays full{pos.data(), pos.data() + mCount, pos.data() + 2 * mCount};
+		const EciArrays j2{pos.data() + 3 * mCount, pos.data() + 4 * mCount, pos.data() + 5 * mCount};
+
+		double maxKm = 0.0;
+		double sumSq = 0.0;
+		std::size_t samples = 0;
+		for (int n = 1; n <= kJ2ErrorSamples; ++n)
+		{
+			const double jd = jdStart + inIntervalMin * n / kJ2ErrorSamples / MIN_PER_DAY;
+			AllToEci<true, OnFailure::kReport>(false, jd, full, status.data());
+			J2ToEci<true, OnFailure::kReport>(*anchors, jd, j2, status.data() + mCount);
+
+			for (std::size_t i = 0; i < mCount; ++i)
+			{
+				if (status[i] != kOK || status[mCount + i] != kOK)
+				{
+					continue;
+				}
+
+				const double dx = full.mX[i] - j2.mX[i];
+				const double dy = full.mY[i] - j2.mY[i];
+				const double dz = full.mZ[i] - j2.mZ[i];
+				const double errSq = dx * dx + dy * dy + dz * dz;
+				maxKm = std::max(maxKm, std::sqrt(errSq));
+				sumSq += errSq;
+				++samples;
+			}
+		}
+
+		*outMaxKm = maxKm;
+		*outRmsKm = (samples > 0) ? std::sqrt(sumSq / static_cast<double>(samples)) : 0.0;
+	}
+
+	void ToLLA(const cJulian& inTime, int in_flags, double* out_latdegs, double* out_londegs, double* out_altkm, int* out_status) const
+	{
+		const double jd = inTime.Date();
+		if (WantsFloat(in_flags))
+		{
+			CheckFloat();
+		}
+
+		// Propagate everything to ECI km first, using the output arrays
+		// as x, y and z; Lat/Lon/Alt never needs the velocity...
+		PropagateToEci<true>(in_flags, jd, EciArrays{out_latdegs, out_londegs, out_altkm}, out_status);
+
+		// ...then convert them in place as one batch, at one GMST
+		EciToGeoBatch(out_latdegs, out_londegs, out_altkm, mCount, inTime.ToGmst(), out_latdegs, out_londegs, out_altkm);
+
+		for (std::size_t i = 0; i < mCount; ++i)
+		{
+			if (out_status[i] == kOK)
+			{
+				out_latdegs[i] = rad2deg(out_latdegs[i]);
+				out_londegs[i] = ToLonDegs(out_londegs[i]);
+			}
+			else
+			{
+				out_latdegs[i] = 0.0;
+				out_londegs[i] = 0.0;
+				out_altkm[i] = 0.0;
+			}
+		}
+	}
+
+	// Julian date and GMST of each time of a ToLLATimes() call, converted
+	// once for the whole catalog
+	struct EpochTimes
+	{
+		std::vector<double> mJd{};
+		std::vector<double> mGmst{};
+	};
+
+	// Outputs of ToLLATimes(); element [index * time count + n] is catalog
+	// index 'index' at time n
+	struct LLAMatrix
+	{
+		double* mLatDegs;
+		double* mLonDegs;
+		double* mAltKm;
+		int* mStatus;
+	};
+
+	// Zero elements [inElement, inElement + inCount) of the outputs and
+	// give them ErrorCode inStatus
+	static void FailLLA(std::size_t inElement, std::size_t inCount, int inStatus, const LLAMatrix& outLLA)
+	{
+		std::fill_n(&outLLA.mLatDegs[inElement], inCount, 0.0);
+		std::fill_n(&outLLA.mLonDegs[inElement], inCount, 0.0);
+		std::fill_n(&outLLA.mAltKm[inElement], inCount, 0.0);
+		std::fill_n(&outLLA.mStatus[inElement], inCount, inStatus);
+	}
+
+	// Lat/Lon/Alt of one satellite at time n of inTimes, or its ErrorCode
+	template <bool PositionOnly, class Kernel>
+	static int EpochToLLA(const Kernel& inKernel, const EpochTimes& inTimes, std::size_t inTime, std::size_t inElement, const LLAMatrix& outLLA)
+	{
+		const int status = KernelToLLA<PositionOnly>(inKernel, inTimes.mJd[inTime], inTimes.mGmst[inTime],
+													 &outLLA.mLatDegs[inElement], &outLLA.mLonDegs[inElement], &outLLA.mAltKm[inElement]);
+		outLLA.mStatus[inElement] = status;
+		if (status != kOK)
+		{
+			FailLLA(inElement, 1, status, outLLA);
+		}
+		return status;
+	}
+
+	// Propagate one slot to each time in turn, as ToLLA() would for each
+	// time in turn: once it fails it is quarantined, and the rest of its
+	// times are skipped. Returns the number of times skipped.
+	template <bool PositionOnly, class Kernel>
+	std::uint64_t SlotToLLATimes(const Kernel& inKernel, std::uint32_t inIndex, const EpochTimes& inTimes, const LLAMatrix& outLLA) const
+	{
+		const std::size_t timeCount = inTimes.mJd.size();
+		const std::size_t row = inIndex * timeCount;
+		const int quarantined = mQuarantine[inIndex].load(std::memory_order_relaxed);
+		if (quarantined != kOK)
+		{
+			FailLLA(row, timeCount, quarantined, outLLA);
+			return timeCount;
+		}
+
+		for (std::size_t n = 0; n < timeCount; ++n)
+		{
+			const int status = EpochToLLA<PositionOnly>(inKernel, inTimes, n, row + n, outLLA);
+			if (status != kOK)
+			{
+				Quarantine(inIndex, status);
+				FailLLA(row + n + 1, timeCount - n - 1, status, outLLA);
+				return timeCount - n - 1;
+			}
+		}
+		return 0;
+	}
+
+	// Call inVisit(kernel, catalog index) for each slot of one batch;
+	// returns the sum of what it returned
+	template <class Kernel, class Visit>
+	static std::uint64_t VisitSlots(const std::vector<Kernel>& inKernels, const std::vector<std::uint32_t>& inIndex, const Visit& inVisit)
+	{
+		std::uint64_t skipped = 0;
+		for (std::size_t slot = 0; slot < inKernels.size(); ++slot)
+		{
+			skipped += inVisit(inKernels[slot], inIndex[slot]);
+		}
+		return skipped;
+	}
+
+	// As above, for the listed slots only
+	template <class Kernel, class Visit>
+	static std::uint64_t VisitSlots(const std::vector<Kernel>& inKernels, const std::vector<std::uint32_t>& inIndex,
+									const std::vector<std::uint32_t>& inSlots, const Visit& inVisit)
+	{
+		std::uint64_t skipped = 0;
+		for (const std::uint32_t slot : inSlots)
+		{
+			skipped += inVisit(inKernels[slot], inIndex[slot]);
+		}
+		return skipped;
+	}
+
+	// Call inVisit for the kernel AllToEci() would propagate for each
+	// catalog index, batch by batch
+	template <bool Simple, class Visit>
+	static std::uint64_t VisitNear(const NearBatch<Simple>& inBatch, bool inFloat, const Visit& inVisit)
+	{
+		if (inFloat)
+		{
+			return VisitSlots(inBatch.mFloat, inBatch.mIndex, inBatch.mFloatSlots, inVisit) +
+				   VisitSlots(inBatch.mDouble, inBatch.mIndex, inBatch.mDoubleSlots, inVisit);
+		}
+		return VisitSlots(inBatch.mDouble, inBatch.mIndex, inVisit);
+	}
+
+	template <class Visit>
+	void VisitAll(bool inFloat, const Visit& inVisit) const
+	{
+		std::uint64_t skipped = VisitNear(mSgp4Simple, inFloat, inVisit);
+		skipped += VisitNear(mSgp4, inFloat, inVisit);
+		skipped += VisitSlots(mSdp4.mKernels, mSdp4.mIndex, inVisit);
+		skipped += VisitSlots(mSdp4Res12h.mKernels, mSdp4Res12h.mIndex, inVisit);
+		skipped += VisitSlots(mSdp4Res24h.mKernels, mSdp4Res24h.mIndex, inVisit);
+		if (skipped != 0)
+		{
+			mSkipped.fetch_add(skipped, std::memory_order_relaxed);
+		}
+	}
+
+	template <bool PositionOnly>
+	void PropagateToLLATimes(int in_flags, const EpochTimes& inTimes, const LLAMatrix& outLLA) const
+	{
+		if ((in_flags & kPropagateJ2) == 0)
+		{
+			VisitAll(WantsFloat(in_flags), [this, &inTimes, &outLLA](const auto& inKernel, std::uint32_t inIndex) -> std::uint64_t
+			{
+				return SlotToLLATimes<PositionOnly>(inKernel, inIndex, inTimes, outLLA);
+			});
+			return;
+		}
+
+		// The times may fall in different re-anchor intervals
+		std::vector<std::shared_ptr<const J2Batch>> anchors(inTimes.mJd.size());
+		for (std::size_t n = 0; n < anchors.size(); ++n)
+		{
+			anchors[n] = J2Anchors(inTimes.mJd[n]);
+		}
+
+		std::uint64_t skipped = 0;
+		for (std::size_t i = 0; i < mCount; ++i)
+		{
+			const std::size_t row = i * anchors.size();
+			for (std::size_t n = 0; n < anchors.size(); ++n)
+			{
+				if (anchors[n]->mStatus[i] == kOK)
+				{
+					EpochToLLA<PositionOnly>(anchors[n]->mKernels[i], inTimes, n, row + n, outLLA);
+					continue;
+				}
+
+				// As J2ToEci(): the full model at this time, if not quarantined
+				const int quarantined = mQuarantine[i].load(std::memory_order_relaxed);
+				if (quarantined != kOK)
+				{
+					FailLLA(row + n, 1, quarantined, outLLA);
+					++skipped;
+					continue;
+				}
+				const int status = VisitIndex(static_cast<std::uint32_t>(i), [&](const auto& inKernel)
+				{
+					return EpochToLLA<PositionOnly>(inKernel, inTimes, n, row + n, outLLA);
+				});
+				if (status != kOK)
+				{
+					Quarantine(i, status);
+				}
+			}
+		}
+		if (skipped != 0)
+		{
+			mSkipped.fetch_add(skipped, std::memory_order_relaxed);
+		}
+	}
+
+	// Lat/Lon/Alt of every satellite at each of inTimes. The times are
+	// converted to Julian date and GMST once, then each satellite is
+	// propagated to all of them before the next, so its model stays in
+	// cache across its timestamps.
+	void ToLLATimes(const std::vector<cJulian>& inTimes, int in_flags, const LLAMatrix& outLLA) const
+	{
+		EpochTimes times{};
+		times.mJd.reserve(inTimes.size());
+		times.mGmst.reserve(inTimes.size());
+		for (const cJulian& time : inTimes)
+		{
+			times.mJd.push_back(time.Date());
+			times.mGmst.push_back(time.ToGmst());
+		}
+
+		if (WantsFloat(in_flags))
+		{
+			CheckFloat();
+		}
+
+		// Lat/Lon/Alt never needs the velocity
+		PropagateToLLATimes<true>(in_flags, times, outLLA);
+	}
+
+	// ECI or ECEF position and velocity of every satellite; no geodetic
+	// conversion. The velocity arrays in outState may be NULL.
+	void ToCartesian(const cJulian& inTime, int in_flags, int in_frame, const EciArrays& outState, int* out_status) const
+	{
+		const double jd = inTime.Date();
+		if (WantsFloat(in_flags))
+		{
+			CheckFloat();
+		}
+
+		const bool positionOnly = ((in_flags & kPropagatePositionOnly) != 0) || (outState.mVx == nullptr);
+		if (positionOnly)
+		{
+			PropagateToEci<true>(in_flags, jd, EciArrays{outState.mX, outState.mY, outState.mZ}, out_status);
+		}
+		else
+		{
+			PropagateToEci<false>(in_flags, jd, outState, out_status);
+		}
+
+		if (in_frame == kFrameECEF)
+		{
+			EciToEcefBatch(outState.mX, outState.mY, outState.mZ,
+						   positionOnly ? nullptr : outState.mVx, outState.mVy, outState.mVz,
+						   mCount, inTime.ToGmst());
+		}
+
+		for (std::size_t i = 0; i < mCount; ++i)
+		{
+			if (out_status[i] != kOK)
+			{
+				outState.mX[i] = 0.0;
+				outState.mY[i] = 0.0;
+				outState.mZ[i] = 0.0;
+			}
+		}
+
+		if (outState.mVx != nullptr)
+		{
+			for (std::size_t i = 0; i < mCount; ++i)
+			{
+				if (positionOnly || out_status[i] != kOK)
+				{
+					outState.mVx[i] = 0.0;
+					outState.mVy[i] = 0.0;
+					outState.mVz[i] = 0.0;
+				}
+			}
+		}
+	}
+
+	// Look angles from inSite to the satellites at or above inMinElRad; returns how many
+	std::size_t LookAngles(const cJulian& inTime, int in_flags, cSiteKernel inSite, double inMinElRad,
+						   std::size_t* out_index, double* out_az, double* out_el, double* out_range, double* out_rate) const
+	{
+		const double jd = inTime.Date();
+		const bool positionOnly = ((in_flags & kPropagatePositionOnly) != 0);
+		if (WantsFloat(in_flags))
+		{
+			CheckFloat();
+		}
+
+		// Propagate everything to ECI as x, y, z, vx, vy, vz arrays
+		std::vector<double> state((positionOnly ? 3 : 6) * mCount);
+		std::vector<int> status(mCount);
+		EciArrays eci{state.data(), state.data() + mCount, state.data() + 2 * mCount};
+		if (positionOnly)
+		{
+			PropagateToEci<true>(in_flags, jd, eci, status.data());
+		}
+		else
+		{
+			eci.mVx = state.data() + 3 * mCount;
+			eci.mVy = state.data() + 4 * mCount;
+			eci.mVz = state.data() + 5 * mCount;
+			PropagateToEci<false>(in_flags, jd, eci, status.data());
+		}
+
+		for (std::size_t i = 0; i < mCount; ++i)
+		{
+			if (status[i] != kOK)
+			{
+				eci.mX[i] = 0.0;
+				eci.mY[i] = 0.0;
+				eci.mZ[i] = 0.0;
+			}
+		}
+
+		inSite.SetGmst(inTime.ToGmst());
+		std::size_t visible = inSite.LookAngles(eci.mX, eci.mY, eci.mZ, eci.mVx, eci.mVy, eci.mVz, mCount, inMinElRad,
+												out_index, out_az, out_el, out_range, out_rate);
+
+		// Satellites that failed to propagate sit at the earth's center;
+		// only a negative minimum elevation can let them through
+		std::size_t kept = 0;
+		for (std::size_t n = 0; n < visible; ++n)
+		{
+			if (status[out_index[n]] == kOK)
+			{
+				out_index[kept] = out_index[n];
+				out_az[kept] = out_az[n];
+				out_el[kept] = out_el[n];
+				out_range[kept] = out_range[n];
+				out_rate[kept] = out_rate[n];
+				++kept;
+			}
+		}
+		return kept;
+	}
+};
+
+// The model lives in the opaque state of struct Satellite; it is trivially
+// copyable so a Satellite can be copied and relocated as plain bytes.
+static_assert(std::is_trivially_copyable<cNoradModel>::value, "Satellite state must be trivially copyable");
+static_assert(sizeof(cNoradModel) <= sizeof(Satellite::mState), "Satellite state is too small");
+static_assert(alignof(cNoradModel) <= alignof(double), "Satellite state is misaligned");
+
+namespace /*anonymous*/ {
+
+const cNoradModel& SatelliteModel(const Satellite& inSatellite)
+{
+	return *std::launder(reinterpret_cast<const cNoradModel*>(inSatellite.mState));
+}
+
+} // namespace anonymous
+
+// TRICKY: extern "C"- Make functions callable from SwiftUI.
+// Force orbit_to_lla() to be "C" rather than "C++" function.
+// Needed because SwiftUI binding header can only call into "C".
+extern "C" {
+
+int HelloWorld()
+{
+	std::cout << "Hello World!" << std::endl;
+
+	return kOK;
+}
+
+// TLE Helper functions
+int TLE_Make(const char* inName, const char* inLine1, const char* inLine2, TLE** outTLE)
+try
+{
+	// Look ma, no raw new TLE{}!
+	auto tle = std::make_unique<TLE>(inName, inLine1, inLine2);
+	// return the concrete zeptomoby class as an opaque TLE*
+	*outTLE = tle.release();
+	return kOK;
+}
+catch (...)
+{
+	// Some unknown excption was thrown
+	std::cerr << "Unexpected exception encountered.\n";
+
+	return kInternalError;
+} // TLE_Make
+
+
+int TLE_Delete(TLE* ioTLE)
+try
+{
+	// Look ma, no raw delete inTLE!
+	std::unique_ptr<TLE> tle{};
+	// delete the concrete zeptomoby class allocated in TLE_Make()
+	tle.reset(ioTLE);
+
+	return kOK;
+}
+catch (...)
+{
+	// Some unknown excption was thrown
+	std::cerr << "Unexpected exception encountered.\n";
+
+	return kInternalError;
+} // TLE_Delete
+
+// TLE Name
+int TLE_GetName(const TLE* inTLE, const char* outName[])
+try
+{
+	*outName = inTLE->mName.c_str();	
+	return kOK;
+}
+catch (...)
+{
+	// Some unknown excption was thrown
+	std::cerr << "Unexpected exception encountered.\n";
+
+	return kInternalError;
+} // TLE_GetName
+
+// TLE Line1
+int TLE_GetLine1(const TLE* inTLE, const char* outLine1[])
+try
+{
+	*outLine1 = inTLE->mLine1.c_str();	
+	return kOK;
+}
+catch (...)
+{
+	// Some unknown excption was thrown
+	std::cerr << "Unexpected exception encountered.\n";
+
+	return kInternalError;
+} // TLE_GetLine1
+
+// TLE Line2
+int TLE_GetLine2(const TLE* inTLE, const char* outLine2[])
+try
+{
+	*outLine2 = inTLE->mLine2.c_str();	
+	return kOK;
+}
+catch (...)
+{
+	// Some unknown excption was thrown
+	std::cerr << "Unexpected exception encountered.\n";
+
+	return kInternalError;
+} // TLE_GetLine2
+
+int TLE_GetMeanMotion(const TLE* inTLE, double* outMeanMotion)
+try
+{
+	*outMeanMotion = inTLE->mTLE.GetField(Zeptomoby::OrbitTools::cTle::FLD_MMOTION);
+	return kOK;
+}
+catch (...)
+{
+	// Some unknown excption was thrown
+	std::cerr << "Unexpected exception encountered.\n";
+
+	return kInternalError;
+}
+
+int TLE_GetInclination(const TLE* inTLE, double* outInclination)
+try
+{
+	*outInclination = inTLE->mTLE.GetField(Zeptomoby::OrbitTools::cTle::FLD_I);
+	return kOK;
+}
+catch (...)
+{
+	// Some unknown excption was thrown
+	std::cerr << "Unexpected exception encountered.\n";
+
+	return kInternalError;
+}
+
+int TLE_GetEpoch(const TLE* inTLE, double* out_time)
+try
+{
+	cNoradElements elements{};
+	if (!NoradElementsFromTle(inTLE->mLine1.c_str(), inTLE->mLine2.c_str(), &elements))
+	{
+		return kInvalidTLE;
+	}
+
+	*out_time = (elements.m_jdEpoch - JulianFromUnixTime(0LL).Date()) * SEC_PER_DAY;
+	return kOK;
+}
+catch (...)
+{
+	// Some unknown excption was thrown
+	std::cerr << "Unexpected exception encountered.\n";
+
+	return kInternalError;
+} // TLE_GetEpoch
+
+int TLE_GetModel(const TLE* inTLE, int* outModel)
+try
+{
+	cNoradElements elements{};
+	if (!NoradElementsFromTle(inTLE->mLine1.c_str(), inTLE->mLine2.c_str(), &elements))
+	{
+		return kInvalidTLE;
+	}
+
+	// Same choice as Catalog::Add()
+	if (!elements.IsDeepSpace())
+	{
+		*outModel = NoradIsSimple(elements) ? kOrbitModelSgp4Simple : kOrbitModelSgp4;
+	}
+	else
+	{
+		*outModel = (NoradResonance(elements) == RES_NONE) ? kOrbitModelSdp4 : kOrbitModelSdp4Resonant;
+	}
+	return kOK;
+}
+catch (...)
+{
+	// Some unknown excption was thrown
+	std::cerr << "Unexpected exception encountered.\n";
+
+	return kInternalError;
+} // TLE_GetModel
+
+int TLE_GetPlane(	const TLE*  inTLE,
+					long long   in_time,		// time in seconds since 1970
+					double*     out_raandegs,	// RAAN in degs, 0..360
+					double*     out_arglatdegs)	// argument of latitude in degs, 0..360
+try
+{
+	cNoradElements elements{};
+	if (!NoradElementsFromTle(inTLE->mLine1.c_str(), inTLE->mLine2.c_str(), &elements) || !elements.IsValid())
+	{
+		return kInvalidTLE;
+	}
+
+	// The first order secular rates SGP4 applies, as cJ2Kernel has them
+	const cJ2Kernel rates{elements};
+	const double tsince = (JulianFromUnixTime(in_time).Date() - elements.m_jdEpoch) * MIN_PER_DAY;
+	const double raan = elements.m_RAAN + rates.RaanDot() * tsince;
+	const double argLat = elements.m_ArgPerigee + elements.m_MeanAnomaly +
+						  (rates.ArgpDot() + elements.m_MeanMotion + rates.MeanDotJ2()) * tsince;
+
+	*out_raandegs = rad2deg(NoradReduce(raan));
+	*out_arglatdegs = rad2deg(NoradReduce(argLat));
+	return kOK;
+}
+catch (...)
+{
+	// Some unknown excption was thrown
+	std::cerr << "Unexpected exception encountered.\n";
+
+	return kInternalError;
+} // TLE_GetPlane
+
+// Catalog functions
+int Catalog_Make(const TLE* const inTLEs[], size_t inCount, Catalog** outCatalog)
+try
+{
+	auto catalog = std::make_unique<Catalog>(inTLEs, inCount);
+	*outCatalog = catalog.release();
+	return kOK;
+}
+catch (...)
+{
+	// Some unknown excption was thrown
+	std::cerr << "Unexpected exception encountered.\n";
+
+	return kInvalidTLE;
+} // Catalog_Make
+
+int Catalog_Delete(Catalog* ioCatalog)
+try
+{
+	std::unique_ptr<Catalog> catalog{};
+	// delete the Catalog allocated in Catalog_Make()
+	catalog.reset(ioCatalog);
+
+	return kOK;
+}
+catch (...)
+{
+	// Some unknown excption was thrown
+	std::cerr << "Unexpected exception encountered.\n";
+
+	return kInternalError;
+} // Catalog_Delete
+
+int Catalog_GetCount(const Catalog* inCatalog, size_t* outCount)
+try
+{
+	*outCount = inCatalog->mCount;
+	return kOK;
+}
+catch (...)
+{
+	// Some unknown excption was thrown
+	std::cerr << "Unexpected exception encountered.\n";
+
+	return kInternalError;
+} // Catalog_GetCount
+
+int Catalog_GetStats(const Catalog* inCatalog, CatalogStats* outStats)
+try
+{
+	inCatalog->GetStats(outStats);
+	return kOK;
+}
+catch (...)
+{
+	// Some unknown excption was thrown
+	std::cerr << "Unexpected exception encountered.\n";
+
+	return kInternalError;
+} // Catalog_GetStats
+
+int Catalog_UpdateTLE(Catalog* ioCatalog, size_t inIndex, const TLE* inTLE)
+try
+{
+	if (inIndex >= ioCatalog->mCount)
+	{
+		return kInvalidParameter;
+	}
+
+	cNoradElements elements{};
+	if (!NoradElementsFromTle(inTLE->mLine1.c_str(), inTLE->mLine2.c_str(), &elements))
+	{
+		return kInvalidTLE;
+	}
+
+	ioCatalog->UpdateTLE(inIndex, elements);
+	return kOK;
+}
+catch (...)
+{
+	// Some unknown excption was thrown
+	std::cerr << "Unexpected exception encountered.\n";
+
+	return kInternalError;
+} // Catalog_UpdateTLE
+
+int Catalog_SetFloatTolerance(Catalog* ioCatalog, double inToleranceKm)
+try
+{
+	ioCatalog->SetFloatTolerance(inToleranceKm);
+	return kOK;
+}
+catch (...)
+{
+	// Some unknown excption was thrown
+	std::cerr << "Unexpected exception encountered.\n";
+
+	return kInternalError;
+} // Catalog_SetFloatTolerance
+
+int Catalog_GetFloatError(const Catalog* inCatalog, size_t inIndex, double* outMaxKm, double* outRmsKm, int* outUsesFloat)
+try
+{
+	if (inIndex >= inCatalog->mCount)
+	{
+		return kInvalidParameter;
+	}
+
+	inCatalog->CheckFloat();
+
+	*outMaxKm = 0.0;
+	*outRmsKm = 0.0;
+	*outUsesFloat = 0;
+
+	// Only near earth satellites have a single precision model
+	const std::uint32_t slot = inCatalog->mSlot[inIndex];
+	const auto getError = [&](const auto& inBatch)
+	{
+		*outMaxKm = inBatch.mFloatMaxKm[slot];
+		*outRmsKm = inBatch.mFloatRmsKm[slot];
+		*outUsesFloat = (*outMaxKm <= inCatalog->mFloatToleranceKm) ? 1 : 0;
+	};
+	switch (inCatalog->mModel[inIndex])
+	{
+	case kModelSgp4Simple:
+		getError(inCatalog->mSgp4Simple);
+		break;
+	case kModelSgp4:
+		getError(inCatalog->mSgp4);
+		break;
+	default:
+		break;
+	}
+	return kOK;
+}
+catch (...)
+{
+	// Some unknown excption was thrown
+	std::cerr << "Unexpected exception encountered.\n";
+
+	return kInternalError;
+} // Catalog_GetFloatError
+
+int Catalog_SetJ2Interval(Catalog* ioCatalog, double inMinutes)
+try
+{
+	if (!(inMinutes > 0.0))
+	{
+		return kInvalidParameter;
+	}
 
-#include <iostream>
+	ioCatalog->SetJ2Interval(inMinutes);
+	return kOK;
+}
+catch (...)
+{
+	// Some unknown excption was thrown
+	std::cerr << "Unexpected exception encountered.\n";
 
-#if (!WIN32)
-#define gmtime_s(x, y) (gmtime_r(y, x))
-#define _get_timezone(x)
-#define _snprintf_s (snprintf)
-#endif // WIN32
+	return kInternalError;
+} // Catalog_SetJ2Interval
 
-// orbittools
-// *NOTE: Large portions of this was stolen from orbittools demo
-// "coreLib.h" includes basic types from the core library,
-// such as cSite, cJulian, etc. The header file also contains a
-// "using namespace" statement for Zeptomoby::OrbitTools.
-// C:\Users\mn-fi\Projects\git\libsat355\cppOrbitTools\orbitTools\core\coreLib.h
-#include "coreLib.h"
-// "orbitLib.h" includes basic types from the orbit library,
-// including cOrbit.
-#include "orbitLib.h"
+int Catalog_GetJ2Error(	const Catalog* inCatalog,
+					long long    in_time,			// time in seconds since 1970
+					const double in_intervalmin[],	// re-anchor intervals to measure, in minutes
+					size_t       in_count,			// number of intervals
+					double       out_maxkm[],		// worst position error of each, in km
+					double       out_rmskm[])		// RMS position error of each, in km
+try
+{
+	const cJulian time = JulianFromUnixTime(in_time);
+	for (std::size_t n = 0; n < in_count; ++n)
+	{
+		if (!(in_intervalmin[n] > 0.0))
+		{
+			return kInvalidParameter;
+		}
 
-// Notes on DLLs: 
-// Must use C ABI
-// When using C++ in a Dll, you must prevent C++ from escaping the DLL boundary. 
-//   Notice all the extern "C" declarations and try catches.
-// The reason for this is that DLLs are fundamentally C based, and there is no industry standard that allows C++ to interoperate between compilers.
-// Raw C++ objects or APIs can't be exposed in the DLL interface because of the C ABI restriction.
-// C++ exceptions in the DLL implementation must be caught, handled, and turned into error codes before they cross the DLL boundary.
-// Any resources allocated by DLL implementation must also be de-allocated by DLL implementation. 
-//   Alllocating memory is done through C++ runtime, but we don't know if the DLL and the application are using the same runtime.
-//   Therefore, allocation and deallocation must be done in the same module, else you risk heap corruption.
-// https://docs.microsoft.com/en-us/cpp/build/walkthrough-creating-and-using-a-dynamic-link-library-cpp?view=msvc-160
+		inCatalog->GetJ2Error(time, in_intervalmin[n], &out_maxkm[n], &out_rmskm[n]);
+	}
+	return kOK;
+}
+catch (...)
+{
+	// Some unknown excption was thrown
+	std::cerr << "Unexpected exception encountered.\n";
 
-// Best Practices:
-// C API using opaque data types
-// The DLL implementation defines concrete data types for the opaque data types that wraps any internal classes.
+	return kInternalError;
+} // Catalog_GetJ2Error
 
-// IOS Core Foundation: Date::init(timeIntervalSinceReferenceDate: TimeInterval)
-const double EPOCH_JAN1_00H_2001 = 2451910.5; // Jan  1.0 2001 = Jan  1 2001 00h UTC
+int Catalog_ToLLA(	const Catalog* inCatalog,
+					long long   in_time,		// time in seconds since 1970
+					int         in_flags,		// PropagateFlags
+					double      out_latdegs[],	// latitude in degs
+					double      out_londegs[],	// longitude in degs
+					double      out_altkm[],	// altitude in km
+					int         out_status[])	// ErrorCode per satellite
+try
+{
+	inCatalog->ToLLA(JulianFromUnixTime(in_time), in_flags, out_latdegs, out_londegs, out_altkm, out_status);
+	return kOK;
+}
+catch (...)
+{
+	// Some unknown excption was thrown
+	std::cerr << "Unexpected exception encountered.\n";
 
-// struct TLE wraps the concrete zeptomoby class to fix
-// problems with the zeptomoby std::string getters
-// zeptomoby returns its strings as values, instead of const reference
-//
-// Q: Should we prefer to aggregate(has-a) or inherit(is-a) zeptmoby cTle?
-// A: In general, prefer aggregation
-// Why? Aggregation eliminates unwanted dependencies on the wrapped class
-// https://en.wikipedia.org/wiki/Composition_over_inheritance#Benefits
+	return kInternalError;
+} // Catalog_ToLLA
 
-struct TLE //: public Zeptomoby::OrbitTools::cTle // prefer aggregation over inheritance
+int Catalog_ToLLAD(	const Catalog* inCatalog,
+					double      in_time,		// time in seconds since 1970
+					int         in_flags,		// PropagateFlags
+					double      out_latdegs[],	// latitude in degs
+					double      out_londegs[],	// longitude in degs
+					double      out_altkm[],	// altitude in km
+					int         out_status[])	// ErrorCode per satellite
+try
 {
-	std::string mName{};
-	std::string mLine1{};
-	std::string mLine2{};
-	Zeptomoby::OrbitTools::cTle mTLE;
+	inCatalog->ToLLA(JulianFromUnixTime(in_time), in_flags, out_latdegs, out_londegs, out_altkm, out_status);
+	return kOK;
+}
+catch (...)
+{
+	// Some unknown excption was thrown
+	std::cerr << "Unexpected exception encountered.\n";
 
-	TLE(const char* inName, const char* inLine1, const char* inLine2) :
-		mTLE{inName, inLine1, inLine2}
+	return kInternalError;
+} // Catalog_ToLLAD
+
+int Catalog_ToLLATimes(	const Catalog* inCatalog,
+					const long long in_times[],		// times in seconds since 1970
+					size_t      in_timecount,	// number of times
+					int         in_flags,		// PropagateFlags
+					double      out_latdegs[],	// latitude in degs
+					double      out_londegs[],	// longitude in degs
+					double      out_altkm[],	// altitude in km
+					int         out_status[])	// ErrorCode per satellite and time
+try
+{
+	const std::vector<cJulian> times = JulianFromUnixTimes(in_times, in_timecount);
+	inCatalog->ToLLATimes(times, in_flags, Catalog::LLAMatrix{out_latdegs, out_londegs, out_altkm, out_status});
+	return kOK;
+}
+catch (...)
+{
+	// Some unknown excption was thrown
+	std::cerr << "Unexpected exception encountered.\n";
+
+	return kInternalError;
+} // Catalog_ToLLATimes
+
+int Catalog_ToLLATimesD(	const Catalog* inCatalog,
+					const double in_times[],		// times in seconds since 1970
+					size_t      in_timecount,	// number of times
+					int         in_flags,		// PropagateFlags
+					double      out_latdegs[],	// latitude in degs
+					double      out_londegs[],	// longitude in degs
+					double      out_altkm[],	// altitude in km
+					int         out_status[])	// ErrorCode per satellite and time
+try
+{
+	const std::vector<cJulian> times = JulianFromUnixTimes(in_times, in_timecount);
+	inCatalog->ToLLATimes(times, in_flags, Catalog::LLAMatrix{out_latdegs, out_londegs, out_altkm, out_status});
+	return kOK;
+}
+catch (...)
+{
+	// Some unknown excption was thrown
+	std::cerr << "Unexpected exception encountered.\n";
+
+	return kInternalError;
+} // Catalog_ToLLATimesD
+
+namespace /*anonymous*/ {
+
+// A known frame, and either all three velocity arrays or none
+bool CartesianArgsValid(int in_frame, const double* in_vxkms, const double* in_vykms, const double* in_vzkms)
+{
+	if (in_frame != kFrameECI && in_frame != kFrameECEF)
 	{
-		mName = std::move(mTLE.Name());
-		mLine1 = std::move(mTLE.Line1());
-		mLine2 = std::move(mTLE.Line2());
+		return false;
 	}
-};
+	return (in_vxkms == nullptr) == (in_vykms == nullptr) && (in_vxkms == nullptr) == (in_vzkms == nullptr);
+}
 
-// TRICKY: extern "C"- Make functions callable from SwiftUI.
-// Force orbit_to_lla() to be "C" rather than "C++" function.
-// Needed because SwiftUI binding header can only call into "C".
-extern "C" {
+} // namespace anonymous
 
-int HelloWorld()
+int Catalog_ToCartesian(	const Catalog* inCatalog,
+					long long   in_time,		// time in seconds since 1970
+					int         in_flags,		// PropagateFlags
+					int         in_frame,		// CartesianFrame
+					double      out_xkm[],		// position in km
+					double      out_ykm[],
+					double      out_zkm[],
+					double      out_vxkms[],	// velocity in km/sec, or NULL
+					double      out_vykms[],
+					double      out_vzkms[],
+					int         out_status[])	// ErrorCode per satellite
+try
 {
-	std::cout << "Hello World!" << std::endl;
+	if (!CartesianArgsValid(in_frame, out_vxkms, out_vykms, out_vzkms))
+	{
+		return kInvalidParameter;
+	}
 
+	const EciArrays state{out_xkm, out_ykm, out_zkm, out_vxkms, out_vykms, out_vzkms};
+	inCatalog->ToCartesian(JulianFromUnixTime(in_time), in_flags, in_frame, state, out_status);
 	return kOK;
 }
+catch (...)
+{
+	// Some unknown excption was thrown
+	std::cerr << "Unexpected exception encountered.\n";
 
-// TLE Helper functions
-int TLE_Make(const char* inName, const char* inLine1, const char* inLine2, TLE** outTLE)
+	return kInternalError;
+} // Catalog_ToCartesian
+
+int Catalog_ToCartesianD(	const Catalog* inCatalog,
+					double      in_time,		// time in seconds since 1970
+					int         in_flags,		// PropagateFlags
+					int         in_frame,		// CartesianFrame
+					double      out_xkm[],		// position in km
+					double      out_ykm[],
+					double      out_zkm[],
+					double      out_vxkms[],	// velocity in km/sec, or NULL
+					double      out_vykms[],
+					double      out_vzkms[],
+					int         out_status[])	// ErrorCode per satellite
 try
 {
-	// Look ma, no raw new TLE{}!
-	auto tle = std::make_unique<TLE>(inName, inLine1, inLine2);
-	// return the concrete zeptomoby class as an opaque TLE*
-	*outTLE = tle.release();
+	if (!CartesianArgsValid(in_frame, out_vxkms, out_vykms, out_vzkms))
+	{
+		return kInvalidParameter;
+	}
+
+	const EciArrays state{out_xkm, out_ykm, out_zkm, out_vxkms, out_vykms, out_vzkms};
+	inCatalog->ToCartesian(JulianFromUnixTime(in_time), in_flags, in_frame, state, out_status);
 	return kOK;
 }
 catch (...)
@@ -94,17 +1804,25 @@ catch (...)
 	std::cerr << "Unexpected exception encountered.\n";
 
 	return kInternalError;
-} // TLE_Make
+} // Catalog_ToCartesianD
 
+// struct Site wraps the precomputed site geometry
+struct Site
+{
+	cSiteKernel mSite;
 
-int TLE_Delete(TLE* ioTLE)
+	Site(double in_latdegs, double in_londegs, double in_altkm) :
+		mSite{deg2rad(in_latdegs), deg2rad(in_londegs), in_altkm}
+	{
+	}
+};
+
+// Site functions
+int Site_Make(double in_latdegs, double in_londegs, double in_altkm, Site** outSite)
 try
 {
-	// Look ma, no raw delete inTLE!
-	std::unique_ptr<TLE> tle{};
-	// delete the concrete zeptomoby class allocated in TLE_Make()
-	tle.reset(ioTLE);
-
+	auto site = std::make_unique<Site>(in_latdegs, in_londegs, in_altkm);
+	*outSite = site.release();
 	return kOK;
 }
 catch (...)
@@ -113,13 +1831,15 @@ catch (...)
 	std::cerr << "Unexpected exception encountered.\n";
 
 	return kInternalError;
-} // TLE_Delete
+} // Site_Make
 
-// TLE Name
-int TLE_GetName(const TLE* inTLE, const char* outName[])
+int Site_Delete(Site* ioSite)
 try
 {
-	*outName = inTLE->mName.c_str();	
+	std::unique_ptr<Site> site{};
+	// delete the Site allocated in Site_Make()
+	site.reset(ioSite);
+
 	return kOK;
 }
 catch (...)
@@ -128,13 +1848,29 @@ catch (...)
 	std::cerr << "Unexpected exception encountered.\n";
 
 	return kInternalError;
-} // TLE_GetName
+} // Site_Delete
 
-// TLE Line1
-int TLE_GetLine1(const TLE* inTLE, const char* outLine1[])
+int Catalog_LookAngles(	const Catalog* inCatalog,
+					const Site* inSite,
+					long long   in_time,		// time in seconds since 1970
+					int         in_flags,		// PropagateFlags
+					double      in_mineledegs,	// lowest elevation wanted, in degs
+					size_t*     out_count,		// number of visible satellites
+					size_t      out_index[],	// catalog index of each
+					double      out_azdegs[],	// look angle azimuth in degs
+					double      out_eledegs[],	// look angle elevation in degs
+					double      out_rangekm[],	// range in km
+					double      out_ratekms[])	// range rate in km/sec, negative toward the site
 try
 {
-	*outLine1 = inTLE->mLine1.c_str();	
+	const std::size_t visible = inCatalog->LookAngles(JulianFromUnixTime(in_time), in_flags, inSite->mSite, deg2rad(in_mineledegs),
+													  out_index, out_azdegs, out_eledegs, out_rangekm, out_ratekms);
+	for (std::size_t n = 0; n < visible; ++n)
+	{
+		out_azdegs[n] = rad2deg(out_azdegs[n]);
+		out_eledegs[n] = rad2deg(out_eledegs[n]);
+	}
+	*out_count = visible;
 	return kOK;
 }
 catch (...)
@@ -143,13 +1879,32 @@ catch (...)
 	std::cerr << "Unexpected exception encountered.\n";
 
 	return kInternalError;
-} // TLE_GetLine1
+} // Catalog_LookAngles
 
-// TLE Line2
-int TLE_GetLine2(const TLE* inTLE, const char* outLine2[])
+// Satellite functions
+int Satellite_Init(const char* inName, const char* inLine1, const char* inLine2, Satellite* outSatellite)
 try
 {
-	*outLine2 = inTLE->mLine2.c_str();	
+	cNoradElements elements{};
+	if (!NoradElementsFromTle(inLine1, inLine2, &elements) || !elements.IsValid())
+	{
+		return kInvalidTLE;
+	}
+
+	// Name, trailing blanks removed as cTle does
+	std::size_t length = 0;
+	while ((length < kSatelliteNameSize - 1) && (inName[length] != '\0'))
+	{
+		outSatellite->mName[length] = inName[length];
+		++length;
+	}
+	while ((length > 0) && std::isspace(static_cast<unsigned char>(outSatellite->mName[length - 1])))
+	{
+		--length;
+	}
+	outSatellite->mName[length] = '\0';
+
+	::new (static_cast<void*>(outSatellite->mState)) cNoradModel(elements);
 	return kOK;
 }
 catch (...)
@@ -157,13 +1912,78 @@ catch (...)
 	// Some unknown excption was thrown
 	std::cerr << "Unexpected exception encountered.\n";
 
+	return kInvalidTLE;
+} // Satellite_Init
+
+int Satellite_ToLLA(	const Satellite* inSatellite,
+					long long   in_time,		// time in seconds since 1970
+					int         in_flags,		// PropagateFlags
+					double*     out_latdegs,	// latitude in degs
+					double*     out_londegs,	// longitude in degs
+					double*     out_altkm)		// altitude in km
+try
+{
+	// Lat/Lon/Alt never needs the velocity, whatever in_flags says
+	(void)in_flags;
+	const cJulian time = JulianFromUnixTime(in_time);
+	return KernelToLLA<true>(SatelliteModel(*inSatellite), time.Date(), time.ToGmst(), out_latdegs, out_londegs, out_altkm);
+}
+catch (...)
+{
+	// Some unknown excption was thrown
+	std::cerr << "Unexpected exception encountered.\n";
+
 	return kInternalError;
-} // TLE_GetLine2
+} // Satellite_ToLLA
 
-int TLE_GetMeanMotion(const TLE* inTLE, double* outMeanMotion)
+// struct Ephemeris wraps a cEphemeris fitted from the TLE's cSatellite
+struct Ephemeris
+{
+	cEphemeris mEphemeris;
+	cJulian mEpoch;
+
+	Ephemeris(const cTle& inTLE, double inSegmentMinutes, double inToleranceKm, bool inVelocity) :
+		mEphemeris{cSatellite(inTLE), inSegmentMinutes, inToleranceKm, cEphemeris::DEFAULT_ORDER, inVelocity},
+		mEpoch{mEphemeris.Satellite().Orbit().Epoch()}
+	{
+	}
+
+	// Minutes past the TLE epoch for in_time, in seconds since 1970
+	double MinutesPastEpoch(const cJulian& inTime) const
+	{
+		return inTime.SpanMin(mEpoch);
+	}
+};
+
+// Ephemeris functions
+int Ephemeris_Make(const TLE* inTLE, double inSegmentMinutes, double inToleranceKm, int in_flags, Ephemeris** outEphemeris)
 try
 {
-	*outMeanMotion = inTLE->mTLE.GetField(Zeptomoby::OrbitTools::cTle::FLD_MMOTION);
+	if (!(inSegmentMinutes > 0.0))
+	{
+		return kInvalidTime;
+	}
+
+	const bool velocity = ((in_flags & kPropagatePositionOnly) == 0);
+	auto ephemeris = std::make_unique<Ephemeris>(inTLE->mTLE, inSegmentMinutes, inToleranceKm, velocity);
+	*outEphemeris = ephemeris.release();
+	return kOK;
+}
+catch (...)
+{
+	// Some unknown excption was thrown
+	std::cerr << "Unexpected exception encountered.\n";
+
+	return kInvalidTLE;
+} // Ephemeris_Make
+
+int Ephemeris_Delete(Ephemeris* ioEphemeris)
+try
+{
+	std::unique_ptr<Ephemeris> ephemeris{};
+	// delete the Ephemeris allocated in Ephemeris_Make()
+	ephemeris.reset(ioEphemeris);
+
 	return kOK;
 }
 catch (...)
@@ -172,21 +1992,100 @@ catch (...)
 	std::cerr << "Unexpected exception encountered.\n";
 
 	return kInternalError;
+} // Ephemeris_Delete
+
+int Ephemeris_GetStats(const Ephemeris* inEphemeris, EphemerisStats* outStats)
+try
+{
+	const cEphemeris& ephemeris = inEphemeris->mEphemeris;
+	outStats->mHits = ephemeris.Hits();
+	outStats->mMisses = ephemeris.Misses();
+	outStats->mDirect = ephemeris.Direct();
+	outStats->mSegments = ephemeris.Segments();
+	outStats->mBytes = sizeof(Ephemeris) + ephemeris.Bytes();
+	outStats->mMaxFitErrorKm = ephemeris.MaxFitErrorKm();
+	return kOK;
 }
+catch (...)
+{
+	// Some unknown excption was thrown
+	std::cerr << "Unexpected exception encountered.\n";
 
-int TLE_GetInclination(const TLE* inTLE, double* outInclination)
+	return kInternalError;
+} // Ephemeris_GetStats
+
+int Ephemeris_ToLLA(	Ephemeris*  ioEphemeris,
+					double      in_time,		// time in seconds since 1970
+					double*     out_latdegs,	// latitude in degs
+					double*     out_londegs,	// longitude in degs
+					double*     out_altkm)		// altitude in km
 try
 {
-	*outInclination = inTLE->mTLE.GetField(Zeptomoby::OrbitTools::cTle::FLD_I);
+	const cJulian time = JulianFromUnixTime(in_time);
+	double pos[3]{};
+	ioEphemeris->mEphemeris.Position(ioEphemeris->MinutesPastEpoch(time), pos);
+
+	double lat = 0.0;
+	double lon = 0.0;
+	EciToGeo(pos[0], pos[1], pos[2], time.ToGmst(), &lat, &lon, out_altkm);
+	*out_latdegs = rad2deg(lat);
+	*out_londegs = ToLonDegs(lon);
 	return kOK;
 }
+catch (const cDecayException&)
+{
+	return kDecayed;
+}
+catch (const cPropagationException&)
+{
+	// cNoradBase throws this only for the eccentricity
+	return kEccentricityOutOfRange;
+}
 catch (...)
 {
 	// Some unknown excption was thrown
 	std::cerr << "Unexpected exception encountered.\n";
 
 	return kInternalError;
+} // Ephemeris_ToLLA
+
+int Ephemeris_ToEci(	Ephemeris*  ioEphemeris,
+					double      in_time,		// time in seconds since 1970
+					double      out_poskm[3],	// ECI position in km
+					double      out_velkms[3])	// ECI velocity in km/sec, or NULL
+try
+{
+	cEphemeris& ephemeris = ioEphemeris->mEphemeris;
+	const double mpe = ioEphemeris->MinutesPastEpoch(JulianFromUnixTime(in_time));
+	if (out_velkms == nullptr)
+	{
+		ephemeris.Position(mpe, out_poskm);
+		return kOK;
+	}
+
+	// Made with kPropagatePositionOnly: the caller asked for what the ephemeris does not have
+	if (!ephemeris.PositionVelocity(mpe, out_poskm, out_velkms))
+	{
+		return kInvalidParameter;
+	}
+	return kOK;
+}
+catch (const cDecayException&)
+{
+	return kDecayed;
 }
+catch (const cPropagationException&)
+{
+	// cNoradBase throws this only for the eccentricity
+	return kEccentricityOutOfRange;
+}
+catch (...)
+{
+	// Some unknown excption was thrown
+	std::cerr << "Unexpected exception encountered.\n";
+
+	return kInternalError;
+} // Ephemeris_ToEci
 
 // orbit_to_lla:
 // Calculate satellite Lat/Lon/Alt for time "now" using
@@ -271,6 +2170,15 @@ int orbit_to_lla(	long long 	in_time,	// time in seconds since 1970
 
 		return kOK;
 	}
+	catch (const cDecayException&)
+	{
+		return kDecayed;
+	}
+	catch (const cPropagationException&)
+	{
+		// cNoradBase throws this only for the eccentricity
+		return kEccentricityOutOfRange;
+	}
     catch (...)
     {
         // Some unknown excption was thrown
@@ -379,6 +2287,15 @@ int orbit_to_lla2( 	long long   in_time,	// time in seconds since 1970
 
 		return kOK;
 	}
+	catch (const cDecayException&)
+	{
+		return kDecayed;
+	}
+	catch (const cPropagationException&)
+	{
+		// cNoradBase throws this only for the eccentricity
+		return kEccentricityOutOfRange;
+	}
     catch (...)
     {
         // Some unknown excption was thrown
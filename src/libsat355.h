@@ -1,6 +1,7 @@
 #ifndef LIBSAT355_H
 #define LIBSAT355_H
 
+#include <stddef.h>
 #include <stdio.h>
 #include <time.h>
 
@@ -9,6 +10,8 @@
 #include <stdexcept>
 #include <string>
 #include <string_view>
+#include <utility>
+#include <vector>
 
 #include "dllmain.h"
 
@@ -23,14 +26,22 @@ enum ErrorCode
     kOK = 0,
     kInvalidTLE,
     kInvalidTime,
-    kInternalError
+    kInternalError,
+
+    // Propagation failures of one satellite at one time
+    kDecayed,                   // below the earth's surface
+    kEccentricityOutOfRange,    // propagated eccentricity is not in 0..1
+    kBadElements,               // elements give no usable orbit
+
+    kInvalidParameter           // the arguments do not fit the call, e.g. an index past the end; see each function
 };
 
 DLL_EXPORT int HelloWorld();
 
 // orbit_to_lla:
 // Calculate satellite Lat/Lon/Alt for time "now" using
-// input TLE-format orbital data
+// input TLE-format orbital data. A satellite that cannot be
+// propagated to in_time returns kDecayed or kEccentricityOutOfRange.
 DLL_EXPORT int  orbit_to_lla(	
                     long long   in_time,	// time in seconds since 1970
 					const char* in_tle1,	// TLE (Sat Name)
@@ -44,7 +55,8 @@ DLL_EXPORT int  orbit_to_lla(
 
 // orbit_to_lla2:
 // Calculate satellite Lat/Lon/Alt plus look-angles
-// for time "now" using input TLE-format orbital data
+// for time "now" using input TLE-format orbital data.
+// Returns the same ErrorCodes as orbit_to_lla().
 DLL_EXPORT int orbit_to_lla2(	
 					long long   in_time,	// time in seconds since 1970
                     const char* in_tle1,	// TLE (Sat Name)
@@ -73,6 +85,342 @@ DLL_EXPORT int TLE_GetLine2(const TLE* inTLE, const char* outLine2[]);
 DLL_EXPORT int TLE_GetMeanMotion(const TLE* inTLE, double* outMeanMotion);
 DLL_EXPORT int TLE_GetInclination(const TLE* inTLE, double* outInclination);
 
+// Epoch of the elements, in seconds since 1970 with the fraction of the
+// day kept. The age of a TLE at a time is that time minus its epoch.
+DLL_EXPORT int TLE_GetEpoch(const TLE* inTLE, double* out_time);
+
+// Propagation model a TLE needs: SGP4 for periods under 225 minutes,
+// SDP4 for the rest. Costs per call differ a lot. SDP4 is several times
+// SGP4, and the resonant SDP4 variants integrate from the TLE epoch on
+// every call, so they get slower as the TLE ages.
+enum OrbitModel
+{
+    kOrbitModelSgp4Simple = 0,  // SGP4, perigee below 220 km
+    kOrbitModelSgp4,            // SGP4
+    kOrbitModelSdp4,            // SDP4
+    kOrbitModelSdp4Resonant     // SDP4, 12 or 24 hour resonant
+};
+
+DLL_EXPORT int TLE_GetModel(const TLE* inTLE, int* outModel);	// OrbitModel
+
+// TLE_GetPlane:
+// Orbital plane and position in it at in_time: the right ascension of
+// the ascending node, and the mean argument of latitude (argument of
+// perigee plus mean anomaly). Both are advanced from the TLE epoch by the
+// J2 secular rates and the mean motion, without periodics, so TLEs with
+// different epochs can be compared at one time. Satellites in one plane
+// share the RAAN; their spacing along it is the difference of argument of
+// latitude. kInvalidTLE if the elements are not a bound orbit.
+DLL_EXPORT int TLE_GetPlane(	const TLE*  inTLE,
+					long long   in_time,		// time in seconds since 1970
+					double*     out_raandegs,	// RAAN in degs, 0..360
+					double*     out_arglatdegs);	// argument of latitude in degs, 0..360
+
+// Catalog (batch) functions
+// A Catalog decodes a set of TLEs once, then propagates all of them
+// to a given time in a single call. Output arrays are in the same
+// order as the TLEs the Catalog was made from.
+//
+// Deep space satellites take their lunar-solar terms at the start of
+// the 10 minute slot their TLE epoch falls in, both when the Catalog is
+// made and in Catalog_UpdateTLE(). Within +/-3 days of the epoch their
+// positions may differ from orbit_to_lla() by up to ~0.1 m, but never
+// depend on the other TLEs in the Catalog or their order.
+struct Catalog;
+typedef struct Catalog Catalog;
+
+// Catalog propagation flags; combine with |
+enum PropagateFlags
+{
+    kPropagateDefault      = 0,         // double precision throughout
+    kPropagateFloat        = 1 << 0,    // single precision "display grade", see Catalog_SetFloatTolerance()
+    kPropagatePositionOnly = 1 << 1,    // skip the velocity terms; Lat/Lon/Alt calls always do
+    kPropagateJ2           = 1 << 2     // analytic J2 between full model anchors, see Catalog_SetJ2Interval()
+};
+
+DLL_EXPORT int Catalog_Make(const TLE* const inTLEs[], size_t inCount, Catalog** outCatalog);
+DLL_EXPORT int Catalog_Delete(Catalog* ioCatalog);
+DLL_EXPORT int Catalog_GetCount(const Catalog* inCatalog, size_t* outCount);
+
+// Quarantine:
+// The first time a satellite fails to propagate (kDecayed,
+// kEccentricityOutOfRange or kBadElements), the Catalog quarantines it.
+// From then on every call reports the same ErrorCode for it without
+// running its model, at any time, until its TLE is replaced with
+// Catalog_UpdateTLE(). Satellites whose elements are not a bound orbit
+// are quarantined as kBadElements when the Catalog is made. Nothing is
+// logged; Catalog_GetStats() counts what happened instead.
+typedef struct CatalogStats
+{
+    unsigned long long  mDecayed;       // satellites quarantined as kDecayed
+    unsigned long long  mEccentricity;  // ... as kEccentricityOutOfRange
+    unsigned long long  mBadElements;   // ... as kBadElements
+    unsigned long long  mSkipped;       // propagations skipped for quarantined satellites
+    size_t              mQuarantined;   // satellites in quarantine now
+} CatalogStats;
+
+DLL_EXPORT int Catalog_GetStats(const Catalog* inCatalog, CatalogStats* outStats);
+
+// Replace the TLE of satellite inIndex, e.g. with a newer one, and lift
+// its quarantine. Not thread-safe: no other call may use the Catalog
+// at the same time. kInvalidParameter if inIndex is not in the Catalog.
+DLL_EXPORT int Catalog_UpdateTLE(Catalog* ioCatalog, size_t inIndex, const TLE* inTLE);
+
+// kPropagateFloat is only used for satellites whose single precision
+// position stays within inToleranceKm of the double precision position
+// over +/-3 days from their TLE epoch; all others fall back to double.
+// The default tolerance is 0.010 km.
+DLL_EXPORT int Catalog_SetFloatTolerance(Catalog* ioCatalog, double inToleranceKm);
+
+// Measured single precision position error of one satellite over
+// +/-3 days from its TLE epoch, and whether kPropagateFloat uses it.
+// kInvalidParameter if inIndex is not in the Catalog.
+DLL_EXPORT int Catalog_GetFloatError(const Catalog* inCatalog, size_t inIndex, double* outMaxKm, double* outRmsKm, int* outUsesFloat);
+
+// kPropagateJ2 is a fast mode for animation: many calls a second, each
+// a short step from the last. Time is cut into intervals of inMinutes,
+// starting at whole multiples of inMinutes since 1970. The first call in
+// an interval runs the full model for every satellite at both ends of it
+// and fits an analytic J2 orbit (Kepler plus the J2 drift of the node,
+// perigee and mean anomaly) through the two positions; every call in the
+// interval then uses only that fit. Positions match the full model at
+// the interval ends and join there without a jump; in between they are
+// off by up to about 15 m in LEO with the default interval of 1 minute.
+// A satellite whose full model fails at either end uses the full model
+// at the time asked for instead, and is only quarantined if it fails
+// there. kPropagateFloat is ignored with kPropagateJ2.
+// Use Catalog_GetJ2Error() to choose an interval. kInvalidParameter if
+// inMinutes is not above 0.
+DLL_EXPORT int Catalog_SetJ2Interval(Catalog* ioCatalog, double inMinutes);
+
+// Catalog_GetJ2Error:
+// Error-vs-horizon report for kPropagateJ2. For each re-anchor interval
+// in in_intervalmin, fit the interval holding in_time as kPropagateJ2
+// would, and compare it with the full model at 10 points across it, for
+// every satellite. The worst and RMS position errors go to out_maxkm and
+// out_rmskm. This does not change the Catalog's own interval, and
+// satellites that fail along the way are not quarantined.
+// kInvalidParameter if any interval is not above 0.
+DLL_EXPORT int Catalog_GetJ2Error(	const Catalog* inCatalog,
+					long long    in_time,			// time in seconds since 1970
+					const double in_intervalmin[],	// re-anchor intervals to measure, in minutes
+					size_t       in_count,			// number of intervals
+					double       out_maxkm[],		// worst position error of each, in km
+					double       out_rmskm[]);		// RMS position error of each, in km
+
+// Catalog_ToLLA:
+// Calculate Lat/Lon/Alt of every satellite in the catalog for in_time.
+// Each output array must hold Catalog_GetCount() elements; out_status
+// receives an ErrorCode per satellite, and Lat/Lon/Alt are 0 where it is
+// not kOK.
+DLL_EXPORT int Catalog_ToLLA(	const Catalog* inCatalog,
+					long long   in_time,		// time in seconds since 1970
+					int         in_flags,		// PropagateFlags
+					double      out_latdegs[],	// latitude in degs
+					double      out_londegs[],	// longitude in degs
+					double      out_altkm[],	// altitude in km
+					int         out_status[]);	// ErrorCode per satellite
+
+// Catalog_ToLLAD:
+// Catalog_ToLLA() for a time with fractional seconds, e.g. for ticks
+// faster than 1 Hz. With kPropagateJ2 each call is only the analytic
+// fit, so short steps stay cheap.
+DLL_EXPORT int Catalog_ToLLAD(	const Catalog* inCatalog,
+					double      in_time,		// time in seconds since 1970
+					int         in_flags,		// PropagateFlags
+					double      out_latdegs[],	// latitude in degs
+					double      out_londegs[],	// longitude in degs
+					double      out_altkm[],	// altitude in km
+					int         out_status[]);	// ErrorCode per satellite
+
+// Catalog_ToLLATimes:
+// Catalog_ToLLA() for in_timecount times at once. The outputs are a
+// matrix of Catalog_GetCount() rows, one per satellite, and in_timecount
+// columns: element [index * in_timecount + n] is the satellite at catalog
+// index 'index' at in_times[n]. Each time is converted once, and each
+// satellite is propagated to all of the times before the next, so this
+// is faster than calling Catalog_ToLLA() per time. The results are the
+// same as calling it for each time in turn: a satellite that fails at one
+// time is quarantined, and reports that ErrorCode for the times after it.
+DLL_EXPORT int Catalog_ToLLATimes(	const Catalog* inCatalog,
+					const long long in_times[],		// times in seconds since 1970
+					size_t      in_timecount,	// number of times
+					int         in_flags,		// PropagateFlags
+					double      out_latdegs[],	// latitude in degs
+					double      out_londegs[],	// longitude in degs
+					double      out_altkm[],	// altitude in km
+					int         out_status[]);	// ErrorCode per satellite and time
+
+// Catalog_ToLLATimesD:
+// Catalog_ToLLATimes() for times with fractional seconds.
+DLL_EXPORT int Catalog_ToLLATimesD(	const Catalog* inCatalog,
+					const double in_times[],		// times in seconds since 1970
+					size_t      in_timecount,	// number of times
+					int         in_flags,		// PropagateFlags
+					double      out_latdegs[],	// latitude in degs
+					double      out_londegs[],	// longitude in degs
+					double      out_altkm[],	// altitude in km
+					int         out_status[]);	// ErrorCode per satellite and time
+
+// Catalog_ToCartesian:
+// Position and velocity of every satellite in the catalog for in_time,
+// as Cartesian arrays straight from the propagator. Nothing goes through
+// Lat/Lon/Alt, so no geodetic solve is done.
+//
+// kFrameECI is the frame SGP4/SDP4 work in: true equator, mean equinox
+// of date (TEME). z is the earth's rotation axis, x points to the mean
+// vernal equinox.
+//
+// kFrameECEF is kFrameECI rotated about z by the Greenwich Mean Sidereal
+// Time of in_time, computed once for the whole batch: x points to
+// longitude 0 on the equator, y to 90 degs east. This is the frame the
+// Lat/Lon of Catalog_ToLLA() are measured in. Polar motion and the
+// equation of the equinoxes are ignored. ECEF velocity is relative to
+// the rotating earth.
+//
+// Positions are km, velocities km/sec. Each output array must hold
+// Catalog_GetCount() elements. The three velocity arrays may all be NULL;
+// with kPropagatePositionOnly they are filled with 0. Outputs are 0 where
+// out_status is not kOK. kInvalidParameter if in_frame is not a
+// CartesianFrame, or only some of the velocity arrays are NULL.
+enum CartesianFrame
+{
+    kFrameECI  = 0,     // true equator, mean equinox of date
+    kFrameECEF = 1      // earth-fixed, rotated by GMST
+};
+
+DLL_EXPORT int Catalog_ToCartesian(	const Catalog* inCatalog,
+					long long   in_time,		// time in seconds since 1970
+					int         in_flags,		// PropagateFlags
+					int         in_frame,		// CartesianFrame
+					double      out_xkm[],		// position in km
+					double      out_ykm[],
+					double      out_zkm[],
+					double      out_vxkms[],	// velocity in km/sec, or NULL
+					double      out_vykms[],
+					double      out_vzkms[],
+					int         out_status[]);	// ErrorCode per satellite
+
+// Catalog_ToCartesianD:
+// Catalog_ToCartesian() for a time with fractional seconds, with the
+// same kInvalidParameter cases.
+DLL_EXPORT int Catalog_ToCartesianD(	const Catalog* inCatalog,
+					double      in_time,		// time in seconds since 1970
+					int         in_flags,		// PropagateFlags
+					int         in_frame,		// CartesianFrame
+					double      out_xkm[],		// position in km
+					double      out_ykm[],
+					double      out_zkm[],
+					double      out_vxkms[],	// velocity in km/sec, or NULL
+					double      out_vykms[],
+					double      out_vzkms[],
+					int         out_status[]);	// ErrorCode per satellite
+
+// Site functions
+// A Site is an observer on the ground. Its earth-fixed position and local
+// horizon frame are computed once, when it is made.
+struct Site;
+typedef struct Site Site;
+
+DLL_EXPORT int Site_Make(double in_latdegs, double in_londegs, double in_altkm, Site** outSite);
+DLL_EXPORT int Site_Delete(Site* ioSite);
+
+// Catalog_LookAngles:
+// Look angles from inSite to every satellite in the catalog that is at
+// or above in_mineledegs at in_time. Satellites below it are rejected
+// before any azimuth/elevation math. The catalog index of each visible
+// satellite goes to out_index, and its look angle to the same position
+// of the other arrays; *out_count receives the number visible. Each
+// output array must hold Catalog_GetCount() elements. With
+// kPropagatePositionOnly the range rate is 0.
+DLL_EXPORT int Catalog_LookAngles(	const Catalog* inCatalog,
+					const Site* inSite,
+					long long   in_time,		// time in seconds since 1970
+					int         in_flags,		// PropagateFlags
+					double      in_mineledegs,	// lowest elevation wanted, in degs
+					size_t*     out_count,		// number of visible satellites
+					size_t      out_index[],	// catalog index of each
+					double      out_azdegs[],	// look angle azimuth in degs
+					double      out_eledegs[],	// look angle elevation in degs
+					double      out_rangekm[],	// range in km
+					double      out_ratekms[]);	// range rate in km/sec, negative toward the site
+
+// Satellite functions
+// A Satellite is a plain value owned by the caller: its name, decoded
+// mean elements and propagation model are stored inline, so making,
+// copying and propagating one never allocates. There is no _Delete();
+// copy it by assignment or memcpy.
+enum
+{
+    kSatelliteNameSize  = 25,   // 24 characters plus nul
+    kSatelliteStateSize = 80    // doubles of opaque model state
+};
+
+typedef struct Satellite
+{
+    double  mState[kSatelliteStateSize];    // opaque; set by Satellite_Init()
+    char    mName[kSatelliteNameSize];      // satellite name, trailing blanks removed
+} Satellite;
+
+DLL_EXPORT int Satellite_Init(const char* inName, const char* inLine1, const char* inLine2, Satellite* outSatellite);
+
+// Satellite_ToLLA:
+// Calculate satellite Lat/Lon/Alt for in_time. kPropagateFloat and
+// kPropagateJ2 are ignored: a single Satellite always propagates with
+// the full model in double precision.
+DLL_EXPORT int Satellite_ToLLA(	const Satellite* inSatellite,
+					long long   in_time,		// time in seconds since 1970
+					int         in_flags,		// PropagateFlags
+					double*     out_latdegs,	// latitude in degs
+					double*     out_londegs,	// longitude in degs
+					double*     out_altkm);		// altitude in km
+
+// Ephemeris functions
+// An Ephemeris caches piecewise Chebyshev fits of one satellite's ECI
+// position (and velocity, unless made with kPropagatePositionOnly) so
+// repeated queries near the same time skip SGP4/SDP4. Segments are
+// fitted on first use; each fit is checked against the full model and
+// rejected unless it is within inToleranceKm. Queries in a rejected
+// segment, or one the model cannot propagate through, use the full model.
+// Note the full model is itself only smooth to a few meters (its Kepler
+// solve stops at 1.0e-06 radian), so tolerances below ~0.010 km mostly
+// measure that noise.
+// An Ephemeris is not thread-safe: queries update the cache.
+struct Ephemeris;
+typedef struct Ephemeris Ephemeris;
+
+typedef struct EphemerisStats
+{
+    unsigned long long  mHits;          // queries answered from a fitted segment
+    unsigned long long  mMisses;        // queries that fitted a new segment
+    unsigned long long  mDirect;        // queries answered by the full model
+    size_t              mSegments;      // segments in the cache
+    size_t              mBytes;         // approximate memory held by the cache
+    double              mMaxFitErrorKm; // largest fit error measured so far
+} EphemerisStats;
+
+DLL_EXPORT int Ephemeris_Make(const TLE* inTLE, double inSegmentMinutes, double inToleranceKm, int in_flags, Ephemeris** outEphemeris);
+DLL_EXPORT int Ephemeris_Delete(Ephemeris* ioEphemeris);
+DLL_EXPORT int Ephemeris_GetStats(const Ephemeris* inEphemeris, EphemerisStats* outStats);
+
+// Ephemeris_ToLLA:
+// Calculate satellite Lat/Lon/Alt for in_time. Fractional seconds are
+// kept, so a UI can poll many times per second.
+DLL_EXPORT int Ephemeris_ToLLA(	Ephemeris*  ioEphemeris,
+					double      in_time,		// time in seconds since 1970
+					double*     out_latdegs,	// latitude in degs
+					double*     out_londegs,	// longitude in degs
+					double*     out_altkm);		// altitude in km
+
+// Ephemeris_ToEci:
+// ECI position in km and, if out_velkms is not NULL, velocity in km/sec.
+// kInvalidParameter if out_velkms is given and the Ephemeris was made
+// with kPropagatePositionOnly.
+DLL_EXPORT int Ephemeris_ToEci(	Ephemeris*  ioEphemeris,
+					double      in_time,		// time in seconds since 1970
+					double      out_poskm[3],	// ECI position in km
+					double      out_velkms[3]);	// ECI velocity in km/sec, or NULL
+
 #ifdef __cplusplus
 } // extern "C"
 
@@ -86,6 +434,10 @@ public:
 	explicit exception(const char* what_arg) : std::runtime_error(what_arg) {}
 };
 
+class Catalog;
+class Ephemeris;
+class Site;
+
 class TLE
 {
 public:
@@ -124,11 +476,9 @@ public:
 	{
 		if (this != &inCopy)
 		{
-			int errCode = TLE_Make(inCopy.GetName().data(), inCopy.GetLine1().data(), inCopy.GetLine2().data(), &mTLE);
-			if (errCode != kOK)
-			{
-				throw exception("TLE_Make failed");
-			}
+			// The old handle goes with the temporary
+			TLE copy{inCopy};
+			std::swap(mTLE, copy.mTLE);
 		}
 		return *this;
 	}
@@ -145,8 +495,7 @@ public:
 	{
 		if (this != &ioMove)
 		{
-			mTLE = ioMove.mTLE;
-			ioMove.mTLE = nullptr;
+			std::swap(mTLE, ioMove.mTLE);
 		}
 		return *this;
 	}
@@ -206,11 +555,511 @@ public:
 		return inclination;
 	}
 
+	/// @brief Epoch in seconds since 1970, see TLE_GetEpoch()
+	double GetEpoch() const
+	{
+		double epoch = 0.0;
+		int errCode = TLE_GetEpoch(mTLE, &epoch);
+		if (errCode != kOK)
+		{
+			throw exception("GetEpoch failed");
+		}
+		return epoch;
+	}
+
+	OrbitModel GetModel() const
+	{
+		int model = kOrbitModelSgp4;
+		int errCode = TLE_GetModel(mTLE, &model);
+		if (errCode != kOK)
+		{
+			throw exception("GetModel failed");
+		}
+		return static_cast<OrbitModel>(model);
+	}
+
+	/// @brief RAAN and argument of latitude at inTime, see TLE_GetPlane()
+	struct Plane
+	{
+		double mRaanDegs{0.0};
+		double mArgLatDegs{0.0};
+	};
+
+	Plane GetPlane(long long inTime) const
+	{
+		Plane plane{};
+		int errCode = TLE_GetPlane(mTLE, inTime, &plane.mRaanDegs, &plane.mArgLatDegs);
+		if (errCode != kOK)
+		{
+			throw exception("GetPlane failed");
+		}
+		return plane;
+	}
+
 private:
+	friend class Catalog;
+	friend class Ephemeris;
+
 	// Tricky: :: refers to root namespace
 	::TLE* mTLE{nullptr};
 };
 
+class Site
+{
+public:
+	Site(double inLatDegs, double inLonDegs, double inAltKm)
+	{
+		int errCode = Site_Make(inLatDegs, inLonDegs, inAltKm, &mSite);
+		if (errCode != kOK)
+		{
+			throw exception("Site_Make failed");
+		}
+	}
+
+	~Site()
+	{
+		const int errCode = Site_Delete(mSite);
+		if (errCode != kOK)
+		{
+			// C++ exceptions should not be thrown from destructors
+			assert(!"Site_Delete failed");
+		}
+	}
+
+	Site(const Site& inCopy) = delete;
+	Site& operator=(const Site& inCopy) = delete;
+
+	// Site Move Ctor
+	Site(Site&& ioMove) noexcept
+	{
+		mSite = ioMove.mSite;
+		ioMove.mSite = nullptr;
+	}
+
+	// Site Move Assignment
+	Site& operator=(Site&& ioMove) noexcept
+	{
+		if (this != &ioMove)
+		{
+			std::swap(mSite, ioMove.mSite);
+		}
+		return *this;
+	}
+
+private:
+	friend class Catalog;
+
+	// Tricky: :: refers to root namespace
+	::Site* mSite{nullptr};
+};
+
+class Catalog
+{
+public:
+	/// @brief Satellites visible from a Site, see Catalog_LookAngles()
+	struct SkyView
+	{
+		std::vector<std::size_t> mIndex{};
+		std::vector<double> mAzDegs{};
+		std::vector<double> mEleDegs{};
+		std::vector<double> mRangeKm{};
+		std::vector<double> mRateKmSec{};
+	};
+
+	/// @brief Cartesian position and velocity, see Catalog_ToCartesian()
+	struct StateVectors
+	{
+		std::vector<double> mXKm{};
+		std::vector<double> mYKm{};
+		std::vector<double> mZKm{};
+		std::vector<double> mVxKmSec{};
+		std::vector<double> mVyKmSec{};
+		std::vector<double> mVzKmSec{};
+		std::vector<int> mStatus{};
+	};
+
+	/// @brief Per-satellite single precision error, see Catalog_GetFloatError()
+	struct FloatError
+	{
+		double mMaxKm{0.0};
+		double mRmsKm{0.0};
+		bool mUsesFloat{false};
+	};
+
+	/// @brief Quarantine counters, see Catalog_GetStats()
+	using Stats = CatalogStats;
+
+	/// @brief kPropagateJ2 error for one re-anchor interval, see Catalog_GetJ2Error()
+	struct J2Error
+	{
+		double mIntervalMin{0.0};
+		double mMaxKm{0.0};
+		double mRmsKm{0.0};
+	};
+
+	explicit Catalog(const std::vector<TLE>& inTLEs)
+	{
+		std::vector<const ::TLE*> tles{};
+		tles.reserve(inTLEs.size());
+		for (const auto& tle : inTLEs)
+		{
+			tles.push_back(tle.mTLE);
+		}
+
+		int errCode = Catalog_Make(tles.data(), tles.size(), &mCatalog);
+		if (errCode != kOK)
+		{
+			throw exception("Catalog_Make failed");
+		}
+	}
+
+	~Catalog()
+	{
+		const int errCode = Catalog_Delete(mCatalog);
+		if (errCode != kOK)
+		{
+			// C++ exceptions should not be thrown from destructors
+			assert(!"Catalog_Delete failed");
+		}
+	}
+
+	// A Catalog owns decoded models for every satellite; copying is not allowed
+	Catalog(const Catalog& inCopy) = delete;
+	Catalog& operator=(const Catalog& inCopy) = delete;
+
+	// Catalog Move Ctor
+	Catalog(Catalog&& ioMove) noexcept
+	{
+		mCatalog = ioMove.mCatalog;
+		ioMove.mCatalog = nullptr;
+	}
+
+	// Catalog Move Assignment
+	Catalog& operator=(Catalog&& ioMove) noexcept
+	{
+		if (this != &ioMove)
+		{
+			std::swap(mCatalog, ioMove.mCatalog);
+		}
+		return *this;
+	}
+
+	std::size_t GetCount() const
+	{
+		size_t count = 0;
+		int errCode = Catalog_GetCount(mCatalog, &count);
+		if (errCode != kOK)
+		{
+			throw exception("GetCount failed");
+		}
+		return count;
+	}
+
+	Stats GetStats() const
+	{
+		Stats stats{};
+		int errCode = Catalog_GetStats(mCatalog, &stats);
+		if (errCode != kOK)
+		{
+			throw exception("GetStats failed");
+		}
+		return stats;
+	}
+
+	void UpdateTLE(std::size_t inIndex, const TLE& inTLE)
+	{
+		int errCode = Catalog_UpdateTLE(mCatalog, inIndex, inTLE.mTLE);
+		if (errCode != kOK)
+		{
+			throw exception("UpdateTLE failed");
+		}
+	}
+
+	void SetFloatTolerance(double inToleranceKm)
+	{
+		int errCode = Catalog_SetFloatTolerance(mCatalog, inToleranceKm);
+		if (errCode != kOK)
+		{
+			throw exception("SetFloatTolerance failed");
+		}
+	}
+
+	FloatError GetFloatError(std::size_t inIndex) const
+	{
+		FloatError error{};
+		int usesFloat = 0;
+		int errCode = Catalog_GetFloatError(mCatalog, inIndex, &error.mMaxKm, &error.mRmsKm, &usesFloat);
+		if (errCode != kOK)
+		{
+			throw exception("GetFloatError failed");
+		}
+		error.mUsesFloat = (usesFloat != 0);
+		return error;
+	}
+
+	void SetJ2Interval(double inMinutes)
+	{
+		int errCode = Catalog_SetJ2Interval(mCatalog, inMinutes);
+		if (errCode != kOK)
+		{
+			throw exception("SetJ2Interval failed");
+		}
+	}
+
+	/// @brief Error-vs-horizon report; one entry per interval in inIntervalMin
+	std::vector<J2Error> GetJ2Error(long long inTime, const std::vector<double>& inIntervalMin) const
+	{
+		std::vector<double> maxKm(inIntervalMin.size());
+		std::vector<double> rmsKm(inIntervalMin.size());
+		int errCode = Catalog_GetJ2Error(mCatalog, inTime, inIntervalMin.data(), inIntervalMin.size(), maxKm.data(), rmsKm.data());
+		if (errCode != kOK)
+		{
+			throw exception("GetJ2Error failed");
+		}
+
+		std::vector<J2Error> report(inIntervalMin.size());
+		for (std::size_t n = 0; n < report.size(); ++n)
+		{
+			report[n] = J2Error{inIntervalMin[n], maxKm[n], rmsKm[n]};
+		}
+		return report;
+	}
+
+	/// @brief Propagates every satellite; output vectors are resized to GetCount()
+	void ToLLA(long long inTime, int inFlags, std::vector<double>& outLatDegs, std::vector<double>& outLonDegs, std::vector<double>& outAltKm, std::vector<int>& outStatus) const
+	{
+		const std::size_t count = GetCount();
+		outLatDegs.resize(count);
+		outLonDegs.resize(count);
+		outAltKm.resize(count);
+		outStatus.resize(count);
+
+		int errCode = Catalog_ToLLA(mCatalog, inTime, inFlags, outLatDegs.data(), outLonDegs.data(), outAltKm.data(), outStatus.data());
+		if (errCode != kOK)
+		{
+			throw exception("ToLLA failed");
+		}
+	}
+
+	/// @brief ToLLA() for a time with fractional seconds, see Catalog_ToLLAD()
+	void ToLLAD(double inTime, int inFlags, std::vector<double>& outLatDegs, std::vector<double>& outLonDegs, std::vector<double>& outAltKm, std::vector<int>& outStatus) const
+	{
+		const std::size_t count = GetCount();
+		outLatDegs.resize(count);
+		outLonDegs.resize(count);
+		outAltKm.resize(count);
+		outStatus.resize(count);
+
+		int errCode = Catalog_ToLLAD(mCatalog, inTime, inFlags, outLatDegs.data(), outLonDegs.data(), outAltKm.data(), outStatus.data());
+		if (errCode != kOK)
+		{
+			throw exception("ToLLAD failed");
+		}
+	}
+
+	/// @brief Propagates every satellite to each of inTimes; output vectors are resized to GetCount() * inTimes.size(),
+	/// one row of inTimes.size() elements per satellite, see Catalog_ToLLATimes()
+	void ToLLA(const std::vector<long long>& inTimes, int inFlags, std::vector<double>& outLatDegs, std::vector<double>& outLonDegs, std::vector<double>& outAltKm, std::vector<int>& outStatus) const
+	{
+		const std::size_t count = GetCount() * inTimes.size();
+		outLatDegs.resize(count);
+		outLonDegs.resize(count);
+		outAltKm.resize(count);
+		outStatus.resize(count);
+
+		int errCode = Catalog_ToLLATimes(mCatalog, inTimes.data(), inTimes.size(), inFlags, outLatDegs.data(), outLonDegs.data(), outAltKm.data(), outStatus.data());
+		if (errCode != kOK)
+		{
+			throw exception("ToLLATimes failed");
+		}
+	}
+
+	/// @brief ToLLA() of inTimes with fractional seconds, see Catalog_ToLLATimesD()
+	void ToLLAD(const std::vector<double>& inTimes, int inFlags, std::vector<double>& outLatDegs, std::vector<double>& outLonDegs, std::vector<double>& outAltKm, std::vector<int>& outStatus) const
+	{
+		const std::size_t count = GetCount() * inTimes.size();
+		outLatDegs.resize(count);
+		outLonDegs.resize(count);
+		outAltKm.resize(count);
+		outStatus.resize(count);
+
+		int errCode = Catalog_ToLLATimesD(mCatalog, inTimes.data(), inTimes.size(), inFlags, outLatDegs.data(), outLonDegs.data(), outAltKm.data(), outStatus.data());
+		if (errCode != kOK)
+		{
+			throw exception("ToLLATimesD failed");
+		}
+	}
+
+	/// @brief ECI or ECEF state of every satellite, see CartesianFrame
+	void ToCartesian(long long inTime, int inFlags, int inFrame, StateVectors& outState) const
+	{
+		Resize(outState);
+		int errCode = Catalog_ToCartesian(mCatalog, inTime, inFlags, inFrame,
+										  outState.mXKm.data(), outState.mYKm.data(), outState.mZKm.data(),
+										  outState.mVxKmSec.data(), outState.mVyKmSec.data(), outState.mVzKmSec.data(),
+										  outState.mStatus.data());
+		if (errCode != kOK)
+		{
+			throw exception("ToCartesian failed");
+		}
+	}
+
+	/// @brief ToCartesian() for a time with fractional seconds, see Catalog_ToCartesianD()
+	void ToCartesianD(double inTime, int inFlags, int inFrame, StateVectors& outState) const
+	{
+		Resize(outState);
+		int errCode = Catalog_ToCartesianD(mCatalog, inTime, inFlags, inFrame,
+										   outState.mXKm.data(), outState.mYKm.data(), outState.mZKm.data(),
+										   outState.mVxKmSec.data(), outState.mVyKmSec.data(), outState.mVzKmSec.data(),
+										   outState.mStatus.data());
+		if (errCode != kOK)
+		{
+			throw exception("ToCartesianD failed");
+		}
+	}
+
+	/// @brief Satellites at or above inMinEleDegs from inSite; outView holds only those
+	void LookAngles(const Site& inSite, long long inTime, int inFlags, double inMinEleDegs, SkyView& outView) const
+	{
+		const std::size_t count = GetCount();
+		outView.mIndex.resize(count);
+		outView.mAzDegs.resize(count);
+		outView.mEleDegs.resize(count);
+		outView.mRangeKm.resize(count);
+		outView.mRateKmSec.resize(count);
+
+		std::size_t visible = 0;
+		int errCode = Catalog_LookAngles(mCatalog, inSite.mSite, inTime, inFlags, inMinEleDegs, &visible,
+										 outView.mIndex.data(), outView.mAzDegs.data(), outView.mEleDegs.data(),
+										 outView.mRangeKm.data(), outView.mRateKmSec.data());
+		if (errCode != kOK)
+		{
+			throw exception("LookAngles failed");
+		}
+
+		outView.mIndex.resize(visible);
+		outView.mAzDegs.resize(visible);
+		outView.mEleDegs.resize(visible);
+		outView.mRangeKm.resize(visible);
+		outView.mRateKmSec.resize(visible);
+	}
+
+private:
+	void Resize(StateVectors& outState) const
+	{
+		const std::size_t count = GetCount();
+		outState.mXKm.resize(count);
+		outState.mYKm.resize(count);
+		outState.mZKm.resize(count);
+		outState.mVxKmSec.resize(count);
+		outState.mVyKmSec.resize(count);
+		outState.mVzKmSec.resize(count);
+		outState.mStatus.resize(count);
+	}
+
+	::Catalog* mCatalog{nullptr};
+};
+
+class Ephemeris
+{
+public:
+	explicit Ephemeris(const TLE& inTLE, double inSegmentMinutes = 10.0, double inToleranceKm = 0.010, int inFlags = kPropagatePositionOnly)
+	{
+		int errCode = Ephemeris_Make(inTLE.mTLE, inSegmentMinutes, inToleranceKm, inFlags, &mEphemeris);
+		if (errCode != kOK)
+		{
+			throw exception("Ephemeris_Make failed");
+		}
+	}
+
+	~Ephemeris()
+	{
+		const int errCode = Ephemeris_Delete(mEphemeris);
+		if (errCode != kOK)
+		{
+			// C++ exceptions should not be thrown from destructors
+			assert(!"Ephemeris_Delete failed");
+		}
+	}
+
+	// An Ephemeris owns its cache; copying is not allowed
+	Ephemeris(const Ephemeris& inCopy) = delete;
+	Ephemeris& operator=(const Ephemeris& inCopy) = delete;
+
+	// Ephemeris Move Ctor
+	Ephemeris(Ephemeris&& ioMove) noexcept
+	{
+		mEphemeris = ioMove.mEphemeris;
+		ioMove.mEphemeris = nullptr;
+	}
+
+	// Ephemeris Move Assignment
+	Ephemeris& operator=(Ephemeris&& ioMove) noexcept
+	{
+		if (this != &ioMove)
+		{
+			std::swap(mEphemeris, ioMove.mEphemeris);
+		}
+		return *this;
+	}
+
+	EphemerisStats GetStats() const
+	{
+		EphemerisStats stats{};
+		int errCode = Ephemeris_GetStats(mEphemeris, &stats);
+		if (errCode != kOK)
+		{
+			throw exception("GetStats failed");
+		}
+		return stats;
+	}
+
+	void ToLLA(double inTime, double& outLatDegs, double& outLonDegs, double& outAltKm)
+	{
+		int errCode = Ephemeris_ToLLA(mEphemeris, inTime, &outLatDegs, &outLonDegs, &outAltKm);
+		if (errCode != kOK)
+		{
+			throw exception("ToLLA failed");
+		}
+	}
+
+private:
+	// Tricky: :: refers to root namespace
+	::Ephemeris* mEphemeris{nullptr};
+};
+
+class Satellite
+{
+public:
+	/// @brief Heap-free: a std::vector<Satellite> is one contiguous allocation
+	Satellite(const char* inName, const char* inLine1, const char* inLine2)
+	{
+		int errCode = Satellite_Init(inName, inLine1, inLine2, &mSatellite);
+		if (errCode != kOK)
+		{
+			throw exception("Satellite_Init failed");
+		}
+	}
+
+	std::string_view GetName() const
+	{
+		return mSatellite.mName;
+	}
+
+	void ToLLA(long long inTime, int inFlags, double& outLatDegs, double& outLonDegs, double& outAltKm) const
+	{
+		int errCode = Satellite_ToLLA(&mSatellite, inTime, inFlags, &outLatDegs, &outLonDegs, &outAltKm);
+		if (errCode != kOK)
+		{
+			throw exception("ToLLA failed");
+		}
+	}
+
+private:
+	// Tricky: :: refers to root namespace
+	::Satellite mSatellite{};
+};
+
 } // namespace sat355
 
 #endif 
@@ -1,8 +1,67 @@
 #include <gtest/gtest.h>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
 #include <ctime>
+#include <fstream>
+#include <memory>
+#include <new>
+#include <string>
+#include <type_traits>
+#include <vector>
 
 #include "libsat355.h"
 
+// Count heap allocations made by the tests, array ones included. Every form allocates and frees through
+// these two, so the compiler never sees a delete paired with an allocation it does not match.
+static std::atomic<std::size_t> gAllocations{0};
+
+static void* CountedAlloc(std::size_t inSize)
+{
+    ++gAllocations;
+    if (void* ptr = std::malloc(inSize ? inSize : 1))
+    {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+static void CountedFree(void* inPtr) noexcept
+{
+    std::free(inPtr);
+}
+
+void* operator new(std::size_t inSize)
+{
+    return CountedAlloc(inSize);
+}
+
+void* operator new[](std::size_t inSize)
+{
+    return CountedAlloc(inSize);
+}
+
+void operator delete(void* inPtr) noexcept
+{
+    CountedFree(inPtr);
+}
+
+void operator delete[](void* inPtr) noexcept
+{
+    CountedFree(inPtr);
+}
+
+void operator delete(void* inPtr, std::size_t) noexcept
+{
+    CountedFree(inPtr);
+}
+
+void operator delete[](void* inPtr, std::size_t) noexcept
+{
+    CountedFree(inPtr);
+}
+
 TEST(libsat355, TLE)
 {
     const char* in_tle1 = "ISS(ZARYA)";
@@ -30,6 +89,19 @@ TEST(libsat355, TLE_GetInclination)
     ASSERT_EQ(tle.GetInclination(), 51.6432);
 }
 
+TEST(libsat355, TLE_GetEpoch)
+{
+    // 2023 day 320.50172660, and 2006 day 176.33215444
+    const sat355::TLE iss("ISS(ZARYA)",
+                          "1 25544U 98067A   23320.50172660  .00012336  00000+0  22877-3 0  9990",
+                          "2 25544  51.6432 294.0998 0000823 293.3188 166.8114 15.49366195425413");
+    EXPECT_NEAR(iss.GetEpoch(), 1700136149.178, 1.0e-3);
+    const sat355::TLE molniya("MOLNIYA 2-14",
+                              "1 08195U 75081A   06176.33215444  .00000099  00000-0  11873-3 0  8136",
+                              "2 08195  64.1586 279.0717 6877146 264.7651  20.2257  2.00491383225656");
+    EXPECT_NEAR(molniya.GetEpoch(), 1151222298.144, 1.0e-3);
+}
+
 TEST(libsat355, orbit_to_lla)
 {
     std::time_t epoch = 0; 
@@ -92,4 +164,865 @@ TEST(libsat355, orbit_to_lla)
     Lon: 34.16
     Alt: 421.31
     */
-}
\ No newline at end of file
+}
+namespace {
+
+// Read a 3-line TLE file, such as StarlinkTLE.txt
+std::vector<sat355::TLE> ReadTLEFile(const char* inPath)
+{
+    std::vector<sat355::TLE> tles{};
+    std::ifstream file(inPath);
+    std::string name{};
+    std::string line1{};
+    std::string line2{};
+    while (std::getline(file, name) && std::getline(file, line1) && std::getline(file, line2))
+    {
+        tles.emplace_back(name.c_str(), line1.c_str(), line2.c_str());
+    }
+    return tles;
+}
+
+// 2024-04-27 12:00:00 UTC: close to the epochs in StarlinkTLE.txt
+constexpr long long kStarlinkTime = 1714219200;
+
+// Compare a Catalog batch against orbit_to_lla, one satellite at a time.
+// The batch may differ by its shared lunar-solar terms (see Catalog_Make).
+void ExpectCatalogMatchesOrbitToLLA(const std::vector<sat355::TLE>& inTLEs, long long inTime,
+                                    double inLatLonTol = 1.0e-7, double inAltTol = 1.0e-6)
+{
+    sat355::Catalog catalog(inTLEs);
+    ASSERT_EQ(catalog.GetCount(), inTLEs.size());
+
+    std::vector<double> lat{};
+    std::vector<double> lon{};
+    std::vector<double> alt{};
+    std::vector<int> status{};
+    catalog.ToLLA(inTime, kPropagateDefault, lat, lon, alt, status);
+
+    // Position only must give exactly the same answers
+    std::vector<double> latP{};
+    std::vector<double> lonP{};
+    std::vector<double> altP{};
+    std::vector<int> statusP{};
+    catalog.ToLLA(inTime, kPropagatePositionOnly, latP, lonP, altP, statusP);
+    EXPECT_EQ(status, statusP);
+    EXPECT_EQ(lat, latP);
+    EXPECT_EQ(lon, lonP);
+    EXPECT_EQ(alt, altP);
+
+    // Lat/Lon/Alt never computes velocities, so a call into outputs of the right size touches no heap
+    const std::size_t before = gAllocations;
+    catalog.ToLLA(inTime, kPropagateDefault, latP, lonP, altP, statusP);
+    EXPECT_EQ(gAllocations - before, 0u);
+
+    for (std::size_t i = 0; i < inTLEs.size(); ++i)
+    {
+        double tleage = 0.0;
+        double expectLat = 0.0;
+        double expectLon = 0.0;
+        double expectAlt = 0.0;
+        const std::string name{inTLEs[i].GetName()};
+        const std::string line1{inTLEs[i].GetLine1()};
+        const std::string line2{inTLEs[i].GetLine2()};
+        int result = orbit_to_lla(inTime, name.c_str(), line1.c_str(), line2.c_str(),
+                                  &tleage, &expectLat, &expectLon, &expectAlt);
+        ASSERT_EQ(status[i], result) << name;
+
+        // Single satellite value type must agree too
+        Satellite satellite{};
+        ASSERT_EQ(Satellite_Init(name.c_str(), line1.c_str(), line2.c_str(), &satellite), kOK) << name;
+        double satLat = 0.0;
+        double satLon = 0.0;
+        double satAlt = 0.0;
+        int satResult = Satellite_ToLLA(&satellite, inTime, kPropagateDefault, &satLat, &satLon, &satAlt);
+        ASSERT_EQ(satResult, result) << name;
+
+        double posLat = 0.0;
+        double posLon = 0.0;
+        double posAlt = 0.0;
+        ASSERT_EQ(Satellite_ToLLA(&satellite, inTime, kPropagatePositionOnly, &posLat, &posLon, &posAlt), satResult) << name;
+        EXPECT_EQ(posLat, satLat) << name;
+        EXPECT_EQ(posLon, satLon) << name;
+        EXPECT_EQ(posAlt, satAlt) << name;
+
+        if (result == kOK)
+        {
+            // The closed-form geodetic conversion agrees with cGeo's
+            // iteration to a few millimeters (cGeo stops at 1.0e-07 radian)
+            EXPECT_NEAR(lat[i], expectLat, inLatLonTol) << name;
+            EXPECT_NEAR(lon[i], expectLon, inLatLonTol) << name;
+            EXPECT_NEAR(alt[i], expectAlt, inAltTol) << name;
+            EXPECT_NEAR(satLat, expectLat, 1.0e-7) << name;
+            EXPECT_NEAR(satLon, expectLon, 1.0e-7) << name;
+            EXPECT_NEAR(satAlt, expectAlt, 1.0e-6) << name;
+        }
+    }
+}
+
+} // namespace anonymous
+
+TEST(libsat355, Catalog_ToLLA)
+{
+    std::vector<sat355::TLE> tles = ReadTLEFile(LIBSAT355_TEST_DATA_DIR "/StarlinkTLE.txt");
+    ASSERT_FALSE(tles.empty());
+
+    // Double precision batch must agree with the one-at-a-time path
+    ExpectCatalogMatchesOrbitToLLA(tles, kStarlinkTime);
+}
+
+TEST(libsat355, Catalog_ToLLA_DeepSpace)
+{
+    // One or more of each SDP4 variant (none, 12 hour and 24 hour
+    // resonant), plus a low perigee SGP4 object
+    std::vector<sat355::TLE> tles = ReadTLEFile(LIBSAT355_TEST_DATA_DIR "/DeepSpaceTLE.txt");
+    ASSERT_FALSE(tles.empty());
+
+    // 2006-06-26 00:00:00 UTC, and ten days earlier. Lunar-solar terms
+    // taken at the start of a 10-minute slot move GEO by millimeters.
+    ExpectCatalogMatchesOrbitToLLA(tles, 1151280000, 1.0e-6, 1.0e-4);
+    ExpectCatalogMatchesOrbitToLLA(tles, 1151280000 - 10 * 86400, 1.0e-6, 1.0e-4);
+}
+
+TEST(libsat355, Catalog_ToLLATimes)
+{
+    std::vector<sat355::TLE> tles = ReadTLEFile(LIBSAT355_TEST_DATA_DIR "/StarlinkTLE.txt");
+    const std::vector<sat355::TLE> deep = ReadTLEFile(LIBSAT355_TEST_DATA_DIR "/DeepSpaceTLE.txt");
+    tles.insert(tles.end(), deep.begin(), deep.end());
+    const std::vector<long long> times{kStarlinkTime, kStarlinkTime - 3600, kStarlinkTime + 1, kStarlinkTime + 86400};
+
+    for (const int flags : {kPropagateDefault, kPropagatePositionOnly, kPropagateFloat, kPropagateJ2})
+    {
+        std::vector<double> lat{};
+        std::vector<double> lon{};
+        std::vector<double> alt{};
+        std::vector<int> status{};
+        sat355::Catalog(tles).ToLLA(times, flags, lat, lon, alt, status);
+        ASSERT_EQ(status.size(), tles.size() * times.size());
+
+        // Each column is what a call for that time gives, calling for each time in turn.
+        // A failure quarantines the satellite for later calls, so that gets its own Catalog.
+        const sat355::Catalog catalog(tles);
+        for (std::size_t n = 0; n < times.size(); ++n)
+        {
+            std::vector<double> expectLat{};
+            std::vector<double> expectLon{};
+            std::vector<double> expectAlt{};
+            std::vector<int> expectStatus{};
+            catalog.ToLLA(times[n], flags, expectLat, expectLon, expectAlt, expectStatus);
+            for (std::size_t i = 0; i < tles.size(); ++i)
+            {
+                const std::size_t element = i * times.size() + n;
+                ASSERT_EQ(status[element], expectStatus[i]) << flags << " " << n << " " << i;
+                EXPECT_NEAR(lat[element], expectLat[i], 1.0e-9) << flags << " " << n << " " << i;
+                EXPECT_NEAR(lon[element], expectLon[i], 1.0e-9) << flags << " " << n << " " << i;
+                EXPECT_NEAR(alt[element], expectAlt[i], 1.0e-9) << flags << " " << n << " " << i;
+            }
+        }
+    }
+}
+
+TEST(libsat355, TLE_GetPlane)
+{
+    // At the epoch, the TLE's own RAAN and argument of perigee plus mean anomaly
+    const sat355::TLE iss("ISS(ZARYA)", "1 25544U 98067A   23320.50172660  .00012336  00000+0  22877-3 0  9990",
+                          "2 25544  51.6432 294.0998 0000823 293.3188 166.8114 15.49366195425413");
+    const long long issEpoch = 1700136149; // 2023 day 320.50172660
+    const sat355::TLE::Plane atEpoch = iss.GetPlane(issEpoch);
+    EXPECT_NEAR(atEpoch.mRaanDegs, 294.0998, 1.0e-3);
+    EXPECT_NEAR(atEpoch.mArgLatDegs, 293.3188 + 166.8114 - 360.0, 0.02);
+
+    // A day later the node of a prograde orbit has regressed by ~5 degs
+    const sat355::TLE::Plane dayLater = iss.GetPlane(issEpoch + 86400);
+    EXPECT_NEAR(dayLater.mRaanDegs - atEpoch.mRaanDegs, -5.0, 0.2);
+
+    // Away from the epoch, within the short period terms of the node and of the
+    // position along the orbit of the full model. Drag is left out, which moves
+    // the few low, decaying satellites further along the orbit.
+    const std::vector<sat355::TLE> tles = ReadTLEFile(LIBSAT355_TEST_DATA_DIR "/StarlinkTLE.txt");
+    ASSERT_FALSE(tles.empty());
+    const sat355::Catalog catalog(tles);
+    sat355::Catalog::StateVectors eci{};
+    catalog.ToCartesian(kStarlinkTime, kPropagateDefault, kFrameECI, eci);
+
+    constexpr double kDegsPerRad = 180.0 / 3.14159265358979323846;
+    auto angleDiff = [](double inLHS, double inRHS) -> double
+    {
+        return std::abs(std::remainder(inLHS - inRHS, 360.0));
+    };
+    std::size_t alongTrackMisses = 0;
+    for (std::size_t i = 0; i < tles.size(); ++i)
+    {
+        if (eci.mStatus[i] != kOK)
+        {
+            continue;
+        }
+        const double r[3] = {eci.mXKm[i], eci.mYKm[i], eci.mZKm[i]};
+        const double v[3] = {eci.mVxKmSec[i], eci.mVyKmSec[i], eci.mVzKmSec[i]};
+        const double h[3] = {r[1] * v[2] - r[2] * v[1], r[2] * v[0] - r[0] * v[2], r[0] * v[1] - r[1] * v[0]};
+        const double raan = std::atan2(h[0], -h[1]);
+        const double hNorm = std::sqrt(h[0] * h[0] + h[1] * h[1] + h[2] * h[2]);
+        const double argLat = std::atan2(r[2] * hNorm / std::hypot(h[0], h[1]), r[0] * std::cos(raan) + r[1] * std::sin(raan));
+
+        const sat355::TLE::Plane plane = tles[i].GetPlane(kStarlinkTime);
+        EXPECT_LT(angleDiff(plane.mRaanDegs, raan * kDegsPerRad), 0.2) << i;
+        alongTrackMisses += (angleDiff(plane.mArgLatDegs, argLat * kDegsPerRad) >= 0.5);
+    }
+    EXPECT_LT(alongTrackMisses, tles.size() / 200);
+}
+
+TEST(libsat355, Catalog_FloatError)
+{
+    std::vector<sat355::TLE> tles = ReadTLEFile(LIBSAT355_TEST_DATA_DIR "/StarlinkTLE.txt");
+    ASSERT_FALSE(tles.empty());
+
+    sat355::Catalog catalog(tles);
+    catalog.SetFloatTolerance(0.010);
+
+    // Accuracy harness: float vs double over +/-3 days from each epoch
+    double maxKm = 0.0;
+    double sumSq = 0.0;
+    std::size_t floatCount = 0;
+    for (std::size_t i = 0; i < catalog.GetCount(); ++i)
+    {
+        sat355::Catalog::FloatError error = catalog.GetFloatError(i);
+        if (error.mUsesFloat)
+        {
+            maxKm = std::max(maxKm, error.mMaxKm);
+            sumSq += error.mRmsKm * error.mRmsKm;
+            ++floatCount;
+        }
+    }
+    const double rmsKm = (floatCount > 0) ? std::sqrt(sumSq / floatCount) : 0.0;
+    std::cout << "float objects: " << floatCount << " of " << catalog.GetCount() << std::endl;
+    std::cout << "float max error km: " << maxKm << std::endl;
+    std::cout << "float rms error km: " << rmsKm << std::endl;
+
+    EXPECT_GT(floatCount, 0u);
+    EXPECT_LE(maxKm, 0.010);
+
+    // Display grade results stay close to double for objects that use float
+    std::vector<double> latD{}, lonD{}, altD{};
+    std::vector<double> latF{}, lonF{}, altF{};
+    std::vector<int> statusD{}, statusF{};
+    catalog.ToLLA(kStarlinkTime, kPropagateDefault, latD, lonD, altD, statusD);
+    catalog.ToLLA(kStarlinkTime, kPropagateFloat, latF, lonF, altF, statusF);
+    for (std::size_t i = 0; i < catalog.GetCount(); ++i)
+    {
+        if (statusD[i] == kOK && statusF[i] == kOK)
+        {
+            EXPECT_NEAR(latF[i], latD[i], 1.0e-3);
+            EXPECT_NEAR(altF[i], altD[i], 0.05);
+        }
+    }
+
+    // A zero tolerance falls every object back to double
+    catalog.SetFloatTolerance(0.0);
+    catalog.ToLLA(kStarlinkTime, kPropagateFloat, latF, lonF, altF, statusF);
+    EXPECT_EQ(latF, latD);
+}
+
+TEST(libsat355, Satellite_NoHeap)
+{
+    static_assert(std::is_trivially_copyable<sat355::Satellite>::value, "Satellite must be trivially copyable");
+
+    const char* in_tle1 = "ISS(ZARYA)";
+    const char* in_tle2 = "1 25544U 98067A   23320.50172660  .00012336  00000+0  22877-3 0  9990";
+    const char* in_tle3 = "2 25544  51.6432 294.0998 0000823 293.3188 166.8114 15.49366195425413";
+    const long long time = 1700136000; // 2023-11-16 12:00:00 UTC
+
+    // Construct, copy and propagate without touching the heap
+    const std::size_t before = gAllocations;
+    sat355::Satellite satellite(in_tle1, in_tle2, in_tle3);
+    sat355::Satellite copy = satellite;
+    double lat = 0.0;
+    double lon = 0.0;
+    double alt = 0.0;
+    copy.ToLLA(time, kPropagatePositionOnly, lat, lon, alt);
+    EXPECT_EQ(gAllocations - before, 0u);
+
+    EXPECT_EQ(satellite.GetName(), in_tle1);
+    double tleage = 0.0;
+    double expectLat = 0.0;
+    double expectLon = 0.0;
+    double expectAlt = 0.0;
+    ASSERT_EQ(orbit_to_lla(time, in_tle1, in_tle2, in_tle3, &tleage, &expectLat, &expectLon, &expectAlt), kOK);
+    EXPECT_NEAR(lat, expectLat, 1.0e-6);
+    EXPECT_NEAR(lon, expectLon, 1.0e-6);
+    EXPECT_NEAR(alt, expectAlt, 1.0e-5);
+
+    // 30k satellites are one allocation
+    const std::size_t beforeVector = gAllocations;
+    std::vector<sat355::Satellite> satellites(30000, satellite);
+    EXPECT_EQ(gAllocations - beforeVector, 1u);
+
+    // Array allocations are counted as well
+    const std::size_t beforeArray = gAllocations;
+    std::unique_ptr<double[]> buffer{new double[16]};
+    EXPECT_EQ(gAllocations - beforeArray, 1u);
+}
+
+TEST(libsat355, Ephemeris_ToLLA)
+{
+    const std::vector<sat355::TLE> tles = ReadTLEFile(LIBSAT355_TEST_DATA_DIR "/DeepSpaceTLE.txt");
+    ASSERT_FALSE(tles.empty());
+
+    // ISS plus a deep space orbit, polled 4x per second for an hour
+    std::vector<sat355::TLE> polled{};
+    polled.emplace_back("ISS(ZARYA)",
+                        "1 25544U 98067A   23320.50172660  .00012336  00000+0  22877-3 0  9990",
+                        "2 25544  51.6432 294.0998 0000823 293.3188 166.8114 15.49366195425413");
+    polled.push_back(tles.front());
+    const long long starts[] = {1700136000, 1151280000};
+
+    for (std::size_t i = 0; i < polled.size(); ++i)
+    {
+        const std::string name{polled[i].GetName()};
+        const std::string line1{polled[i].GetLine1()};
+        const std::string line2{polled[i].GetLine2()};
+        Satellite satellite{};
+        ASSERT_EQ(Satellite_Init(name.c_str(), line1.c_str(), line2.c_str(), &satellite), kOK) << name;
+
+        const double toleranceKm = 0.010;
+        sat355::Ephemeris ephemeris(polled[i], 10.0, toleranceKm);
+        constexpr int kPolls = 4 * 3600;
+        for (int poll = 0; poll < kPolls; ++poll)
+        {
+            const double time = static_cast<double>(starts[i]) + poll * 0.25;
+            double lat = 0.0;
+            double lon = 0.0;
+            double alt = 0.0;
+            ephemeris.ToLLA(time, lat, lon, alt);
+
+            // Whole seconds can be checked against the full model. Its Kepler
+            // solve stops at 1.0e-06 radian, so it is only smooth to a few
+            // meters; the fit follows the smooth orbit.
+            if ((poll % 4) == 0)
+            {
+                double expectLat = 0.0;
+                double expectLon = 0.0;
+                double expectAlt = 0.0;
+                ASSERT_EQ(Satellite_ToLLA(&satellite, static_cast<long long>(time), kPropagateDefault, &expectLat, &expectLon, &expectAlt), kOK) << name;
+                EXPECT_NEAR(lat, expectLat, 2.0e-4) << name;
+                EXPECT_NEAR(lon, expectLon, 2.0e-4) << name;
+                EXPECT_NEAR(alt, expectAlt, 0.010) << name;
+            }
+        }
+
+        const EphemerisStats stats = ephemeris.GetStats();
+        std::cout << name << ": " << stats.mSegments << " segments, " << stats.mBytes << " bytes, hit rate "
+                  << 100.0 * stats.mHits / kPolls << "%, " << stats.mDirect << " direct, max fit error " << stats.mMaxFitErrorKm * 1000.0 << " m\n";
+        EXPECT_EQ(stats.mHits + stats.mMisses + stats.mDirect, static_cast<unsigned long long>(kPolls)) << name;
+        EXPECT_LE(stats.mMisses, stats.mSegments) << name;
+        EXPECT_GT(stats.mHits, static_cast<unsigned long long>(kPolls / 2)) << name;
+        EXPECT_LE(stats.mMaxFitErrorKm, toleranceKm) << name;
+    }
+}
+
+TEST(libsat355, Ephemeris_ToEci)
+{
+    TLE* tle = nullptr;
+    ASSERT_EQ(TLE_Make("ISS(ZARYA)",
+                       "1 25544U 98067A   23320.50172660  .00012336  00000+0  22877-3 0  9990",
+                       "2 25544  51.6432 294.0998 0000823 293.3188 166.8114 15.49366195425413", &tle), kOK);
+    const double time = 1700136000.25;
+    double pos[3]{};
+    double vel[3]{};
+
+    // A position-only ephemeris has no velocity to give
+    Ephemeris* positionOnly = nullptr;
+    ASSERT_EQ(Ephemeris_Make(tle, 10.0, 0.010, kPropagatePositionOnly, &positionOnly), kOK);
+    EXPECT_EQ(Ephemeris_ToEci(positionOnly, time, pos, vel), kInvalidParameter);
+    EXPECT_EQ(vel[0], 0.0);
+    EXPECT_EQ(Ephemeris_ToEci(positionOnly, time, pos, nullptr), kOK);
+    EXPECT_GT(pos[0] * pos[0] + pos[1] * pos[1] + pos[2] * pos[2], 6000.0 * 6000.0);
+    EXPECT_EQ(Ephemeris_Delete(positionOnly), kOK);
+
+    Ephemeris* full = nullptr;
+    ASSERT_EQ(Ephemeris_Make(tle, 10.0, 0.010, kPropagateDefault, &full), kOK);
+    EXPECT_EQ(Ephemeris_ToEci(full, time, pos, vel), kOK);
+    EXPECT_GT(vel[0] * vel[0] + vel[1] * vel[1] + vel[2] * vel[2], 7.0 * 7.0);
+    EXPECT_EQ(Ephemeris_Delete(full), kOK);
+
+    EXPECT_EQ(TLE_Delete(tle), kOK);
+}
+
+TEST(libsat355, Catalog_InvalidParameter)
+{
+    TLE* tle = nullptr;
+    ASSERT_EQ(TLE_Make("ISS(ZARYA)",
+                       "1 25544U 98067A   23320.50172660  .00012336  00000+0  22877-3 0  9990",
+                       "2 25544  51.6432 294.0998 0000823 293.3188 166.8114 15.49366195425413", &tle), kOK);
+    Catalog* catalog = nullptr;
+    ASSERT_EQ(Catalog_Make(&tle, 1, &catalog), kOK);
+    const long long time = 1700136000;
+
+    // Each bad argument is reported as such, and the good call next to it still works
+    EXPECT_EQ(Catalog_UpdateTLE(catalog, 1, tle), kInvalidParameter);
+    EXPECT_EQ(Catalog_UpdateTLE(catalog, 0, tle), kOK);
+
+    double maxKm = 0.0;
+    double rmsKm = 0.0;
+    int usesFloat = 0;
+    EXPECT_EQ(Catalog_GetFloatError(catalog, 1, &maxKm, &rmsKm, &usesFloat), kInvalidParameter);
+    EXPECT_EQ(Catalog_GetFloatError(catalog, 0, &maxKm, &rmsKm, &usesFloat), kOK);
+
+    EXPECT_EQ(Catalog_SetJ2Interval(catalog, 0.0), kInvalidParameter);
+    EXPECT_EQ(Catalog_SetJ2Interval(catalog, 1.0), kOK);
+
+    const double badIntervals[2]{1.0, -1.0};
+    double maxErrorKm[2]{};
+    double rmsErrorKm[2]{};
+    EXPECT_EQ(Catalog_GetJ2Error(catalog, time, badIntervals, 2, maxErrorKm, rmsErrorKm), kInvalidParameter);
+    EXPECT_EQ(Catalog_GetJ2Error(catalog, time, badIntervals, 1, maxErrorKm, rmsErrorKm), kOK);
+
+    double x = 0.0;
+    double y = 0.0;
+    double z = 0.0;
+    double vx = 0.0;
+    double vy = 0.0;
+    double vz = 0.0;
+    int status = kOK;
+    EXPECT_EQ(Catalog_ToCartesian(catalog, time, kPropagateDefault, 2, &x, &y, &z, &vx, &vy, &vz, &status), kInvalidParameter);
+    EXPECT_EQ(Catalog_ToCartesian(catalog, time, kPropagateDefault, kFrameECI, &x, &y, &z, &vx, nullptr, &vz, &status), kInvalidParameter);
+    EXPECT_EQ(Catalog_ToCartesianD(catalog, 0.5 + time, kPropagateDefault, kFrameECEF, &x, &y, &z, nullptr, &vy, nullptr, &status), kInvalidParameter);
+    EXPECT_EQ(Catalog_ToCartesianD(catalog, 0.5 + time, kPropagateDefault, kFrameECEF, &x, &y, &z, &vx, &vy, &vz, &status), kOK);
+    EXPECT_EQ(status, kOK);
+
+    EXPECT_EQ(Catalog_Delete(catalog), kOK);
+    EXPECT_EQ(TLE_Delete(tle), kOK);
+}
+
+TEST(libsat355, Catalog_LookAngles)
+{
+    const std::vector<sat355::TLE> tles = ReadTLEFile(LIBSAT355_TEST_DATA_DIR "/StarlinkTLE.txt");
+    ASSERT_FALSE(tles.empty());
+    const sat355::Catalog catalog(tles);
+
+    // Seattle
+    constexpr double kLat = 47.6;
+    constexpr double kLon = -122.3;
+    constexpr double kAlt = 0.05;
+    constexpr double kMinEle = 10.0;
+    const sat355::Site site(kLat, kLon, kAlt);
+
+    sat355::Catalog::SkyView view{};
+    catalog.LookAngles(site, kStarlinkTime, kPropagateDefault, kMinEle, view);
+
+    sat355::Catalog::SkyView viewP{};
+    catalog.LookAngles(site, kStarlinkTime, kPropagatePositionOnly, kMinEle, viewP);
+    EXPECT_EQ(view.mIndex, viewP.mIndex);
+    EXPECT_EQ(view.mAzDegs, viewP.mAzDegs);
+    EXPECT_EQ(view.mEleDegs, viewP.mEleDegs);
+
+    // Every satellite orbit_to_lla2 sees at or above kMinEle, in catalog order
+    std::vector<std::size_t> expectIndex{};
+    std::vector<double> expectAz{};
+    std::vector<double> expectEle{};
+    for (std::size_t i = 0; i < tles.size(); ++i)
+    {
+        double tleage = 0.0;
+        double lat = 0.0;
+        double lon = 0.0;
+        double alt = 0.0;
+        double az = 0.0;
+        double ele = 0.0;
+        const std::string name{tles[i].GetName()};
+        const std::string line1{tles[i].GetLine1()};
+        const std::string line2{tles[i].GetLine2()};
+        int result = orbit_to_lla2(kStarlinkTime, name.c_str(), line1.c_str(), line2.c_str(), kLat, kLon, kAlt,
+                                   &tleage, &lat, &lon, &alt, &az, &ele);
+        if (result == kOK && ele >= kMinEle)
+        {
+            expectIndex.push_back(i);
+            expectAz.push_back(az);
+            expectEle.push_back(ele);
+        }
+    }
+
+    ASSERT_FALSE(expectIndex.empty());
+    ASSERT_EQ(view.mIndex, expectIndex);
+    for (std::size_t n = 0; n < expectIndex.size(); ++n)
+    {
+        EXPECT_NEAR(view.mAzDegs[n], expectAz[n], 1.0e-7) << n;
+        EXPECT_NEAR(view.mEleDegs[n], expectEle[n], 1.0e-7) << n;
+        EXPECT_GT(view.mRangeKm[n], 0.0) << n;
+        EXPECT_EQ(viewP.mRateKmSec[n], 0.0) << n;
+    }
+}
+
+TEST(libsat355, Catalog_ToCartesian)
+{
+    const std::vector<sat355::TLE> tles = ReadTLEFile(LIBSAT355_TEST_DATA_DIR "/StarlinkTLE.txt");
+    ASSERT_FALSE(tles.empty());
+    const sat355::Catalog catalog(tles);
+
+    sat355::Catalog::StateVectors eci{};
+    sat355::Catalog::StateVectors ecef{};
+    catalog.ToCartesian(kStarlinkTime, kPropagateDefault, kFrameECI, eci);
+    catalog.ToCartesian(kStarlinkTime, kPropagateDefault, kFrameECEF, ecef);
+
+    std::vector<double> lat{};
+    std::vector<double> lon{};
+    std::vector<double> alt{};
+    std::vector<int> status{};
+    catalog.ToLLA(kStarlinkTime, kPropagateDefault, lat, lon, alt, status);
+    EXPECT_EQ(eci.mStatus, status);
+    EXPECT_EQ(ecef.mStatus, status);
+
+    // One second either side, to check the velocities
+    sat355::Catalog::StateVectors eciBefore{};
+    sat355::Catalog::StateVectors eciAfter{};
+    sat355::Catalog::StateVectors before{};
+    sat355::Catalog::StateVectors after{};
+    catalog.ToCartesian(kStarlinkTime - 1, kPropagatePositionOnly, kFrameECI, eciBefore);
+    catalog.ToCartesian(kStarlinkTime + 1, kPropagatePositionOnly, kFrameECI, eciAfter);
+    catalog.ToCartesian(kStarlinkTime - 1, kPropagatePositionOnly, kFrameECEF, before);
+    catalog.ToCartesian(kStarlinkTime + 1, kPropagatePositionOnly, kFrameECEF, after);
+
+    // WGS-72, as used by the library
+    constexpr double kPi = 3.14159265358979323846;
+    constexpr double kEarthKm = 6378.135;
+    constexpr double kFlattening = 1.0 / 298.26;
+    constexpr double kE2 = kFlattening * (2.0 - kFlattening);
+
+    for (std::size_t i = 0; i < tles.size(); ++i)
+    {
+        if (status[i] != kOK)
+        {
+            EXPECT_EQ(ecef.mXKm[i], 0.0) << i;
+            continue;
+        }
+
+        // The frames differ by a rotation about z only
+        EXPECT_DOUBLE_EQ(ecef.mZKm[i], eci.mZKm[i]) << i;
+        EXPECT_NEAR(std::hypot(ecef.mXKm[i], ecef.mYKm[i]), std::hypot(eci.mXKm[i], eci.mYKm[i]), 1.0e-9) << i;
+
+        // ECEF is the frame Lat/Lon/Alt are measured in
+        const double phi = lat[i] * kPi / 180.0;
+        const double lambda = lon[i] * kPi / 180.0;
+        const double n = kEarthKm / std::sqrt(1.0 - kE2 * std::sin(phi) * std::sin(phi));
+        EXPECT_NEAR(ecef.mXKm[i], (n + alt[i]) * std::cos(phi) * std::cos(lambda), 1.0e-6) << i;
+        EXPECT_NEAR(ecef.mYKm[i], (n + alt[i]) * std::cos(phi) * std::sin(lambda), 1.0e-6) << i;
+        EXPECT_NEAR(ecef.mZKm[i], (n * (1.0 - kE2) + alt[i]) * std::sin(phi), 1.0e-6) << i;
+
+        // ECEF velocity is relative to the rotating earth. SGP4's velocity
+        // is not exactly the derivative of its position, but it misses
+        // by the same amount in both frames; leaving out the earth's
+        // rotation would miss by ~0.5 km/sec.
+        const double eciMiss = std::hypot(eci.mVxKmSec[i] - 0.5 * (eciAfter.mXKm[i] - eciBefore.mXKm[i]),
+                                          eci.mVyKmSec[i] - 0.5 * (eciAfter.mYKm[i] - eciBefore.mYKm[i]),
+                                          eci.mVzKmSec[i] - 0.5 * (eciAfter.mZKm[i] - eciBefore.mZKm[i]));
+        const double ecefMiss = std::hypot(ecef.mVxKmSec[i] - 0.5 * (after.mXKm[i] - before.mXKm[i]),
+                                           ecef.mVyKmSec[i] - 0.5 * (after.mYKm[i] - before.mYKm[i]),
+                                           ecef.mVzKmSec[i] - 0.5 * (after.mZKm[i] - before.mZKm[i]));
+        EXPECT_NEAR(ecefMiss, eciMiss, 1.0e-5) << i;
+        EXPECT_EQ(before.mVxKmSec[i], 0.0) << i;
+    }
+}
+
+TEST(libsat355, Catalog_SharedLunarSolarEpoch)
+{
+    // GOES 9, a copy with the same epoch and another plane, and a copy
+    // three minutes later: all three share one slot of lunar-solar terms
+    const char* name = "GOES 9";
+    const char* line1 = "1 23581U 95025A   06176.40286616  .00000092  00000-0  10000-3 0  7064";
+    const char* line2 = "2 23581   1.6533  87.3372 0004434 110.7698 302.4713  1.00282565 40672";
+    const char* line2Plane = "2 23581   1.6533 187.3372 0004434 110.7698 302.4713  1.00282565 40672";
+    const char* line1Later = "1 23581U 95025A   06176.40486616  .00000092  00000-0  10000-3 0  7064";
+
+    std::vector<sat355::TLE> tles{};
+    tles.emplace_back(name, line1, line2);
+    tles.emplace_back(name, line1, line2Plane);
+    tles.emplace_back(name, line1Later, line2);
+
+    // 2006-06-26 00:00:00 UTC
+    constexpr long long kTime = 1151280000;
+    const sat355::Catalog catalog(tles);
+    std::vector<double> lat{};
+    std::vector<double> lon{};
+    std::vector<double> alt{};
+    std::vector<int> status{};
+    catalog.ToLLA(kTime, kPropagateDefault, lat, lon, alt, status);
+
+    for (std::size_t i = 0; i < tles.size(); ++i)
+    {
+        double tleage = 0.0;
+        double expectLat = 0.0;
+        double expectLon = 0.0;
+        double expectAlt = 0.0;
+        const std::string line1i{tles[i].GetLine1()};
+        const std::string line2i{tles[i].GetLine2()};
+        ASSERT_EQ(orbit_to_lla(kTime, name, line1i.c_str(), line2i.c_str(), &tleage, &expectLat, &expectLon, &expectAlt), kOK);
+        ASSERT_EQ(status[i], kOK);
+
+        // The same epoch gives the same terms; a nearby one moves the
+        // GEO position by millimeters
+        const double latLonTol = (i < 2) ? 1.0e-7 : 1.0e-6;
+        const double altTol = (i < 2) ? 1.0e-6 : 1.0e-4;
+        EXPECT_NEAR(lat[i], expectLat, latLonTol) << i;
+        EXPECT_NEAR(lon[i], expectLon, latLonTol) << i;
+        EXPECT_NEAR(alt[i], expectAlt, altTol) << i;
+    }
+
+    // An object's terms depend only on its own epoch: not on the order of
+    // the catalog, its other members, or a resubmitted identical TLE
+    const std::vector<sat355::TLE> reversed{tles.rbegin(), tles.rend()};
+    const std::vector<sat355::TLE> later{tles[2]};
+    sat355::Catalog reversedCatalog(reversed);
+    const sat355::Catalog laterCatalog(later);
+    reversedCatalog.UpdateTLE(0, tles[2]);
+    sat355::Catalog::StateVectors sv{};
+    sat355::Catalog::StateVectors reversedSv{};
+    sat355::Catalog::StateVectors laterSv{};
+    catalog.ToCartesian(kTime, kPropagateDefault, kFrameECI, sv);
+    reversedCatalog.ToCartesian(kTime, kPropagateDefault, kFrameECI, reversedSv);
+    laterCatalog.ToCartesian(kTime, kPropagateDefault, kFrameECI, laterSv);
+    for (std::size_t i = 0; i < tles.size(); ++i)
+    {
+        const std::size_t j = tles.size() - 1 - i;
+        EXPECT_EQ(sv.mXKm[i], reversedSv.mXKm[j]) << i;
+        EXPECT_EQ(sv.mYKm[i], reversedSv.mYKm[j]) << i;
+        EXPECT_EQ(sv.mZKm[i], reversedSv.mZKm[j]) << i;
+    }
+    EXPECT_EQ(sv.mXKm[2], laterSv.mXKm[0]);
+    EXPECT_EQ(sv.mYKm[2], laterSv.mYKm[0]);
+    EXPECT_EQ(sv.mZKm[2], laterSv.mZKm[0]);
+}
+
+TEST(libsat355, Catalog_J2)
+{
+    const std::vector<sat355::TLE> tles = ReadTLEFile(LIBSAT355_TEST_DATA_DIR "/StarlinkTLE.txt");
+    ASSERT_FALSE(tles.empty());
+    sat355::Catalog catalog(tles);
+    catalog.SetJ2Interval(2.0);
+
+    // Anchors are at whole multiples of 2 minutes since 1970
+    const long long anchor = kStarlinkTime - kStarlinkTime % 120;
+    for (const long long time : {anchor, anchor + 1, anchor + 37, anchor + 119, anchor + 120})
+    {
+        sat355::Catalog::StateVectors full{};
+        sat355::Catalog::StateVectors j2{};
+        catalog.ToCartesian(time, kPropagateDefault, kFrameECI, full);
+        catalog.ToCartesian(time, kPropagateJ2, kFrameECI, j2);
+        EXPECT_EQ(j2.mStatus, full.mStatus);
+
+        // Exact at the anchor; the end of one interval is the anchor of the next
+        const bool atAnchor = ((time - anchor) % 120 == 0);
+        for (std::size_t i = 0; i < tles.size(); ++i)
+        {
+            const double missKm = std::hypot(j2.mXKm[i] - full.mXKm[i], j2.mYKm[i] - full.mYKm[i], j2.mZKm[i] - full.mZKm[i]);
+            EXPECT_LT(missKm, atAnchor ? 1.0e-6 : 0.1) << time << " " << i;
+            const double missKmSec = std::hypot(j2.mVxKmSec[i] - full.mVxKmSec[i], j2.mVyKmSec[i] - full.mVyKmSec[i], j2.mVzKmSec[i] - full.mVzKmSec[i]);
+            EXPECT_LT(missKmSec, 0.01) << time << " " << i;
+        }
+    }
+
+    // Also for an interval that does not divide the minutes from Julian date 0 to 1970
+    catalog.SetJ2Interval(7.0);
+    const long long sevenMinAnchor = kStarlinkTime - kStarlinkTime % 420;
+    for (const long long time : {sevenMinAnchor, sevenMinAnchor + 420})
+    {
+        sat355::Catalog::StateVectors full{};
+        sat355::Catalog::StateVectors j2{};
+        catalog.ToCartesian(time, kPropagateDefault, kFrameECI, full);
+        catalog.ToCartesian(time, kPropagateJ2, kFrameECI, j2);
+        for (std::size_t i = 0; i < tles.size(); ++i)
+        {
+            const double missKm = std::hypot(j2.mXKm[i] - full.mXKm[i], j2.mYKm[i] - full.mYKm[i], j2.mZKm[i] - full.mZKm[i]);
+            EXPECT_LT(missKm, 1.0e-6) << time << " " << i;
+        }
+    }
+
+    // Error grows with the interval
+    const std::vector<sat355::Catalog::J2Error> report = catalog.GetJ2Error(kStarlinkTime, {0.5, 1.0, 2.0, 5.0});
+    ASSERT_EQ(report.size(), 4u);
+    EXPECT_LT(report[1].mMaxKm, 0.05);
+    for (std::size_t n = 1; n < report.size(); ++n)
+    {
+        EXPECT_LT(report[n - 1].mRmsKm, report[n].mRmsKm) << n;
+        EXPECT_LE(report[n].mRmsKm, report[n].mMaxKm) << n;
+    }
+}
+
+TEST(libsat355, Catalog_J2_SubSecond)
+{
+    const std::vector<sat355::TLE> tles = ReadTLEFile(LIBSAT355_TEST_DATA_DIR "/StarlinkTLE.txt");
+    ASSERT_FALSE(tles.empty());
+    sat355::Catalog catalog(tles);
+    catalog.SetJ2Interval(1.0);
+
+    // Whole seconds give what the long long entry points give
+    std::vector<double> lat{};
+    std::vector<double> lon{};
+    std::vector<double> alt{};
+    std::vector<int> status{};
+    std::vector<double> expectLat{};
+    std::vector<double> expectLon{};
+    std::vector<double> expectAlt{};
+    std::vector<int> expectStatus{};
+    catalog.ToLLA(kStarlinkTime, kPropagateJ2, expectLat, expectLon, expectAlt, expectStatus);
+    catalog.ToLLAD(static_cast<double>(kStarlinkTime), kPropagateJ2, lat, lon, alt, status);
+    EXPECT_EQ(status, expectStatus);
+    for (std::size_t i = 0; i < tles.size(); ++i)
+    {
+        EXPECT_NEAR(lat[i], expectLat[i], 1.0e-6) << i;
+        EXPECT_NEAR(lon[i], expectLon[i], 1.0e-6) << i;
+        EXPECT_NEAR(alt[i], expectAlt[i], 1.0e-6) << i;
+    }
+
+    // A 10 Hz tick: J2 follows the full model, and every step moves every satellite
+    sat355::Catalog::StateVectors previous{};
+    for (int tick = 0; tick <= 20; ++tick)
+    {
+        const double time = static_cast<double>(kStarlinkTime) + 0.1 * tick;
+        sat355::Catalog::StateVectors full{};
+        sat355::Catalog::StateVectors j2{};
+        catalog.ToCartesianD(time, kPropagateDefault, kFrameECI, full);
+        catalog.ToCartesianD(time, kPropagateJ2, kFrameECI, j2);
+        EXPECT_EQ(j2.mStatus, full.mStatus);
+
+        for (std::size_t i = 0; i < tles.size(); ++i)
+        {
+            const double missKm = std::hypot(j2.mXKm[i] - full.mXKm[i], j2.mYKm[i] - full.mYKm[i], j2.mZKm[i] - full.mZKm[i]);
+            EXPECT_LT(missKm, 0.05) << time << " " << i;
+            if (tick > 0)
+            {
+                // About 0.75 km per 0.1 s in LEO
+                const double stepKm = std::hypot(j2.mXKm[i] - previous.mXKm[i], j2.mYKm[i] - previous.mYKm[i], j2.mZKm[i] - previous.mZKm[i]);
+                const double speedKmSec = std::hypot(j2.mVxKmSec[i], j2.mVyKmSec[i], j2.mVzKmSec[i]);
+                EXPECT_NEAR(stepKm, 0.1 * speedKmSec, 0.01) << time << " " << i;
+            }
+        }
+        previous = j2;
+    }
+
+    // The times version agrees with one call per time
+    const std::vector<double> times{kStarlinkTime + 0.25, kStarlinkTime + 0.5};
+    catalog.ToLLAD(times, kPropagateJ2, lat, lon, alt, status);
+    catalog.ToLLAD(times[1], kPropagateJ2, expectLat, expectLon, expectAlt, expectStatus);
+    for (std::size_t i = 0; i < tles.size(); ++i)
+    {
+        EXPECT_EQ(status[i * 2 + 1], expectStatus[i]) << i;
+        EXPECT_EQ(lat[i * 2 + 1], expectLat[i]) << i;
+        EXPECT_EQ(lon[i * 2 + 1], expectLon[i]) << i;
+        EXPECT_EQ(alt[i * 2 + 1], expectAlt[i]) << i;
+    }
+}
+
+TEST(libsat355, Catalog_Quarantine)
+{
+    // The ISS, the same TLE with a huge drag term (decays within hours),
+    // and with a mean motion of 0 (no orbit at all)
+    const char* name = "ISS(ZARYA)";
+    const char* line1 = "1 25544U 98067A   23320.50172660  .00012336  00000+0  22877-3 0  9990";
+    const char* line1Drag = "1 25544U 98067A   23320.50172660  .00012336  00000+0  99999-0 0  9990";
+    const char* line2 = "2 25544  51.6432 294.0998 0000823 293.3188 166.8114 15.49366195425413";
+    const char* line2Zero = "2 25544  51.6432 294.0998 0000823 293.3188 166.8114 00.00000000425413";
+    constexpr long long kEpoch = 1700136149;    // 2023 day 320.50172660
+    const std::vector<sat355::TLE> tles{{name, line1, line2}, {name, line1Drag, line2}, {name, line1, line2Zero}};
+    sat355::Catalog catalog(tles);
+
+    // Bad elements are known before anything is propagated
+    EXPECT_EQ(catalog.GetStats().mQuarantined, 1u);
+    EXPECT_EQ(catalog.GetStats().mBadElements, 1u);
+
+    std::vector<double> lat{};
+    std::vector<double> lon{};
+    std::vector<double> alt{};
+    std::vector<int> status{};
+    catalog.ToLLA(kEpoch + 12 * 3600, kPropagateDefault, lat, lon, alt, status);
+    EXPECT_EQ(status, (std::vector<int>{kOK, kDecayed, kBadElements}));
+    EXPECT_EQ(alt[1], 0.0);
+
+    // The one-at-a-time paths give the same reason, without throwing out of the library
+    double tleage = 0.0;
+    double expectLat = 0.0;
+    double expectLon = 0.0;
+    double expectAlt = 0.0;
+    EXPECT_EQ(orbit_to_lla(kEpoch + 12 * 3600, name, line1Drag, line2, &tleage, &expectLat, &expectLon, &expectAlt), kDecayed);
+    Satellite satellite{};
+    ASSERT_EQ(Satellite_Init(name, line1Drag, line2, &satellite), kOK);
+    EXPECT_EQ(Satellite_ToLLA(&satellite, kEpoch + 12 * 3600, kPropagateDefault, &expectLat, &expectLon, &expectAlt), kDecayed);
+    EXPECT_EQ(Satellite_Init(name, line1, line2Zero, &satellite), kInvalidTLE);
+
+    sat355::Catalog::Stats stats = catalog.GetStats();
+    EXPECT_EQ(stats.mDecayed, 1u);
+    EXPECT_EQ(stats.mEccentricity, 0u);
+    EXPECT_EQ(stats.mBadElements, 1u);
+    EXPECT_EQ(stats.mSkipped, 1u);
+    EXPECT_EQ(stats.mQuarantined, 2u);
+
+    // Quarantined at any time, in every mode, even where the model would still work
+    catalog.ToLLA(kEpoch, kPropagatePositionOnly, lat, lon, alt, status);
+    EXPECT_EQ(status, (std::vector<int>{kOK, kDecayed, kBadElements}));
+    sat355::Catalog::StateVectors state{};
+    catalog.ToCartesian(kEpoch, kPropagateJ2, kFrameECI, state);
+    EXPECT_EQ(state.mStatus, (std::vector<int>{kOK, kDecayed, kBadElements}));
+    stats = catalog.GetStats();
+    EXPECT_EQ(stats.mDecayed, 1u);
+    EXPECT_GE(stats.mSkipped, 5u);
+
+    // A new TLE lifts the quarantine, also when it changes the model class
+    const sat355::TLE molniya("MOLNIYA 2-14",
+                              "1 08195U 75081A   06176.33215444  .00000099  00000-0  11873-3 0  8136",
+                              "2 08195  64.1586 279.0717 6877146 264.7651  20.2257  2.00491383225656");
+    catalog.UpdateTLE(1, tles[0]);
+    catalog.UpdateTLE(2, molniya);
+    catalog.UpdateTLE(0, molniya);
+    EXPECT_EQ(catalog.GetStats().mQuarantined, 0u);
+
+    catalog.ToLLA(kEpoch, kPropagateDefault, lat, lon, alt, status);
+    EXPECT_EQ(status, (std::vector<int>{kOK, kOK, kOK}));
+    ASSERT_EQ(orbit_to_lla(kEpoch, name, line1, line2, &tleage, &expectLat, &expectLon, &expectAlt), kOK);
+    EXPECT_NEAR(lat[1], expectLat, 1.0e-7);
+    EXPECT_NEAR(lon[1], expectLon, 1.0e-7);
+
+    // An updated deep space object matches one loaded with the catalog
+    const sat355::Catalog fresh(std::vector<sat355::TLE>{molniya});
+    std::vector<double> freshLat{};
+    std::vector<double> freshLon{};
+    std::vector<double> freshAlt{};
+    std::vector<int> freshStatus{};
+    fresh.ToLLA(kEpoch, kPropagateDefault, freshLat, freshLon, freshAlt, freshStatus);
+    for (std::size_t i : {0u, 2u})
+    {
+        EXPECT_EQ(lat[i], freshLat[0]) << i;
+        EXPECT_EQ(lon[i], freshLon[0]) << i;
+        EXPECT_EQ(alt[i], freshAlt[0]) << i;
+    }
+}
+
+TEST(libsat355, Catalog_J2_Quarantine)
+{
+    // The ISS, and the same TLE with a huge drag term (decays within hours)
+    const char* name = "ISS(ZARYA)";
+    const char* line1 = "1 25544U 98067A   23320.50172660  .00012336  00000+0  22877-3 0  9990";
+    const char* line1Drag = "1 25544U 98067A   23320.50172660  .00012336  00000+0  99999-0 0  9990";
+    const char* line2 = "2 25544  51.6432 294.0998 0000823 293.3188 166.8114 15.49366195425413";
+    constexpr long long kEpoch = 1700136149;    // 2023 day 320.50172660
+    const std::vector<sat355::TLE> tles{{name, line1, line2}, {name, line1Drag, line2}};
+    sat355::Catalog catalog(tles);
+
+    // The error report propagates past the decay, but only reports it
+    const std::vector<sat355::Catalog::J2Error> report = catalog.GetJ2Error(kEpoch + 12 * 3600, {1.0, 5.0});
+    EXPECT_GT(report[0].mMaxKm, 0.0);
+    sat355::Catalog::Stats stats = catalog.GetStats();
+    EXPECT_EQ(stats.mDecayed, 0u);
+    EXPECT_EQ(stats.mSkipped, 0u);
+    EXPECT_EQ(stats.mQuarantined, 0u);
+
+    // Anchoring does not quarantine either: the decayed satellite falls back to
+    // the full model at the time asked for, which is what quarantines it
+    sat355::Catalog::StateVectors state{};
+    catalog.ToCartesian(kEpoch + 12 * 3600, kPropagateJ2, kFrameECI, state);
+    EXPECT_EQ(state.mStatus, (std::vector<int>{kOK, kDecayed}));
+    stats = catalog.GetStats();
+    EXPECT_EQ(stats.mDecayed, 1u);
+    EXPECT_EQ(stats.mSkipped, 0u);
+    EXPECT_EQ(stats.mQuarantined, 1u);
+
+    // From then on it is skipped in J2 mode as in the others
+    catalog.ToCartesian(kEpoch, kPropagateJ2, kFrameECI, state);
+    EXPECT_EQ(state.mStatus, (std::vector<int>{kOK, kDecayed}));
+    EXPECT_EQ(catalog.GetStats().mSkipped, 1u);
+}
@@ -0,0 +1,88 @@
+// Tests of the orbitTools coordinate types themselves, below the libsat355 API.
+// The orbitTools headers rely on the "using namespace std" in stdafx.h, so
+// these live apart from test1.cpp.
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <type_traits>
+#include <vector>
+
+#include "stdafx.h"
+#include "coordTypes.h"
+
+using namespace Zeptomoby::OrbitTools;
+
+namespace
+{
+    // Best of several std::copy passes over inSource, in ns per element
+    template <typename T>
+    double CopyNsPerElement(const std::vector<T>& inSource)
+    {
+        std::vector<T> target(inSource);
+        double best = 1.0e30;
+        for (int pass = 0; pass < 20; ++pass)
+        {
+            const auto start = std::chrono::steady_clock::now();
+            std::copy(inSource.begin(), inSource.end(), target.begin());
+            const auto stop = std::chrono::steady_clock::now();
+            best = std::min(best, std::chrono::duration<double, std::nano>(stop - start).count());
+        }
+        EXPECT_EQ(target.size(), inSource.size());
+        return best / static_cast<double>(inSource.size());
+    }
+
+    template <typename Legacy, typename Plain>
+    void ReportCopy(const char* inName, const std::vector<Legacy>& inLegacy, const std::vector<Plain>& inPlain)
+    {
+        const double legacyNs = CopyNsPerElement(inLegacy);
+        const double plainNs = CopyNsPerElement(inPlain);
+        std::cout << inName << ": " << sizeof(Legacy) << " -> " << sizeof(Plain) << " bytes, "
+                  << legacyNs << " -> " << plainNs << " ns/elem\n";
+    }
+}
+
+TEST(libsat355, CoordTypes_Copy)
+{
+    static_assert(!std::is_trivially_copyable<cVector>::value, "cVector has a vtable");
+    static_assert(!std::is_trivially_copyable<cEciTime>::value, "cEciTime has a vtable");
+    static_assert(!std::is_trivially_copyable<cGeo>::value, "cGeo has a vtable");
+    static_assert(!std::is_trivially_copyable<cTopo>::value, "cTopo has a vtable");
+    EXPECT_LT(sizeof(Vec3), sizeof(cVector));
+    EXPECT_LT(sizeof(EciState), sizeof(cEciTime));
+    EXPECT_LT(sizeof(Geodetic), sizeof(cGeo));
+    EXPECT_LT(sizeof(Topocentric), sizeof(cTopo));
+
+    // The same 100k values in both representations; each plain value converts back exactly
+    constexpr std::size_t kCount = 100000;
+    std::vector<cVector> vectors;
+    std::vector<cEciTime> ecis;
+    std::vector<cGeo> geos;
+    std::vector<cTopo> topos;
+    std::vector<Vec3> vec3s;
+    std::vector<EciState> eciStates;
+    std::vector<Geodetic> geodetics;
+    std::vector<Topocentric> topocentrics;
+    for (std::size_t i = 0; i < kCount; ++i)
+    {
+        const double x = static_cast<double>(i);
+        vec3s.push_back(Vec3{x, x + 1.0, x + 2.0});
+        eciStates.push_back(EciState{vec3s.back(), Vec3{-x, 7.5, 0.25}, 2460000.5 + x / kCount});
+        geodetics.push_back(Geodetic{x / kCount, -x / kCount, 550.0 + x});
+        topocentrics.push_back(Topocentric{x / kCount, 0.5, 1000.0 + x, -x / kCount});
+        vectors.push_back(ToVector(vec3s.back()));
+        ecis.push_back(ToEciTime(eciStates.back()));
+        geos.push_back(ToGeo(geodetics.back()));
+        topos.push_back(ToTopo(topocentrics.back()));
+    }
+    EXPECT_EQ(ToVec3(vectors.back()).m_z, vec3s.back().m_z);
+    EXPECT_EQ(ToEciState(ecis.back()).m_Date, eciStates.back().m_Date);
+    EXPECT_EQ(ToGeodetic(geos.back()).m_Alt, geodetics.back().m_Alt);
+    EXPECT_EQ(ToTopocentric(topos.back()).m_RangeRate, topocentrics.back().m_RangeRate);
+
+    // Timings depend on the machine, so they are reported rather than checked
+    ReportCopy("cVector  -> Vec3       ", vectors, vec3s);
+    ReportCopy("cEciTime -> EciState   ", ecis, eciStates);
+    ReportCopy("cGeo     -> Geodetic   ", geos, geodetics);
+    ReportCopy("cTopo    -> Topocentric", topos, topocentrics);
+}